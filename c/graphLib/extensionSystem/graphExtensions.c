@@ -8,6 +8,7 @@ See the LICENSE.TXT file for licensing information.
 #include <string.h>
 
 #include "../lowLevelUtils/appconst.h"
+#include "../lowLevelUtils/apiutils.private.h"
 #include "../graph.private.h"
 
 #include "graphExtensions.private.h"
@@ -32,10 +33,20 @@ graphExtensionP _FindNearestOverload(graphP theGraph, graphExtensionP target, in
  * graphs.  It is used in lieu of identifying extensions by a string
  * name, which is noticeably expensive when a frequently called
  * overload function seeks the extension context for a graph.
+ *
+ * An ID is assigned the first time the extension is added to any graph,
+ * so extensions may be added to different graphs by different threads.
+ * The thread that changes the ID variable of the extension from zero to
+ * MODULEID_ASSIGNING with an atomic compare-and-swap is the only one that
+ * generates an ID for it, so no IDs go unused, and any other thread adding
+ * the extension at the same time waits until the ID is stored. Once
+ * assigned, an ID never changes.
  ********************************************************************/
 
 static int moduleIDGenerator = 0;
 
+#define MODULEID_ASSIGNING (-1)
+
 /********************************************************************
  The extension mechanism allows new modules to equip a graph with the
  data structures and functions needed to implement new algorithms
@@ -99,6 +110,8 @@ static int moduleIDGenerator = 0;
      a) If extra data must be maintained at the graph, vertex or edge
         levels, then fpEnsureVertexCapacity(), fpEnsureEdgeCapacity(),
         fpDeleteEdge(), and fpResetGraphStorage() must be overloaded.
+        Extra data at the edge level must also be moved by an overload
+        of fpCompactEdgeStorage().
 
      b) If any data must be persisted in the file format, then overloads
         of fpReadPostprocess() and fpWritePostprocess() are needed.
@@ -147,7 +160,10 @@ static int moduleIDGenerator = 0;
  @param pModuleID - address of the variable that contains the feature's
                  extension identifier.  If the variable is equal to zero,
                  it is assigned a positive number.  Thereafter, the variable
-                 value can be used to find and remove the extension from any graph
+                 value can be used to find and remove the extension from any graph.
+                 The variable must be initialized to zero and not otherwise
+                 changed by the caller, as a negative value is used to show
+                 that another thread is assigning the identifier.
  @param context - the data storage for the extension being added
                The context is owned by the extension and freed with freeContext()
  @param copyData - a function capable of copying the context data
@@ -176,6 +192,7 @@ int gp_AddExtension(graphP theGraph,
                     graphFunctionTableP functions)
 {
     graphExtensionP newExtension = NULL;
+    int moduleID = 0;
 
     if (theGraph == NULL || pModuleID == NULL ||
         context == NULL || copyData == NULL || freeContext == NULL ||
@@ -184,35 +201,47 @@ int gp_AddExtension(graphP theGraph,
         return NOTOK;
     }
 
-    if (*pModuleID < 0 || *pModuleID > MAXNUMSUPPORTEDEXTENSIONS)
+    moduleID = _gp_AtomicLoad(pModuleID);
+    if ((moduleID < 0 && moduleID != MODULEID_ASSIGNING) || moduleID > MAXNUMSUPPORTEDEXTENSIONS)
     {
         return NOTOK;
     }
 
-    // If the extension already exists, then don't redefine it.
-    if (gp_FindExtension(theGraph, *pModuleID, NULL) == TRUE)
+    // Assign a unique ID to the extension if it does not already have one,
+    // or wait for the thread that is assigning it to store it.
+    while (moduleID == 0 || moduleID == MODULEID_ASSIGNING)
     {
-        return NOTOK;
+        if (moduleID == 0 && _gp_AtomicCompareAndSwap(pModuleID, 0, MODULEID_ASSIGNING))
+        {
+            moduleID = _gp_AtomicIncrement(&moduleIDGenerator);
+
+            if (moduleID > MAXNUMSUPPORTEDEXTENSIONS)
+            {
+                _gp_AtomicStore(pModuleID, 0);
+                return NOTOK;
+            }
+            _gp_AtomicStore(pModuleID, moduleID);
+        }
+        else
+        {
+            moduleID = _gp_AtomicLoad(pModuleID);
+        }
     }
 
-    // Assign a unique ID to the extension if it does not already have one
-    if (*pModuleID == 0)
+    // If the extension already exists, then don't redefine it.
+    if (gp_FindExtension(theGraph, moduleID, NULL) == TRUE)
     {
-        if (moduleIDGenerator >= MAXNUMSUPPORTEDEXTENSIONS)
-        {
-            return NOTOK;
-        }
-        *pModuleID = ++moduleIDGenerator;
+        return NOTOK;
     }
 
     // Allocate the new extension
-    if ((newExtension = (graphExtensionP)malloc(sizeof(graphExtensionStruct))) == NULL)
+    if ((newExtension = (graphExtensionP)gp_MemAlloc(sizeof(graphExtensionStruct))) == NULL)
     {
         return NOTOK;
     }
 
     // Assign the data payload of the extension
-    newExtension->moduleID = *pModuleID;
+    newExtension->moduleID = moduleID;
     newExtension->context = context;
     newExtension->dupContext = dupContext;
     newExtension->copyData = copyData;
@@ -470,7 +499,7 @@ int gp_DupExtensions(graphP dstGraph, graphP srcGraph)
             return NOTOK;
         }
 
-        if ((newNext = (graphExtensionP)malloc(sizeof(graphExtensionStruct))) == NULL)
+        if ((newNext = (graphExtensionP)gp_MemAlloc(sizeof(graphExtensionStruct))) == NULL)
         {
             gp_FreeExtensions(dstGraph);
             return NOTOK;
@@ -580,5 +609,25 @@ void _FreeExtension(graphExtensionP extension)
     {
         extension->freeContext(extension->context);
     }
-    free(extension);
+    gp_MemFree(extension);
+}
+
+/********************************************************************
+ gp_AddExtensionMemoryUsage()
+
+ An extension's overload of fpGetMemoryUsage() calls this function,
+ after calling the base function, to report the number of bytes used
+ by its context in the detail record given to gp_GetMemoryUsage().
+ ********************************************************************/
+
+void gp_AddExtensionMemoryUsage(graphMemoryUsageP detail, int moduleID, size_t bytes)
+{
+    detail->extensions += bytes;
+
+    if (detail->numExtensions < GP_MEMORYUSAGE_MAXEXTENSIONS)
+    {
+        detail->extension[detail->numExtensions].moduleID = moduleID;
+        detail->extension[detail->numExtensions].bytes = bytes;
+        detail->numExtensions++;
+    }
 }
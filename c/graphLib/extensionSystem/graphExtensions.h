@@ -31,6 +31,8 @@ extern "C"
 
     int gp_RemoveExtension(graphP theGraph, int moduleID);
 
+    void gp_AddExtensionMemoryUsage(graphMemoryUsageP detail, int moduleID, size_t bytes);
+
 #ifdef __cplusplus
 }
 #endif
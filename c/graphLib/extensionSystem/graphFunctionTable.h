@@ -19,6 +19,9 @@ extern "C"
     typedef struct graphStruct graphStruct;
     typedef graphStruct *graphP;
 
+    typedef struct graphMemoryUsageStruct graphMemoryUsageStruct;
+    typedef graphMemoryUsageStruct *graphMemoryUsageP;
+
     struct graphFunctionTableStruct
     {
         // These function pointers allow extension modules to overload some of
@@ -44,11 +47,13 @@ extern "C"
         void (*fpResetGraphStorage)(graphP);
         int (*fpEnsureEdgeCapacity)(graphP, int);
         int (*fpSortVertices)(graphP);
+        void (*fpGetMemoryUsage)(graphP, graphMemoryUsageP);
 
         int (*fpReadPostprocess)(graphP, char *);
         int (*fpWritePostprocess)(graphP, char **);
 
         int (*fpDeleteEdge)(graphP, int);
+        int (*fpCompactEdgeStorage)(graphP, int *);
         void (*fpHideEdge)(graphP, int);
         void (*fpRestoreEdge)(graphP, int);
         int (*fpHideVertex)(graphP, int);
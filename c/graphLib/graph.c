@@ -48,7 +48,7 @@ int _RestoreVertex(graphP theGraph);
 
 void _InitIsolatorContext(graphP theGraph);
 void _ClearAllVisitedFlagsInGraph(graphP theGraph);
-void _ClearVertexVisitedFlags(graphP theGraph, int includeVirtualVertices);
+void _ClearVertexVisitedFlags(graphP theGraph);
 void _ClearEdgeVisitedFlags(graphP theGraph);
 int _ClearAllVisitedFlagsInBicomp(graphP theGraph, int BicompRoot);
 int _ClearAllVisitedFlagsInOtherBicomps(graphP theGraph, int BicompRoot);
@@ -79,11 +79,12 @@ void _InitFunctionTable(graphP theGraph);
  Private functions.
  ********************************************************************/
 
-void _InitVertices(graphP theGraph);
-void _InitEdges(graphP theGraph);
 
 void _ClearGraph(graphP theGraph);
 
+int _IndexCapacityOK(long long N, long long edgeCapacity);
+int _GetMaxSimpleGraphEdges(int N);
+
 typedef struct
 {
     int u;
@@ -97,15 +98,33 @@ typedef struct
     int c;
 } randomGraphFaceRec;
 
+// The random graph generators enable the edge index for their tests of
+// whether a randomly chosen edge already exists when the average degree
+// of the generated graph will exceed this value
+#define RANDOMGRAPH_EDGEINDEX_MINDEGREE 16
+
+// The random edges added by gp_CreateRandomGraphEx() beyond its planar
+// core are generated and added with gp_AddEdgesBulk() in batches of up to
+// this many edges
+#define RANDOMGRAPH_BATCH_SIZE 256
+
 int _AddRandomGraphEdgeCandidate(randomGraphEdgeRec *edgeList, int edgeListCapacity, int *pEdgeListCount, int u, int v);
 int _ProcessRandomGraphOptionalEdge(graphP theGraph, randomGraphEdgeRec *edgeList, int edgeListCapacity,
                                     int *pEdgeListCount, int addImmediately, int u, int v);
-void _ShuffleRandomGraphEdgeCandidates(randomGraphEdgeRec *edgeList, int edgeCount);
+void _ShuffleRandomGraphEdgeCandidates(randomGeneratorP theGenerator, randomGraphEdgeRec *edgeList, int edgeCount);
 
 void _AttachEdgeRecord(graphP theGraph, int v, int e, int link, int newEdge);
 void _DetachEdgeRecord(graphP theGraph, int e);
 void _RestoreEdgeRecord(graphP theGraph, int e);
 int _DeleteEdge(graphP theGraph, int e);
+int _CompactEdgeStorage(graphP theGraph, int *oldToNewMap);
+
+int _GetEdgeIndexSlot(graphP theGraph, int u, int v);
+int _GrowEdgeIndex(graphP theGraph);
+void _IndexEdgeRecord(graphP theGraph, int owner, int e);
+void _UnindexEdgeRecord(graphP theGraph, int e);
+int _FindIndexedEdge(graphP theGraph, int u, int v, unsigned direction);
+void _SetEdgeRecordOwner(graphP theGraph, int e, int owner);
 
 /* Private functions for which there are FUNCTION POINTERS */
 
@@ -116,6 +135,22 @@ void _InitEdgeRec(graphP theGraph, int e);
 int _EnsureVertexCapacity(graphP theGraph, int N);
 void _ResetGraphStorage(graphP theGraph);
 int _EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity);
+void _GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail);
+
+// Offsets of the arrays carved from the single block of graph storage
+typedef struct
+{
+    size_t V, DVI, PVI, extFace, IC, E;
+    size_t vertexVisitStamps, edgeVisitStamps;
+    size_t size;
+} graphStorageLayout;
+
+void _GetGraphStorageLayout(graphP theGraph, int edgeCapacity, graphStorageLayout *theLayout);
+int _AllocateGraphStorage(graphP theGraph, int edgeCapacity);
+int _ReallocateGraphStorage(graphP theGraph, int edgeCapacity);
+void _SetGraphStoragePointers(graphP theGraph, char *storage, graphStorageLayout *theLayout);
+void _FreeGraphStorage(graphP theGraph);
+void _InitGraphStorage(graphP theGraph);
 
 /********************************************************************
  gp_New()
@@ -125,10 +160,10 @@ int _EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity);
 
 graphP gp_New(void)
 {
-    graphP theGraph = (graphP)calloc(1, sizeof(graphStruct));
-    graphFunctionTableP functionTable = (graphFunctionTableP)calloc(1, sizeof(graphFunctionTableStruct));
-    graphPrivateDataP theGraphPrivateData = (graphPrivateDataP)calloc(1, sizeof(graphPrivateDataStruct));
-    graphExtensionP *extensionLookupTable = (graphExtensionP *)calloc(MAXNUMSUPPORTEDEXTENSIONS + 1, sizeof(graphExtensionP));
+    graphP theGraph = (graphP)gp_MemCalloc(1, sizeof(graphStruct));
+    graphFunctionTableP functionTable = (graphFunctionTableP)gp_MemCalloc(1, sizeof(graphFunctionTableStruct));
+    graphPrivateDataP theGraphPrivateData = (graphPrivateDataP)gp_MemCalloc(1, sizeof(graphPrivateDataStruct));
+    graphExtensionP *extensionLookupTable = (graphExtensionP *)gp_MemCalloc(MAXNUMSUPPORTEDEXTENSIONS + 1, sizeof(graphExtensionP));
 
     if (theGraph != NULL && functionTable != NULL &&
         theGraphPrivateData != NULL && extensionLookupTable != NULL)
@@ -145,22 +180,22 @@ graphP gp_New(void)
     {
         if (theGraph != NULL)
         {
-            free(theGraph);
+            gp_MemFree(theGraph);
             theGraph = NULL;
         }
         if (functionTable != NULL)
         {
-            free(functionTable);
+            gp_MemFree(functionTable);
             functionTable = NULL;
         }
         if (theGraphPrivateData != NULL)
         {
-            free(theGraphPrivateData);
+            gp_MemFree(theGraphPrivateData);
             theGraphPrivateData = NULL;
         }
         if (extensionLookupTable != NULL)
         {
-            free(extensionLookupTable);
+            gp_MemFree(extensionLookupTable);
             extensionLookupTable = NULL;
         }
     }
@@ -203,11 +238,13 @@ void _InitFunctionTable(graphP theGraph)
         theGraph->functions->fpResetGraphStorage = _ResetGraphStorage;
         theGraph->functions->fpEnsureEdgeCapacity = _EnsureEdgeCapacity;
         theGraph->functions->fpSortVertices = _SortVertices;
+        theGraph->functions->fpGetMemoryUsage = _GetMemoryUsage;
 
         theGraph->functions->fpReadPostprocess = _ReadPostprocess;
         theGraph->functions->fpWritePostprocess = _WritePostprocess;
 
         theGraph->functions->fpDeleteEdge = _DeleteEdge;
+        theGraph->functions->fpCompactEdgeStorage = _CompactEdgeStorage;
         theGraph->functions->fpHideEdge = _HideEdge;
         theGraph->functions->fpRestoreEdge = _RestoreEdge;
         theGraph->functions->fpHideVertex = _HideVertex;
@@ -254,6 +291,51 @@ void _InitFunctionTable(graphP theGraph)
           returned to the post-condition of gp_New().
  ********************************************************************/
 
+/********************************************************************
+ _IndexCapacityOK()
+ Returns TRUE if N vertices (and as many virtual vertices) and the
+ given edge capacity fit within the vertex and edge record locations
+ that GP_INDEX_T can represent (see GP_SMALL_INDEX), FALSE otherwise.
+
+ The depth-first search stack, which holds 2 integers per edge record
+ plus 2 (see _EnsureVertexCapacity()), must also have an int capacity,
+ so with the default int indices, the edge capacity is limited to
+ about INT_MAX/4 edges and N is limited to about INT_MAX/12 vertices.
+ The computation is done in long long so that a graph too large to
+ index is reported rather than allocated with an overflowed size.
+
+ The lower bounds of vertex and edge storage are constants that only
+ depend on the array base (see USE_0BASEDARRAYS), so no graph is needed.
+ ********************************************************************/
+
+int _IndexCapacityOK(long long N, long long edgeCapacity)
+{
+    long long stackEdgeCapacity = edgeCapacity > DEFAULT_EDGE_CAPACITY_FACTOR * N
+                                      ? edgeCapacity
+                                      : DEFAULT_EDGE_CAPACITY_FACTOR * N;
+
+    return gp_LowerBoundVertexStorage(NULL) + 2 * N <= GP_INDEX_MAX &&
+                   gp_LowerBoundEdgeStorage(NULL) + 2 * edgeCapacity <= GP_INDEX_MAX &&
+                   4 * stackEdgeCapacity + 2 <= INT_MAX
+               ? TRUE
+               : FALSE;
+}
+
+/********************************************************************
+ _GetMaxSimpleGraphEdges()
+ Returns the number of edges N(N-1)/2 in a simple undirected graph
+ on N vertices, or INT_MAX if that number does not fit in an int
+ (which happens once N exceeds 65536, so N*(N-1) is computed in
+ long long rather than int).
+ ********************************************************************/
+
+int _GetMaxSimpleGraphEdges(int N)
+{
+    long long maxEdges = N > 1 ? ((long long)N * (N - 1)) >> 1 : 0;
+
+    return maxEdges < INT_MAX ? (int)maxEdges : INT_MAX;
+}
+
 int gp_EnsureVertexCapacity(graphP theGraph, int N)
 {
     // valid params check
@@ -264,12 +346,16 @@ int gp_EnsureVertexCapacity(graphP theGraph, int N)
     if (gp_GetN(theGraph) > 0)
         return NOTOK;
 
+    // The vertex and edge record locations must be representable by GP_INDEX_T
+    if (!_IndexCapacityOK(N, theGraph->edgeCapacity > 0 ? theGraph->edgeCapacity : DEFAULT_EDGE_CAPACITY_FACTOR * (long long)N))
+        return NOTOK;
+
     return theGraph->functions->fpEnsureVertexCapacity(theGraph, N);
 }
 
 int _EnsureVertexCapacity(graphP theGraph, int N)
 {
-    int Vsize, VIsize, Esize, stackSize;
+    int VIsize, stackSize;
 
     // Compute the vertex and edge capacities of the graph
     theGraph->N = N;
@@ -278,27 +364,20 @@ int _EnsureVertexCapacity(graphP theGraph, int N)
     theGraph->numEdgeHoles = 0;
 
     VIsize = gp_UpperBoundVertices(theGraph);
-    Vsize = gp_UpperBoundVertexStorage(theGraph);
-    Esize = gp_UpperBoundEdgeStorage(theGraph);
 
     // Stack size is 2 integers per edge record plus 2 to start depth-first search at a tree root
     stackSize = (theGraph->edgeCapacity << 2) + 2;
     // In case of small edgeCapacity, ensure minimum based on number of vertices
     stackSize = stackSize <= 2 * 2 * DEFAULT_EDGE_CAPACITY_FACTOR * N ? 2 * 2 * DEFAULT_EDGE_CAPACITY_FACTOR * N + 2 : stackSize;
 
-    // Allocate memory as described above
-    if ((theGraph->V = (vertexRecP)calloc(Vsize, sizeof(vertexRec))) == NULL ||
-        (theGraph->E = (edgeRecP)calloc(Esize, sizeof(edgeRec))) == NULL ||
+    // Allocate memory as described above. The vertex and edge arrays
+    // all come from one block of graph storage.
+    if (_AllocateGraphStorage(theGraph, theGraph->edgeCapacity) != OK ||
         (theGraph->edgeHoles = sp_New(theGraph->edgeCapacity)) == NULL ||
 
         (theGraph->theStack = sp_New(stackSize)) == NULL ||
         (theGraphBicompRootLists(theGraph) = LCNew(VIsize)) == NULL ||
-        (theGraphDVI(theGraph) = (DFSUtils_VertexInfoP)calloc(VIsize, sizeof(DFSUtils_VertexInfo))) == NULL ||
-
-        (theGraphPVI(theGraph) = (Planarity_VertexInfoP)calloc(VIsize, sizeof(Planarity_VertexInfo))) == NULL ||
         (theGraphSortedDFSChildLists(theGraph) = LCNew(VIsize)) == NULL ||
-        (theGraphExtFace(theGraph) = (extFaceLinkRecP)calloc(Vsize, sizeof(extFaceLinkRec))) == NULL ||
-        (theGraphIC(theGraph) = (isolatorContextP)calloc(1, sizeof(isolatorContextStruct))) == NULL ||
         0)
     {
         _ClearGraph(theGraph);
@@ -306,42 +385,187 @@ int _EnsureVertexCapacity(graphP theGraph, int N)
     }
 
     // Initialize memory
-    _InitVertices(theGraph);
-    _InitEdges(theGraph);
+    _InitGraphStorage(theGraph);
     _InitIsolatorContext(theGraph);
 
     return OK;
 }
 
 /********************************************************************
- _InitVertices()
+ _GetGraphStorageLayout()
+ Computes where each of the arrays of a graph with the current N and
+ the given edgeCapacity is placed in the single block of graph storage.
+ The records initialized to NIL (V, DVI, PVI, extFace, IC and E) come
+ first, followed by the visited stamps, which are initialized to zero,
+ so that _InitGraphStorage() need only set two contiguous ranges.
+ Each array is aligned to the size of a pointer.
  ********************************************************************/
-void _InitVertices(graphP theGraph)
+
+#define _GRAPHSTORAGE_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+void _GetGraphStorageLayout(graphP theGraph, int edgeCapacity, graphStorageLayout *theLayout)
 {
-    memset(theGraph->V, NIL_CHAR, gp_UpperBoundVertexStorage(theGraph) * sizeof(vertexRec));
+    size_t Vsize = (size_t)gp_UpperBoundVertexStorage(theGraph);
+    size_t VIsize = (size_t)gp_UpperBoundVertices(theGraph);
+    size_t Esize = (size_t)gp_LowerBoundEdgeStorage(theGraph) + ((size_t)edgeCapacity << 1);
+    size_t size = 0;
 
-    memset(theGraphDVI(theGraph), NIL_CHAR, gp_UpperBoundVertices(theGraph) * sizeof(DFSUtils_VertexInfo));
+    theLayout->V = size;
+    size += _GRAPHSTORAGE_ALIGN(Vsize * sizeof(vertexRec));
+    theLayout->DVI = size;
+    size += _GRAPHSTORAGE_ALIGN(VIsize * sizeof(DFSUtils_VertexInfo));
+    theLayout->PVI = size;
+    size += _GRAPHSTORAGE_ALIGN(VIsize * sizeof(Planarity_VertexInfo));
+    theLayout->extFace = size;
+    size += _GRAPHSTORAGE_ALIGN(Vsize * sizeof(extFaceLinkRec));
+    theLayout->IC = size;
+    size += _GRAPHSTORAGE_ALIGN(sizeof(isolatorContextStruct));
+    theLayout->E = size;
+    size += _GRAPHSTORAGE_ALIGN(Esize * sizeof(edgeRec));
 
-    memset(theGraphPVI(theGraph), NIL_CHAR, gp_UpperBoundVertices(theGraph) * sizeof(Planarity_VertexInfo));
-    memset(theGraphExtFace(theGraph), NIL_CHAR, gp_UpperBoundVertexStorage(theGraph) * sizeof(extFaceLinkRec));
+    theLayout->vertexVisitStamps = size;
+    size += _GRAPHSTORAGE_ALIGN(Vsize * sizeof(GP_FLAGS_T));
+    theLayout->edgeVisitStamps = size;
+    size += _GRAPHSTORAGE_ALIGN(Esize * sizeof(GP_FLAGS_T));
 
-#ifdef USE_1BASEDARRAYS
-// For 1-based arrays, the memset() initializes the flags correctly
-#else
-    for (int v = gp_LowerBoundVertexStorage(theGraph); v < gp_UpperBoundVertexStorage(theGraph); ++v)
-        gp_InitFlags(theGraph, v);
-#endif
+    theLayout->size = size;
 }
 
 /********************************************************************
- _InitEdges()
+ _SetGraphStoragePointers()
+ Points the arrays of the graph at their places in the given storage.
  ********************************************************************/
-void _InitEdges(graphP theGraph)
+
+void _SetGraphStoragePointers(graphP theGraph, char *storage, graphStorageLayout *theLayout)
 {
-    memset(theGraph->E, NIL_CHAR, gp_UpperBoundEdgeStorage(theGraph) * sizeof(edgeRec));
+    theGraph->V = (vertexRecP)(storage + theLayout->V);
+    theGraphDVI(theGraph) = (DFSUtils_VertexInfoP)(storage + theLayout->DVI);
+    theGraphPVI(theGraph) = (Planarity_VertexInfoP)(storage + theLayout->PVI);
+    theGraphExtFace(theGraph) = (extFaceLinkRecP)(storage + theLayout->extFace);
+    theGraphIC(theGraph) = (isolatorContextP)(storage + theLayout->IC);
+    theGraph->E = (edgeRecP)(storage + theLayout->E);
+    theGraph->vertexVisitStamps = (GP_FLAGS_T *)(storage + theLayout->vertexVisitStamps);
+    theGraph->edgeVisitStamps = (GP_FLAGS_T *)(storage + theLayout->edgeVisitStamps);
+
+    theGraphStorage(theGraph) = storage;
+    theGraphStorageSize(theGraph) = theLayout->size;
+}
+
+/********************************************************************
+ _AllocateGraphStorage()
+ Allocates one block of storage for the vertex records, DFSUtils and
+ Planarity vertex infos, external face records, isolator context,
+ edge records and the visited stamps of a graph with the current N
+ and the given edgeCapacity, rather than allocating each separately.
+ The storage is not initialized; see _InitGraphStorage().
+
+ Returns OK on success, NOTOK on allocation failure.
+ ********************************************************************/
+
+int _AllocateGraphStorage(graphP theGraph, int edgeCapacity)
+{
+    graphStorageLayout theLayout;
+    char *storage = NULL;
+
+    _GetGraphStorageLayout(theGraph, edgeCapacity, &theLayout);
+
+    if ((storage = (char *)gp_MemAlloc(theLayout.size)) == NULL)
+        return NOTOK;
+
+    _SetGraphStoragePointers(theGraph, storage, &theLayout);
+
+    return OK;
+}
+
+/********************************************************************
+ _ReallocateGraphStorage()
+ Moves the graph arrays to a new block of storage with room for the
+ given (larger) edgeCapacity. The existing contents of each array are
+ copied, and the new edge records are initialized. The graph's
+ edgeCapacity member is not changed; the caller does that.
+
+ Returns OK on success, NOTOK on allocation failure, in which case the
+         graph storage is left unchanged.
+ ********************************************************************/
+
+int _ReallocateGraphStorage(graphP theGraph, int edgeCapacity)
+{
+    graphStorageLayout oldLayout, newLayout;
+    char *oldStorage = (char *)theGraphStorage(theGraph);
+    char *newStorage = NULL;
+    size_t oldEsize = (size_t)gp_UpperBoundEdgeStorage(theGraph);
+
+    _GetGraphStorageLayout(theGraph, theGraph->edgeCapacity, &oldLayout);
+    _GetGraphStorageLayout(theGraph, edgeCapacity, &newLayout);
+
+    if ((newStorage = (char *)gp_MemAlloc(newLayout.size)) == NULL)
+        return NOTOK;
+
+    // The arrays before E do not depend on the edge capacity
+    memcpy(newStorage, oldStorage, oldLayout.E);
+    memcpy(newStorage + newLayout.E, oldStorage + oldLayout.E, oldEsize * sizeof(edgeRec));
+    memcpy(newStorage + newLayout.vertexVisitStamps, oldStorage + oldLayout.vertexVisitStamps,
+           (size_t)gp_UpperBoundVertexStorage(theGraph) * sizeof(GP_FLAGS_T));
+    memcpy(newStorage + newLayout.edgeVisitStamps, oldStorage + oldLayout.edgeVisitStamps,
+           oldEsize * sizeof(GP_FLAGS_T));
+
+    _SetGraphStoragePointers(theGraph, newStorage, &newLayout);
+    gp_MemFree(oldStorage);
+
+    for (int e = (int)oldEsize; e < gp_LowerBoundEdgeStorage(theGraph) + (edgeCapacity << 1); ++e)
+        _InitEdgeRec(theGraph, e);
+
+    return OK;
+}
+
+/********************************************************************
+ _FreeGraphStorage()
+ Frees the single block of graph storage and clears the pointers to
+ the arrays that were carved from it.
+ ********************************************************************/
+
+void _FreeGraphStorage(graphP theGraph)
+{
+    if (theGraphStorage(theGraph) != NULL)
+    {
+        gp_MemFree(theGraphStorage(theGraph));
+        theGraphStorage(theGraph) = NULL;
+    }
+    theGraphStorageSize(theGraph) = 0;
+
+    theGraph->V = NULL;
+    theGraphDVI(theGraph) = NULL;
+    theGraphPVI(theGraph) = NULL;
+    theGraphExtFace(theGraph) = NULL;
+    theGraphIC(theGraph) = NULL;
+    theGraph->E = NULL;
+    theGraph->vertexVisitStamps = NULL;
+    theGraph->edgeVisitStamps = NULL;
+}
+
+/********************************************************************
+ _InitGraphStorage()
+ Initializes the vertex records, vertex infos, external face records,
+ isolator context and edge records to NIL and the visited stamps to
+ zero. Since the graph storage places each of these two groups in a
+ contiguous range, this takes one memset() per group.
+ ********************************************************************/
+
+void _InitGraphStorage(graphP theGraph)
+{
+    char *storage = (char *)theGraphStorage(theGraph);
+    size_t stampsOffset = (size_t)((char *)theGraph->vertexVisitStamps - storage);
+
+    memset(storage, NIL_CHAR, stampsOffset);
+    memset(storage + stampsOffset, 0, theGraphStorageSize(theGraph) - stampsOffset);
+    theGraph->vertexVisitEpoch = 1;
+    theGraph->edgeVisitEpoch = 1;
 
 #ifdef USE_1BASEDARRAYS
+// For 1-based arrays, the memset() initializes the flags correctly
 #else
+    for (int v = gp_LowerBoundVertexStorage(theGraph); v < gp_UpperBoundVertexStorage(theGraph); ++v)
+        gp_InitFlags(theGraph, v);
     for (int e = gp_LowerBoundEdgeStorage(theGraph); e < gp_UpperBoundEdgeStorage(theGraph); ++e)
         gp_InitEdgeFlags(theGraph, e);
 #endif
@@ -363,6 +587,8 @@ void gp_ResetGraphStorage(graphP theGraph)
 
 void _ResetGraphStorage(graphP theGraph)
 {
+    gp_DisableEdgeIndex(theGraph);
+
     theGraph->M = 0;
     theGraph->embedFlags = 0;
 
@@ -370,8 +596,8 @@ void _ResetGraphStorage(graphP theGraph)
     theGraph->graphFlags &= ~GRAPHFLAGS_SORTEDBYDFI;
     theGraph->graphFlags &= ~GRAPHFLAGS_LOWPOINTSCOMPUTED;
     theGraph->graphFlags &= ~GRAPHFLAGS_DIRECTEDEDGEDETECTED;
-    _InitVertices(theGraph);
-    _InitEdges(theGraph);
+    _ClearEdgeDependentGraphFlags(theGraph);
+    _InitGraphStorage(theGraph);
     _InitIsolatorContext(theGraph);
 
     LCReset(theGraphBicompRootLists(theGraph));
@@ -428,6 +654,9 @@ int gp_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
     if (theGraph->edgeCapacity >= requiredEdgeCapacity)
         return OK;
 
+    if (!_IndexCapacityOK(gp_GetN(theGraph), requiredEdgeCapacity))
+        return NOTOK;
+
     // In the special case where gp_EnsureVertexCapacity() has not yet
     // been called, we can simply set the higher edgeCapacity since normal
     // behavior of gp_EnsureVertexCapacity() will then allocate the
@@ -489,15 +718,11 @@ int _EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
     theGraph->edgeHoles = newStack;
     theGraph->numEdgeHoles = sp_GetCurrentSize(theGraph->edgeHoles);
 
-    // Reallocate the edgeRec array to the new size,
-    theGraph->E = (edgeRecP)realloc(theGraph->E, newEsize * sizeof(edgeRec));
-    if (theGraph->E == NULL)
+    // Move the graph storage to a block with room for the new edge records,
+    // which are initialized
+    if (_ReallocateGraphStorage(theGraph, requiredEdgeCapacity) != OK)
         return NOTOK;
 
-    // Initialize the new edge records
-    for (int e = gp_UpperBoundEdgeStorage(theGraph); e < newEsize; ++e)
-        _InitEdgeRec(theGraph, e);
-
     // The new edgeCapacity has been successfully allocated
     theGraph->edgeCapacity = requiredEdgeCapacity;
     return OK;
@@ -570,34 +795,41 @@ void _InitIsolatorContext(graphP theGraph)
 
 void _ClearAllVisitedFlagsInGraph(graphP theGraph)
 {
-    _ClearVertexVisitedFlags(theGraph, TRUE);
+    _ClearVertexVisitedFlags(theGraph);
     _ClearEdgeVisitedFlags(theGraph);
 }
 
 /********************************************************************
  _ClearVertexVisitedFlags()
- Clears the visited flags of vertices, and if the second parameter
- is truthy, also clears the visited flags of virtual vertices.
+ Clears the visited flags of all vertices and virtual vertices.
+
+ This is a constant time operation that advances the vertex visit
+ epoch, so that no stamp in vertexVisitStamps matches it. Only when
+ the epoch wraps around are the stamps actually reset.
  ********************************************************************/
 
-void _ClearVertexVisitedFlags(graphP theGraph, int includeVirtualVertices)
+void _ClearVertexVisitedFlags(graphP theGraph)
 {
-    for (int v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
-        gp_ClearVisited(theGraph, v);
-
-    if (includeVirtualVertices)
-        for (int vv = gp_LowerBoundVirtualVertices(theGraph); vv < gp_UpperBoundVirtualVertices(theGraph); ++vv)
-            gp_ClearVisited(theGraph, vv);
+    if (++theGraph->vertexVisitEpoch == 0)
+    {
+        memset(theGraph->vertexVisitStamps, 0, gp_UpperBoundVertexStorage(theGraph) * sizeof(GP_FLAGS_T));
+        theGraph->vertexVisitEpoch = 1;
+    }
 }
 
 /********************************************************************
  _ClearEdgeVisitedFlags()
+ Clears the visited flags of all edge records in constant time by
+ advancing the edge visit epoch (see _ClearVertexVisitedFlags()).
  ********************************************************************/
 
 void _ClearEdgeVisitedFlags(graphP theGraph)
 {
-    for (int e = gp_LowerBoundEdges(theGraph); e < gp_UpperBoundEdges(theGraph); ++e)
-        gp_ClearEdgeVisited(theGraph, e);
+    if (++theGraph->edgeVisitEpoch == 0)
+    {
+        memset(theGraph->edgeVisitStamps, 0, gp_UpperBoundEdgeStorage(theGraph) * sizeof(GP_FLAGS_T));
+        theGraph->edgeVisitEpoch = 1;
+    }
 }
 
 /********************************************************************
@@ -877,16 +1109,8 @@ int _ClearObstructionMarksInBicomp(graphP theGraph, int BicompRoot)
 
 void _ClearGraph(graphP theGraph)
 {
-    if (theGraph->V != NULL)
-    {
-        free(theGraph->V);
-        theGraph->V = NULL;
-    }
-    if (theGraph->E != NULL)
-    {
-        free(theGraph->E);
-        theGraph->E = NULL;
-    }
+    _FreeGraphStorage(theGraph);
+    gp_DisableEdgeIndex(theGraph);
 
     theGraph->N = 0;
     theGraph->NV = 0;
@@ -899,28 +1123,7 @@ void _ClearGraph(graphP theGraph)
 
     sp_Free(&theGraph->theStack);
     LCFree(&theGraphBicompRootLists(theGraph));
-    if (theGraphDVI(theGraph) != NULL)
-    {
-        free(theGraphDVI(theGraph));
-        theGraphDVI(theGraph) = NULL;
-    }
-
-    if (theGraphPVI(theGraph) != NULL)
-    {
-        free(theGraphPVI(theGraph));
-        theGraphPVI(theGraph) = NULL;
-    }
     LCFree(&theGraphSortedDFSChildLists(theGraph));
-    if (theGraphExtFace(theGraph) != NULL)
-    {
-        free(theGraphExtFace(theGraph));
-        theGraphExtFace(theGraph) = NULL;
-    }
-    if (theGraphIC(theGraph) != NULL)
-    {
-        free(theGraphIC(theGraph));
-        theGraphIC(theGraph) = NULL;
-    }
 
     gp_FreeExtensions(theGraph);
 
@@ -935,6 +1138,7 @@ void _ClearGraph(graphP theGraph)
         gp_Detach_DFSUtils(theGraph);
 
     theGraph->graphFlags = 0;
+    theGraphEdgeDependentGraphFlags(theGraph) = 0;
 }
 
 /********************************************************************
@@ -954,25 +1158,81 @@ void gp_Free(graphP *pGraph)
 
     if ((*pGraph)->functions != NULL)
     {
-        free((*pGraph)->functions);
+        gp_MemFree((*pGraph)->functions);
         (*pGraph)->functions = NULL;
     }
 
     if ((*pGraph)->privateData != NULL)
     {
-        free((*pGraph)->privateData);
+        gp_MemFree((*pGraph)->privateData);
         (*pGraph)->privateData = NULL;
     }
     if ((*pGraph)->extensionLookupTable != NULL)
     {
-        free((*pGraph)->extensionLookupTable);
+        gp_MemFree((*pGraph)->extensionLookupTable);
         (*pGraph)->extensionLookupTable = NULL;
     }
 
-    free(*pGraph);
+    gp_MemFree(*pGraph);
     *pGraph = NULL;
 }
 
+/********************************************************************
+ gp_GetMemoryUsage()
+ Returns the number of bytes of memory allocated for theGraph. If
+ detail is not NULL, then it receives a breakdown of that total by
+ the parts of the graph (see graphMemoryUsageStruct in graph.h).
+
+ Graph extensions report their contexts by overloading the function
+ fpGetMemoryUsage() and calling gp_AddExtensionMemoryUsage().
+ ********************************************************************/
+
+size_t gp_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail)
+{
+    graphMemoryUsageStruct theUsage;
+
+    if (detail == NULL)
+        detail = &theUsage;
+
+    memset(detail, 0, sizeof(graphMemoryUsageStruct));
+
+    if (theGraph == NULL)
+        return 0;
+
+    theGraph->functions->fpGetMemoryUsage(theGraph, detail);
+
+    return detail->graph + detail->base + detail->DFSUtils + detail->planarity + detail->extensions;
+}
+
+void _GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail)
+{
+    graphStorageLayout theLayout;
+
+    detail->graph = sizeof(graphStruct) + sizeof(graphFunctionTableStruct) +
+                    sizeof(graphPrivateDataStruct) +
+                    (MAXNUMSUPPORTEDEXTENSIONS + 1) * sizeof(graphExtensionP);
+
+    for (graphExtensionP curr = theGraph->extensions; curr != NULL; curr = curr->next)
+        detail->graph += sizeof(graphExtensionStruct);
+
+    detail->base = sp_GetMemoryUsage(theGraph->edgeHoles) + sp_GetMemoryUsage(theGraph->theStack);
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        detail->base += ((size_t)gp_UpperBoundVertexStorage(theGraph) + theGraphEdgeIndexSize(theGraph)) * sizeof(GP_INDEX_T);
+    detail->DFSUtils = LCGetMemoryUsage(theGraphBicompRootLists(theGraph));
+    detail->planarity = LCGetMemoryUsage(theGraphSortedDFSChildLists(theGraph));
+
+    // The parts of the single block of graph storage are attributed to the
+    // base graph, DFSUtils and Planarity (see _GetGraphStorageLayout())
+    if (theGraphStorage(theGraph) != NULL)
+    {
+        _GetGraphStorageLayout(theGraph, theGraph->edgeCapacity, &theLayout);
+
+        detail->DFSUtils += theLayout.PVI - theLayout.DVI;
+        detail->planarity += theLayout.E - theLayout.PVI;
+        detail->base += theGraphStorageSize(theGraph) - (theLayout.E - theLayout.DVI);
+    }
+}
+
 /********************************************************************
  gp_CopyAdjacencyLists()
  Copies the adjacency lists from the srcGraph to the dstGraph.
@@ -998,6 +1258,9 @@ int gp_CopyAdjacencyLists(graphP dstGraph, graphP srcGraph)
     if (gp_EnsureEdgeCapacity(dstGraph, srcGraph->edgeCapacity) != OK)
         return NOTOK;
 
+    // The edge index of the dstGraph, if any, does not survive the copy
+    gp_DisableEdgeIndex(dstGraph);
+
     // Copy the links that hook each owning vertex to its adjacency list
     for (v = gp_LowerBoundVertices(srcGraph); v < gp_UpperBoundVertices(srcGraph); ++v)
     {
@@ -1022,6 +1285,7 @@ int gp_CopyAdjacencyLists(graphP dstGraph, graphP srcGraph)
     dstGraph->graphFlags &= ~GRAPHFLAGS_SORTEDBYDFI;
     dstGraph->graphFlags &= ~GRAPHFLAGS_LOWPOINTSCOMPUTED;
     dstGraph->graphFlags &= ~GRAPHFLAGS_DIRECTEDEDGEDETECTED;
+    _ClearEdgeDependentGraphFlags(dstGraph);
     if (gp_GetGraphFlags(srcGraph) & GRAPHFLAGS_DIRECTEDEDGEDETECTED)
         dstGraph->graphFlags |= GRAPHFLAGS_DIRECTEDEDGEDETECTED;
 
@@ -1073,6 +1337,9 @@ int gp_CopyGraph(graphP dstGraph, graphP srcGraph)
         return NOTOK;
     }
 
+    // The edge index of the dstGraph, if any, does not survive the copy
+    gp_DisableEdgeIndex(dstGraph);
+
     // Copy the vertices (non-virtual only).  Augmentations to vertices created
     // by extensions are copied below by gp_CopyExtensions()
     for (v = gp_LowerBoundVertices(srcGraph); v < gp_UpperBoundVertices(srcGraph); ++v)
@@ -1100,13 +1367,24 @@ int gp_CopyGraph(graphP dstGraph, graphP srcGraph)
     for (e = gp_LowerBoundEdgeStorage(srcGraph); e < gp_UpperBoundEdgeStorage(srcGraph); e++)
         _gp_CopyEdgeRec(dstGraph, e, srcGraph, e);
 
+    // Copy the visited stamps and epochs, which are kept apart from the
+    // vertex and edge records
+    memcpy(dstGraph->vertexVisitStamps, srcGraph->vertexVisitStamps, gp_UpperBoundVertexStorage(srcGraph) * sizeof(GP_FLAGS_T));
+    memcpy(dstGraph->edgeVisitStamps, srcGraph->edgeVisitStamps, gp_UpperBoundEdgeStorage(srcGraph) * sizeof(GP_FLAGS_T));
+    dstGraph->vertexVisitEpoch = srcGraph->vertexVisitEpoch;
+    dstGraph->edgeVisitEpoch = srcGraph->edgeVisitEpoch;
+
     // If the dstGraph has more edge storage than the srcGraph, then we clear the extra
-    // base edgeRec structures. In gp_CopyExtensions(), the various extensions' copyData()
-    // functions are expected to clear out any extension-specific extra edgeRec structures
+    // base edgeRec structures and their visited stamps, since a stamp left from the
+    // dstGraph could match the epoch copied from the srcGraph. In gp_CopyExtensions(),
+    // the various extensions' copyData() functions are expected to clear out any
+    // extension-specific extra edgeRec structures
     if (gp_UpperBoundEdgeStorage(dstGraph) > gp_UpperBoundEdgeStorage(srcGraph))
     {
         for (e = gp_UpperBoundEdgeStorage(srcGraph); e < gp_UpperBoundEdgeStorage(dstGraph); e++)
             _InitEdgeRec(dstGraph, e);
+        memset(dstGraph->edgeVisitStamps + gp_UpperBoundEdgeStorage(srcGraph), 0,
+               (size_t)(gp_UpperBoundEdgeStorage(dstGraph) - gp_UpperBoundEdgeStorage(srcGraph)) * sizeof(GP_FLAGS_T));
     }
 
     // Give the dstGraph the same size and intrinsic properties
@@ -1116,6 +1394,7 @@ int gp_CopyGraph(graphP dstGraph, graphP srcGraph)
     dstGraph->embedFlags = gp_GetEmbedFlags(srcGraph);
 
     dstGraph->graphFlags = gp_GetGraphFlags(srcGraph);
+    theGraphEdgeDependentGraphFlags(dstGraph) = theGraphEdgeDependentGraphFlags(srcGraph);
 
     LCCopy(theGraphBicompRootLists(dstGraph), theGraphBicompRootLists(srcGraph));
     LCCopy(theGraphSortedDFSChildLists(dstGraph), theGraphSortedDFSChildLists(srcGraph));
@@ -1137,6 +1416,88 @@ int gp_CopyGraph(graphP dstGraph, graphP srcGraph)
     return OK;
 }
 
+/********************************************************************
+ gp_CopyGraphInUse()
+
+ Copies the content of the srcGraph into the dstGraph, like
+ gp_CopyGraph(), but only copies the edge records in use, i.e. those
+ below gp_UpperBoundEdges(), rather than all of the edge storage.
+ The edge records that the dstGraph was using beyond those of the
+ srcGraph are reinitialized. The vertex-level arrays are copied with
+ memcpy() rather than one record at a time.
+
+ This is intended for the loops that copy each newly read or generated
+ graph before embedding the copy, in which the dstGraph is always a
+ graph whose edge records beyond gp_UpperBoundEdges() are untouched,
+ e.g. a graph that has only been used for such copies and embeddings.
+
+ Returns OK for success, NOTOK for failure.
+ ********************************************************************/
+
+int gp_CopyGraphInUse(graphP dstGraph, graphP srcGraph)
+{
+    int srcUpperBoundEdges, dstUpperBoundEdges;
+
+    // Parameter checks
+    if (dstGraph == NULL || srcGraph == NULL)
+        return NOTOK;
+
+    // The graphs need to be the same order and initialized
+    if (gp_GetN(dstGraph) != gp_GetN(srcGraph) || gp_GetN(dstGraph) == 0)
+        return NOTOK;
+
+    if (gp_EnsureEdgeCapacity(dstGraph, srcGraph->edgeCapacity) != OK)
+        return NOTOK;
+
+    // The edge index of the dstGraph, if any, does not survive the copy
+    gp_DisableEdgeIndex(dstGraph);
+
+    srcUpperBoundEdges = gp_UpperBoundEdges(srcGraph);
+    dstUpperBoundEdges = gp_UpperBoundEdges(dstGraph);
+
+    // Copy the vertex records, including the virtual vertices, and the
+    // vertex-level arrays of DFSUtils and Planarity
+    memcpy(dstGraph->V, srcGraph->V, gp_UpperBoundVertexStorage(srcGraph) * sizeof(vertexRec));
+    memcpy(dstGraph->vertexVisitStamps, srcGraph->vertexVisitStamps, gp_UpperBoundVertexStorage(srcGraph) * sizeof(GP_FLAGS_T));
+    memcpy(theGraphDVI(dstGraph), theGraphDVI(srcGraph), gp_UpperBoundVertices(srcGraph) * sizeof(DFSUtils_VertexInfo));
+    memcpy(theGraphPVI(dstGraph), theGraphPVI(srcGraph), gp_UpperBoundVertices(srcGraph) * sizeof(Planarity_VertexInfo));
+    memcpy(theGraphExtFace(dstGraph), theGraphExtFace(srcGraph), gp_UpperBoundVertexStorage(srcGraph) * sizeof(extFaceLinkRec));
+
+    // Copy the edge records in use, then clear any that the dstGraph was
+    // using beyond those
+    memcpy(dstGraph->E + gp_LowerBoundEdgeStorage(srcGraph), srcGraph->E + gp_LowerBoundEdgeStorage(srcGraph),
+           (srcUpperBoundEdges - gp_LowerBoundEdgeStorage(srcGraph)) * sizeof(edgeRec));
+    memcpy(dstGraph->edgeVisitStamps + gp_LowerBoundEdgeStorage(srcGraph), srcGraph->edgeVisitStamps + gp_LowerBoundEdgeStorage(srcGraph),
+           (srcUpperBoundEdges - gp_LowerBoundEdgeStorage(srcGraph)) * sizeof(GP_FLAGS_T));
+
+    for (int e = srcUpperBoundEdges; e < dstUpperBoundEdges; e++)
+        _InitEdgeRec(dstGraph, e);
+    if (dstUpperBoundEdges > srcUpperBoundEdges)
+        memset(dstGraph->edgeVisitStamps + srcUpperBoundEdges, 0,
+               (size_t)(dstUpperBoundEdges - srcUpperBoundEdges) * sizeof(GP_FLAGS_T));
+
+    dstGraph->vertexVisitEpoch = srcGraph->vertexVisitEpoch;
+    dstGraph->edgeVisitEpoch = srcGraph->edgeVisitEpoch;
+
+    // Give the dstGraph the same size and intrinsic properties
+    dstGraph->M = gp_GetM(srcGraph);
+    dstGraph->embedFlags = gp_GetEmbedFlags(srcGraph);
+    dstGraph->graphFlags = gp_GetGraphFlags(srcGraph);
+    theGraphEdgeDependentGraphFlags(dstGraph) = theGraphEdgeDependentGraphFlags(srcGraph);
+
+    LCCopy(theGraphBicompRootLists(dstGraph), theGraphBicompRootLists(srcGraph));
+    LCCopy(theGraphSortedDFSChildLists(dstGraph), theGraphSortedDFSChildLists(srcGraph));
+    sp_Copy(dstGraph->theStack, srcGraph->theStack);
+    sp_Copy(dstGraph->edgeHoles, srcGraph->edgeHoles);
+    dstGraph->numEdgeHoles = sp_GetCurrentSize((dstGraph)->edgeHoles);
+
+    // The extension data is copied or reinitialized as by gp_CopyGraph()
+    if (gp_CopyExtensions(dstGraph, srcGraph) != OK)
+        return NOTOK;
+
+    return OK;
+}
+
 /********************************************************************
  gp_DupGraph()
  ********************************************************************/
@@ -1176,6 +1537,40 @@ graphP gp_DupGraph(graphP theGraph)
     return result;
 }
 
+/********************************************************************
+ gp_SetRandomGenerator()
+
+ Sets the random number generator used by gp_CreateRandomGraph() and
+ gp_CreateRandomGraphEx() for theGraph. The generator is owned by the
+ caller and must remain valid while theGraph uses it. It is not copied
+ by gp_CopyGraph() or gp_DupGraph(), and it is retained when the graph
+ storage is reset or reinitialized.
+ Passing NULL restores use of the calling thread's default generator.
+ ********************************************************************/
+
+void gp_SetRandomGenerator(graphP theGraph, randomGeneratorP theGenerator)
+{
+    if (theGraph == NULL)
+        return;
+
+    theGraphRandomGenerator(theGraph) = theGenerator;
+}
+
+/********************************************************************
+ gp_GetRandomGenerator()
+
+ Returns the random number generator set for theGraph, or the calling
+ thread's default generator if none has been set.
+ ********************************************************************/
+
+randomGeneratorP gp_GetRandomGenerator(graphP theGraph)
+{
+    if (theGraph == NULL || theGraphRandomGenerator(theGraph) == NULL)
+        return gp_GetThreadRandomGenerator();
+
+    return theGraphRandomGenerator(theGraph);
+}
+
 /********************************************************************
  gp_CreateRandomGraph()
 
@@ -1184,14 +1579,17 @@ graphP gp_DupGraph(graphP theGraph)
  additional random edges are added.  If an edge already exists, then
  we retry until a non-existent edge is picked.
 
- This function assumes the caller has already called srand().
+ This function assumes the caller has already seeded the generator
+ used by the graph (see gp_SetRandomGenerator() and gp_SeedRandomNumber()).
 
  Returns OK on success, NOTOK on failure
  ********************************************************************/
 
 int gp_CreateRandomGraph(graphP theGraph)
 {
+    randomGeneratorP theGenerator = NULL;
     int N, M, u, v, m;
+    int enabledEdgeIndex = FALSE, Result = OK;
 
     if (theGraph == NULL)
     {
@@ -1199,6 +1597,7 @@ int gp_CreateRandomGraph(graphP theGraph)
     }
 
     N = gp_GetN(theGraph);
+    theGenerator = gp_GetRandomGenerator(theGraph);
 
     /* Generate a random tree; note that this method virtually guarantees
             that the graph will be renumbered, but it is linear time.
@@ -1207,7 +1606,7 @@ int gp_CreateRandomGraph(graphP theGraph)
 
     for (v = gp_LowerBoundVertices(theGraph) + 1; v < gp_UpperBoundVertices(theGraph); ++v)
     {
-        u = gp_GetRandomNumber(gp_LowerBoundVertices(theGraph), v - 1);
+        u = gp_GetRandomNumberFromGenerator(theGenerator, gp_LowerBoundVertices(theGraph), v - 1);
         if (gp_AddEdge(theGraph, u, 0, v, 0) != OK)
             return NOTOK;
     }
@@ -1216,15 +1615,20 @@ int gp_CreateRandomGraph(graphP theGraph)
             (actually, leave open a small chance that no
             additional edges will be added). */
 
-    M = gp_GetRandomNumber(7 * N / 8, theGraph->edgeCapacity);
+    M = gp_GetRandomNumberFromGenerator(theGenerator, 7 * N / 8, theGraph->edgeCapacity);
 
-    if (M > N * (N - 1) / 2)
-        M = N * (N - 1) / 2;
+    if (M > _GetMaxSimpleGraphEdges(N))
+        M = _GetMaxSimpleGraphEdges(N);
+
+    // If the graph will be dense, then the edge index is used to speed up
+    // the duplicate edge tests; the generator still works if it fails
+    if (2 * (long long)M > RANDOMGRAPH_EDGEINDEX_MINDEGREE * (long long)N && !gp_IsEdgeIndexEnabled(theGraph))
+        enabledEdgeIndex = gp_EnableEdgeIndex(theGraph) == OK;
 
     for (m = N - 1; m < M; m++)
     {
-        u = gp_GetRandomNumber(gp_LowerBoundVertices(theGraph), gp_UpperBoundVertices(theGraph) - 2);
-        v = gp_GetRandomNumber(u + 1, gp_UpperBoundVertices(theGraph) - 1);
+        u = gp_GetRandomNumberFromGenerator(theGenerator, gp_LowerBoundVertices(theGraph), gp_UpperBoundVertices(theGraph) - 2);
+        v = gp_GetRandomNumberFromGenerator(theGenerator, u + 1, gp_UpperBoundVertices(theGraph) - 1);
 
         // If the edge (u,v) exists, decrement eIndex to try again
         if (gp_IsNeighbor(theGraph, u, v))
@@ -1234,11 +1638,17 @@ int gp_CreateRandomGraph(graphP theGraph)
         else
         {
             if (gp_AddEdge(theGraph, u, 0, v, 0) != OK)
-                return NOTOK;
+            {
+                Result = NOTOK;
+                break;
+            }
         }
     }
 
-    return OK;
+    if (enabledEdgeIndex)
+        gp_DisableEdgeIndex(theGraph);
+
+    return Result;
 }
 
 int _AddRandomGraphEdgeCandidate(randomGraphEdgeRec *edgeList, int edgeListCapacity, int *pEdgeListCount, int u, int v)
@@ -1265,7 +1675,7 @@ int _ProcessRandomGraphOptionalEdge(graphP theGraph, randomGraphEdgeRec *edgeLis
     return OK;
 }
 
-void _ShuffleRandomGraphEdgeCandidates(randomGraphEdgeRec *edgeList, int edgeCount)
+void _ShuffleRandomGraphEdgeCandidates(randomGeneratorP theGenerator, randomGraphEdgeRec *edgeList, int edgeCount)
 {
     int e;
 
@@ -1274,7 +1684,7 @@ void _ShuffleRandomGraphEdgeCandidates(randomGraphEdgeRec *edgeList, int edgeCou
 
     for (e = edgeCount - 1; e > 0; --e)
     {
-        int e2 = gp_GetRandomNumber(0, e);
+        int e2 = gp_GetRandomNumberFromGenerator(theGenerator, 0, e);
         randomGraphEdgeRec temp = edgeList[e];
 
         edgeList[e] = edgeList[e2];
@@ -1297,7 +1707,8 @@ void _ShuffleRandomGraphEdgeCandidates(randomGraphEdgeRec *edgeList, int edgeCou
  subgraph of a random maximal planar graph. The output graph will
  have exactly numEdges edges.
 
- NOTE: This function assumes the caller has already called srand().
+ NOTE: This function assumes the caller has already seeded the generator
+ used by the graph (see gp_SetRandomGenerator() and gp_SeedRandomNumber()).
 
  NOTE: If numEdges is larger than the edge capacity of theGraph, then
        then its value is reduced internally. The caller can invoke
@@ -1306,13 +1717,14 @@ void _ShuffleRandomGraphEdgeCandidates(randomGraphEdgeRec *edgeList, int edgeCou
 
 int gp_CreateRandomGraphEx(graphP theGraph, int numEdges)
 {
+    randomGeneratorP theGenerator = NULL;
     randomGraphEdgeRec *optionalEdges = NULL;
     randomGraphFaceRec *faces = NULL;
     int N, maxNumEdges, maxPlanarEdges, numPlanarCoreEdges;
     int lowerVertex, upperVertex, faceCapacity, optionalEdgeCapacity;
     int optionalEdgeCount = 0, faceCount = 0, addAllPlanarEdges;
-    int Result = OK;
-    int v, u, e;
+    int enabledEdgeIndex = FALSE, Result = OK;
+    int v, e;
 
     // Parameter checks: Must have a graph of at least three vertices, and the
     // number of edges must be at least enough to support making a random tree.
@@ -1322,8 +1734,9 @@ int gp_CreateRandomGraphEx(graphP theGraph, int numEdges)
     N = gp_GetN(theGraph);
     lowerVertex = gp_LowerBoundVertices(theGraph);
     upperVertex = gp_UpperBoundVertices(theGraph);
-    maxNumEdges = (N * (N - 1)) >> 1;
+    maxNumEdges = _GetMaxSimpleGraphEdges(N);
     maxPlanarEdges = 3 * N - 6;
+    theGenerator = gp_GetRandomGenerator(theGraph);
 
     if (numEdges > theGraph->edgeCapacity)
         numEdges = theGraph->edgeCapacity;
@@ -1339,10 +1752,10 @@ int gp_CreateRandomGraphEx(graphP theGraph, int numEdges)
     faceCapacity = 2 * N - 4;
     optionalEdgeCapacity = maxPlanarEdges - (N - 1);
 
-    faces = (randomGraphFaceRec *)calloc((size_t)faceCapacity, sizeof(randomGraphFaceRec));
+    faces = (randomGraphFaceRec *)gp_MemCalloc((size_t)faceCapacity, sizeof(randomGraphFaceRec));
 
     if (!addAllPlanarEdges && numPlanarCoreEdges > N - 1)
-        optionalEdges = (randomGraphEdgeRec *)calloc((size_t)optionalEdgeCapacity, sizeof(randomGraphEdgeRec));
+        optionalEdges = (randomGraphEdgeRec *)gp_MemCalloc((size_t)optionalEdgeCapacity, sizeof(randomGraphEdgeRec));
 
     if (faces == NULL || (!addAllPlanarEdges && numPlanarCoreEdges > N - 1 && optionalEdges == NULL))
     {
@@ -1376,12 +1789,12 @@ int gp_CreateRandomGraphEx(graphP theGraph, int numEdges)
 
     for (v = lowerVertex + 3; v < upperVertex; ++v)
     {
-        int faceIndex = gp_GetRandomNumber(0, faceCount - 1);
+        int faceIndex = gp_GetRandomNumberFromGenerator(theGenerator, 0, faceCount - 1);
         int a = faces[faceIndex].a;
         int b = faces[faceIndex].b;
         int c = faces[faceIndex].c;
         int faceVertices[3] = {a, b, c};
-        int treeEdgeIndex = gp_GetRandomNumber(0, 2);
+        int treeEdgeIndex = gp_GetRandomNumberFromGenerator(theGenerator, 0, 2);
         int i;
 
         if (gp_AddEdge(theGraph, v, 0, faceVertices[treeEdgeIndex], 0) != OK)
@@ -1424,7 +1837,7 @@ int gp_CreateRandomGraphEx(graphP theGraph, int numEdges)
 
     if (optionalEdges != NULL)
     {
-        _ShuffleRandomGraphEdgeCandidates(optionalEdges, optionalEdgeCount);
+        _ShuffleRandomGraphEdgeCandidates(theGenerator, optionalEdges, optionalEdgeCount);
 
         for (e = 0; e < optionalEdgeCount && gp_GetM(theGraph) < numPlanarCoreEdges; ++e)
         {
@@ -1444,37 +1857,379 @@ int gp_CreateRandomGraphEx(graphP theGraph, int numEdges)
 
     /* Add additional random edges if the limit has not yet been reached. */
 
+    // If the graph will be dense, then the edge index is used to speed up
+    // the duplicate edge tests; the generator still works if it fails
+    if (2 * (long long)numEdges > RANDOMGRAPH_EDGEINDEX_MINDEGREE * (long long)N && !gp_IsEdgeIndexEnabled(theGraph))
+        enabledEdgeIndex = gp_EnableEdgeIndex(theGraph) == OK;
+
+    // Each batch has at most as many edges as are still needed, and the
+    // loops and duplicates are skipped in order, so the result is the same
+    // as adding the random edges one at a time until there are numEdges
     while (gp_GetM(theGraph) < numEdges)
     {
-        u = gp_GetRandomNumber(lowerVertex, upperVertex - 1);
-        v = gp_GetRandomNumber(lowerVertex, upperVertex - 1);
+        int uBatch[RANDOMGRAPH_BATCH_SIZE], vBatch[RANDOMGRAPH_BATCH_SIZE];
+        int batchSize = numEdges - gp_GetM(theGraph);
+
+        if (batchSize > RANDOMGRAPH_BATCH_SIZE)
+            batchSize = RANDOMGRAPH_BATCH_SIZE;
 
-        if (u != v && !gp_IsNeighbor(theGraph, u, v))
+        for (int i = 0; i < batchSize; i++)
         {
-            if (gp_AddEdge(theGraph, u, 0, v, 0) != OK)
-            {
-                Result = NOTOK;
-                goto gp_CreateRandomGraphEx_Cleanup;
-            }
+            uBatch[i] = gp_GetRandomNumberFromGenerator(theGenerator, lowerVertex, upperVertex - 1);
+            vBatch[i] = gp_GetRandomNumberFromGenerator(theGenerator, lowerVertex, upperVertex - 1);
+        }
+
+        if (gp_AddEdgesBulk(theGraph, uBatch, vBatch, batchSize, ADDEDGES_SKIPLOOPS | ADDEDGES_SKIPDUPLICATES) != OK)
+        {
+            Result = NOTOK;
+            goto gp_CreateRandomGraphEx_Cleanup;
         }
     }
 
 gp_CreateRandomGraphEx_Cleanup:
 
+    if (enabledEdgeIndex)
+        gp_DisableEdgeIndex(theGraph);
+
     if (optionalEdges != NULL)
     {
-        free(optionalEdges);
+        gp_MemFree(optionalEdges);
         optionalEdges = NULL;
     }
     if (faces != NULL)
     {
-        free(faces);
+        gp_MemFree(faces);
         faces = NULL;
     }
 
     return Result;
 }
 
+/********************************************************************
+ gp_EnableEdgeIndex()
+
+ Attaches to theGraph an array of vertex degrees and an open addressing
+ hash table of the edge records in the adjacency lists, keyed by the
+ owning vertex and the neighbor of each edge record. While the index is
+ enabled, gp_GetVertexDegree() returns a maintained counter, and
+ gp_IsNeighbor(), gp_FindEdge(), gp_IsNeighborDirected() and
+ gp_FindDirectedEdge() take constant expected time rather than time
+ proportional to the degree of the vertex.
+
+ The index is maintained by the operations that add, delete, hide and
+ restore edges, and by vertex identification and edge contraction.
+ It is discarded by operations that restructure the whole graph, i.e.
+ gp_Embed(), gp_SortVertices(), gp_ResetGraphStorage(), gp_CopyGraph(),
+ gp_CopyGraphInUse() and gp_CopyAdjacencyLists() (for the destination
+ graph), since these rebuild the adjacency lists directly.
+
+ NOTE: If there are parallel edges, gp_FindEdge() may return a different
+       one of them than it would without the index.
+
+ The index costs one GP_INDEX_T per vertex plus two to four per edge
+ record in use, and it is grown as needed when edges are added.
+
+ Returns OK on success or if the index is already enabled, or NOTOK on
+ failure, in which case the graph is unchanged.
+ ********************************************************************/
+
+int gp_EnableEdgeIndex(graphP theGraph)
+{
+    int numEdgeRecords = 0, size = 16, v, e;
+
+    if (theGraph == NULL || gp_GetN(theGraph) <= 0)
+        return NOTOK;
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        return OK;
+
+    for (v = gp_LowerBoundVertexStorage(theGraph); v < gp_UpperBoundVertexStorage(theGraph); ++v)
+    {
+        e = gp_GetFirstEdge(theGraph, v);
+        while (gp_IsEdge(theGraph, e))
+        {
+            numEdgeRecords++;
+            e = gp_GetNextEdge(theGraph, e);
+        }
+    }
+
+    // Keep the table at most half full
+    while (size < 2 * (long long)numEdgeRecords + 2)
+    {
+        if (size > INT_MAX / 2)
+            return NOTOK;
+        size <<= 1;
+    }
+
+    theGraphVertexDegree(theGraph) = (GP_INDEX_T *)gp_MemCalloc((size_t)gp_UpperBoundVertexStorage(theGraph), sizeof(GP_INDEX_T));
+    theGraphEdgeIndex(theGraph) = (GP_INDEX_T *)gp_MemAlloc((size_t)size * sizeof(GP_INDEX_T));
+
+    if (theGraphVertexDegree(theGraph) == NULL || theGraphEdgeIndex(theGraph) == NULL)
+    {
+        gp_DisableEdgeIndex(theGraph);
+        return NOTOK;
+    }
+
+    memset(theGraphEdgeIndex(theGraph), NIL_CHAR, (size_t)size * sizeof(GP_INDEX_T));
+    theGraphEdgeIndexSize(theGraph) = size;
+    theGraphEdgeIndexCount(theGraph) = 0;
+
+    for (v = gp_LowerBoundVertexStorage(theGraph); v < gp_UpperBoundVertexStorage(theGraph); ++v)
+    {
+        e = gp_GetFirstEdge(theGraph, v);
+        while (gp_IsEdge(theGraph, e))
+        {
+            _IndexEdgeRecord(theGraph, v, e);
+            e = gp_GetNextEdge(theGraph, e);
+        }
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ gp_DisableEdgeIndex()
+
+ Frees the edge index, if any, so that the vertex interrogators go back
+ to traversing adjacency lists.
+ ********************************************************************/
+
+void gp_DisableEdgeIndex(graphP theGraph)
+{
+    if (theGraph == NULL || theGraph->privateData == NULL)
+        return;
+
+    if (theGraphVertexDegree(theGraph) != NULL)
+    {
+        gp_MemFree(theGraphVertexDegree(theGraph));
+        theGraphVertexDegree(theGraph) = NULL;
+    }
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+    {
+        gp_MemFree(theGraphEdgeIndex(theGraph));
+        theGraphEdgeIndex(theGraph) = NULL;
+    }
+
+    theGraphEdgeIndexSize(theGraph) = 0;
+    theGraphEdgeIndexCount(theGraph) = 0;
+}
+
+/********************************************************************
+ gp_IsEdgeIndexEnabled()
+
+ Returns TRUE if gp_EnableEdgeIndex() has attached an edge index that
+ has not since been discarded, or FALSE otherwise.
+ ********************************************************************/
+
+int gp_IsEdgeIndexEnabled(graphP theGraph)
+{
+    if (theGraph == NULL)
+        return FALSE;
+
+    return theGraphEdgeIndex(theGraph) != NULL ? TRUE : FALSE;
+}
+
+/********************************************************************
+ _GetEdgeIndexSlot()
+
+ Returns the home slot in the edge index of an edge record in the
+ adjacency list of u that indicates neighbor v. The table size is a
+ power of two, so the bits of the key are mixed before masking.
+ ********************************************************************/
+
+int _GetEdgeIndexSlot(graphP theGraph, int u, int v)
+{
+    unsigned h = (unsigned)u * 0x9E3779B1u + (unsigned)v;
+
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+
+    return (int)(h & (unsigned)(theGraphEdgeIndexSize(theGraph) - 1));
+}
+
+/********************************************************************
+ _GrowEdgeIndex()
+
+ Doubles the size of the edge index table and rehashes the edge
+ records into it. The owner of each edge record is obtained from its
+ twin, so all indexed edge records must have both neighbors set.
+
+ Returns OK on success, NOTOK on allocation failure, in which case the
+ old table is retained.
+ ********************************************************************/
+
+int _GrowEdgeIndex(graphP theGraph)
+{
+    GP_INDEX_T *oldIndex = theGraphEdgeIndex(theGraph);
+    int oldSize = theGraphEdgeIndexSize(theGraph);
+    GP_INDEX_T *newIndex = NULL;
+    int slot, e;
+
+    if (oldSize > INT_MAX / 2)
+        return NOTOK;
+
+    newIndex = (GP_INDEX_T *)gp_MemAlloc((size_t)oldSize * 2 * sizeof(GP_INDEX_T));
+    if (newIndex == NULL)
+        return NOTOK;
+
+    memset(newIndex, NIL_CHAR, (size_t)oldSize * 2 * sizeof(GP_INDEX_T));
+    theGraphEdgeIndex(theGraph) = newIndex;
+    theGraphEdgeIndexSize(theGraph) = oldSize * 2;
+
+    for (int i = 0; i < oldSize; i++)
+    {
+        if ((e = oldIndex[i]) == NIL)
+            continue;
+
+        slot = _GetEdgeIndexSlot(theGraph, gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e)),
+                                 gp_GetNeighbor(theGraph, e));
+        while (newIndex[slot] != NIL)
+            slot = (slot + 1) & (theGraphEdgeIndexSize(theGraph) - 1);
+        newIndex[slot] = e;
+    }
+
+    gp_MemFree(oldIndex);
+    return OK;
+}
+
+/********************************************************************
+ _IndexEdgeRecord()
+
+ Adds edge record e, which has just been attached to the adjacency
+ list of the owner vertex, to the edge index. The owner is given
+ explicitly because gp_AddEdge() attaches an edge record before
+ setting the neighbor of its twin.
+
+ If the table cannot be grown, then the edge index is discarded so
+ that the vertex interrogators fall back to list traversals.
+ ********************************************************************/
+
+void _IndexEdgeRecord(graphP theGraph, int owner, int e)
+{
+    int slot;
+
+    if (2 * (theGraphEdgeIndexCount(theGraph) + 1) > theGraphEdgeIndexSize(theGraph) &&
+        _GrowEdgeIndex(theGraph) != OK)
+    {
+        gp_DisableEdgeIndex(theGraph);
+        return;
+    }
+
+    slot = _GetEdgeIndexSlot(theGraph, owner, gp_GetNeighbor(theGraph, e));
+    while (theGraphEdgeIndex(theGraph)[slot] != NIL)
+        slot = (slot + 1) & (theGraphEdgeIndexSize(theGraph) - 1);
+
+    theGraphEdgeIndex(theGraph)[slot] = e;
+    theGraphEdgeIndexCount(theGraph)++;
+    theGraphVertexDegree(theGraph)[owner]++;
+}
+
+/********************************************************************
+ _UnindexEdgeRecord()
+
+ Removes edge record e, which is about to be detached from the
+ adjacency list of its owner, from the edge index. The linear probing
+ run after the vacated slot is shifted back as needed so that lookups
+ can stop at the first empty slot without needing deletion markers.
+ ********************************************************************/
+
+void _UnindexEdgeRecord(graphP theGraph, int e)
+{
+    GP_INDEX_T *theIndex = theGraphEdgeIndex(theGraph);
+    int mask = theGraphEdgeIndexSize(theGraph) - 1;
+    int owner = gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e));
+    int slot, next, home;
+
+    slot = _GetEdgeIndexSlot(theGraph, owner, gp_GetNeighbor(theGraph, e));
+    while (theIndex[slot] != e)
+    {
+        if (theIndex[slot] == NIL)
+            return;
+        slot = (slot + 1) & mask;
+    }
+
+    next = slot;
+    while (1)
+    {
+        next = (next + 1) & mask;
+        if (theIndex[next] == NIL)
+            break;
+
+        // The entry stays put if its home slot is cyclically in (slot, next]
+        home = _GetEdgeIndexSlot(theGraph, gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, theIndex[next])),
+                                 gp_GetNeighbor(theGraph, theIndex[next]));
+        if (slot <= next ? (slot < home && home <= next) : (slot < home || home <= next))
+            continue;
+
+        theIndex[slot] = theIndex[next];
+        slot = next;
+    }
+
+    theIndex[slot] = NIL;
+    theGraphEdgeIndexCount(theGraph)--;
+    theGraphVertexDegree(theGraph)[owner]--;
+}
+
+/********************************************************************
+ _FindIndexedEdge()
+
+ Searches the edge index for an edge record in the adjacency list of u
+ that indicates neighbor v and that matches the direction, which may be
+ 0 to match any edge record.
+
+ Returns the edge record's location, or NIL if there is no such edge.
+ ********************************************************************/
+
+int _FindIndexedEdge(graphP theGraph, int u, int v, unsigned direction)
+{
+    GP_INDEX_T *theIndex = theGraphEdgeIndex(theGraph);
+    int mask = theGraphEdgeIndexSize(theGraph) - 1;
+    int slot = _GetEdgeIndexSlot(theGraph, u, v);
+    int e;
+
+    while ((e = theIndex[slot]) != NIL)
+    {
+        if (gp_GetNeighbor(theGraph, e) == v &&
+            gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e)) == u &&
+            (direction == 0 || gp_GetDirection(theGraph, e) == direction))
+            return e;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return NIL;
+}
+
+/********************************************************************
+ _SetEdgeRecordOwner()
+
+ Makes the owner vertex the neighbor of the twin of edge record e, as
+ is done for the edge records moved between adjacency lists by vertex
+ identification and restoration, and updates the edge index, if any,
+ for the changed keys of e and its twin.
+ ********************************************************************/
+
+void _SetEdgeRecordOwner(graphP theGraph, int e, int owner)
+{
+    int eTwin = gp_GetTwin(theGraph, e);
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+    {
+        _UnindexEdgeRecord(theGraph, e);
+        _UnindexEdgeRecord(theGraph, eTwin);
+    }
+
+    gp_SetNeighbor(theGraph, eTwin, owner);
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+    {
+        _IndexEdgeRecord(theGraph, owner, e);
+        _IndexEdgeRecord(theGraph, gp_GetNeighbor(theGraph, e), eTwin);
+    }
+}
+
 /********************************************************************
  gp_IsNeighbor()
 
@@ -1502,6 +2257,9 @@ int gp_IsNeighbor(graphP theGraph, int u, int v)
         return FALSE;
     }
 
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        return gp_IsEdge(theGraph, _FindIndexedEdge(theGraph, u, v, 0)) ? TRUE : FALSE;
+
     e = gp_GetFirstEdge(theGraph, u);
     while (gp_IsEdge(theGraph, e))
     {
@@ -1541,6 +2299,9 @@ int gp_IsNeighborDirected(graphP theGraph, int u, int v, unsigned direction)
         return FALSE;
     }
 
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        return gp_IsEdge(theGraph, _FindIndexedEdge(theGraph, u, v, direction)) ? TRUE : FALSE;
+
     e = gp_GetFirstEdge(theGraph, u);
     while (gp_IsEdge(theGraph, e))
     {
@@ -1596,7 +2357,12 @@ int gp_FindEdge(graphP theGraph, int u, int v)
  */
 int _gp_FindEdge(graphP theGraph, int u, int v)
 {
-    int e = gp_GetFirstEdge(theGraph, u);
+    int e = NIL;
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        return _FindIndexedEdge(theGraph, u, v, 0);
+
+    e = gp_GetFirstEdge(theGraph, u);
     while (gp_IsEdge(theGraph, e))
     {
         if (gp_GetNeighbor(theGraph, e) == v)
@@ -1640,6 +2406,9 @@ int gp_FindDirectedEdge(graphP theGraph, int u, int v, unsigned direction)
         return _gp_FindEdge(theGraph, u, v);
 
     // If a direction was given, then use it
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        return _FindIndexedEdge(theGraph, u, v, direction);
+
     e = gp_GetFirstEdge(theGraph, u);
     while (gp_IsEdge(theGraph, e))
     {
@@ -1663,9 +2432,9 @@ NOTE: For digraphs, this method returns the total degree of the
     Other functions are defined to get the in-degree or out-degree
     of a vertex.
 
-NOTE: This function determines the degree by counting. An extension
-    could cache the degree value of each vertex and update the
-    cached value as edges are added and deleted.
+NOTE: This function determines the degree by counting, unless the
+    edge index is enabled (see gp_EnableEdgeIndex()), in which case
+    the maintained degree of the vertex is returned.
 ********************************************************************/
 
 int gp_GetVertexDegree(graphP theGraph, int v)
@@ -1683,6 +2452,9 @@ int gp_GetVertexDegree(graphP theGraph, int v)
         return 0;
     }
 
+    if (theGraphVertexDegree(theGraph) != NULL)
+        return theGraphVertexDegree(theGraph)[v];
+
     degree = 0;
 
     e = gp_GetFirstEdge(theGraph, v);
@@ -1703,9 +2475,9 @@ int gp_GetVertexDegree(graphP theGraph, int v)
  This includes undirected edges and INONLY edge records, so it only
  excludes edges records that are marked as OUTONLY.
 
- NOTE: This function determines the in-degree by counting. An extension
-       could cache the in-degree value of each vertex and update the
-       cached value as edges are added and deleted.
+ NOTE: This function determines the in-degree by counting, even when
+       the edge index is enabled, since edge directions are set by
+       gp_SetDirection() after the edge records are attached.
  ********************************************************************/
 
 int gp_GetVertexInDegree(graphP theGraph, int v)
@@ -1743,9 +2515,9 @@ int gp_GetVertexInDegree(graphP theGraph, int v)
  This includes undirected edges and OUTONLY edges, so it only excludes
  edges records that are marked as INONLY edges.
 
- NOTE: This function determines the out-degree by counting. An extension
-       could cache the out-degree value of each vertex and update the
-       cached value as edges are added and deleted.
+ NOTE: This function determines the out-degree by counting, even when
+       the edge index is enabled, since edge directions are set by
+       gp_SetDirection() after the edge records are attached.
  ********************************************************************/
 
 int gp_GetVertexOutDegree(graphP theGraph, int v)
@@ -1796,6 +2568,8 @@ int gp_GetVertexOutDegree(graphP theGraph, int v)
 
 void _AttachEdgeRecord(graphP theGraph, int v, int e, int link, int newEdge)
 {
+    _ClearEdgeDependentGraphFlags(theGraph);
+
     if (gp_IsEdge(theGraph, e))
     {
         int e2 = gp_GetAdjacentEdge(theGraph, e, link);
@@ -1813,6 +2587,9 @@ void _AttachEdgeRecord(graphP theGraph, int v, int e, int link, int newEdge)
             gp_SetAdjacentEdge(theGraph, e2, 1 ^ link, newEdge);
         else
             gp_SetEdgeByLink(theGraph, v, 1 ^ link, newEdge);
+
+        if (theGraphEdgeIndex(theGraph) != NULL)
+            _IndexEdgeRecord(theGraph, gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e)), newEdge);
     }
     else
     {
@@ -1831,6 +2608,9 @@ void _AttachEdgeRecord(graphP theGraph, int v, int e, int link, int newEdge)
             gp_SetAdjacentEdge(theGraph, e2, 1 ^ link, newEdge);
         else
             gp_SetEdgeByLink(theGraph, v, 1 ^ link, newEdge);
+
+        if (theGraphEdgeIndex(theGraph) != NULL)
+            _IndexEdgeRecord(theGraph, v, newEdge);
     }
 }
 
@@ -1860,6 +2640,11 @@ void _DetachEdgeRecord(graphP theGraph, int e)
     int nextEdge = gp_GetNextEdge(theGraph, e),
         prevEdge = gp_GetPrevEdge(theGraph, e);
 
+    _ClearEdgeDependentGraphFlags(theGraph);
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        _UnindexEdgeRecord(theGraph, e);
+
     if (gp_IsEdge(theGraph, nextEdge))
         gp_SetPrevEdge(theGraph, nextEdge, prevEdge);
     else
@@ -1961,16 +2746,20 @@ int gp_DynamicAddEdge(graphP theGraph, int u, int ulink, int v, int vlink)
 
     if (Result == AT_EDGE_CAPACITY_LIMIT)
     {
-        // The candidate edge capacity is double the current capacity
-        int candidateEdgeCapacity = gp_GetEdgeCapacity(theGraph) << 1;
-        int N = gp_GetN(theGraph);
+        // The candidate edge capacity is double the current capacity,
+        // (or INT_MAX, which gp_EnsureEdgeCapacity() will reject, if
+        // doubling would overflow)
+        int candidateEdgeCapacity = gp_GetEdgeCapacity(theGraph) <= (INT_MAX >> 1)
+                                        ? gp_GetEdgeCapacity(theGraph) << 1
+                                        : INT_MAX;
+        int maxSimpleEdges = _GetMaxSimpleGraphEdges(gp_GetN(theGraph));
         int newEdgeCapacity = candidateEdgeCapacity;
 
         // If the candidate edge capacity exceeds the number of edges
         // needed in an undirected clique on N vertices, then attempt
         // to use that as the new edge capacity.
-        if (candidateEdgeCapacity > ((N * (N - 1)) >> 1))
-            newEdgeCapacity = ((N * (N - 1)) >> 1);
+        if (candidateEdgeCapacity > maxSimpleEdges)
+            newEdgeCapacity = maxSimpleEdges;
 
         // However, if the edge capacity is already greater than or
         // equal to that maximum capacity needed for an undirected
@@ -1990,6 +2779,76 @@ int gp_DynamicAddEdge(graphP theGraph, int u, int ulink, int v, int vlink)
     return Result != OK ? NOTOK : Result;
 }
 
+/********************************************************************
+ gp_AddEdgesBulk()
+
+ Adds the count undirected edges (u[i], v[i]) to the graph with the
+ same result as calling gp_AddEdge(theGraph, u[i], 0, v[i], 0) for each
+ i in order, but the vertices are validated and the edge capacity is
+ checked once for the whole array. Each edge record pair is then placed
+ and linked into the adjacency lists as by gp_AddEdge().
+
+ The flags may combine ADDEDGES_SKIPLOOPS to omit loop edges and
+ ADDEDGES_SKIPDUPLICATES to omit edges whose endpoints are already
+ adjacent, including by an edge added earlier in the same call. The
+ duplicate tests use gp_IsNeighbor(), so for large inputs the caller
+ should first call gp_EnableEdgeIndex().
+
+ Like gp_AddEdge(), this function does not increase the edge capacity,
+ so the caller should first use gp_EnsureEdgeCapacity() to reserve the
+ capacity for all of the edges to be added, e.g. by several calls.
+
+ Returns OK on success, NOTOK if any vertex is out of range, or
+         AT_EDGE_CAPACITY_LIMIT if the edge capacity is too small for
+         count more edges, even if some of them would be skipped
+         (in either of the latter two cases no edges are added)
+ ********************************************************************/
+
+int gp_AddEdgesBulk(graphP theGraph, const int *u, const int *v, int count, unsigned flags)
+{
+    int upos, vpos;
+
+    if (theGraph == NULL || count < 0 || (count > 0 && (u == NULL || v == NULL)))
+        return NOTOK;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (u[i] < gp_LowerBoundVertexStorage(theGraph) || u[i] >= gp_UpperBoundVertexStorage(theGraph) ||
+            v[i] < gp_LowerBoundVertexStorage(theGraph) || v[i] >= gp_UpperBoundVertexStorage(theGraph))
+            return NOTOK;
+    }
+
+    if ((long long)gp_GetM(theGraph) + count > gp_GetEdgeCapacity(theGraph))
+        return AT_EDGE_CAPACITY_LIMIT;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (((flags & ADDEDGES_SKIPLOOPS) && u[i] == v[i]) ||
+            ((flags & ADDEDGES_SKIPDUPLICATES) && gp_IsNeighbor(theGraph, u[i], v[i])))
+            continue;
+
+        // Edge holes are filled first, as in gp_AddEdge()
+        if (theGraph->numEdgeHoles > 0)
+        {
+            sp_Pop(theGraph->edgeHoles, vpos);
+            theGraph->numEdgeHoles = sp_GetCurrentSize(theGraph->edgeHoles);
+        }
+        else
+            vpos = gp_UpperBoundEdges(theGraph);
+
+        upos = gp_GetTwin(theGraph, vpos);
+
+        gp_SetNeighbor(theGraph, upos, v[i]);
+        _AttachEdgeRecord(theGraph, u[i], NIL, 0, upos);
+        gp_SetNeighbor(theGraph, vpos, u[i]);
+        _AttachEdgeRecord(theGraph, v[i], NIL, 0, vpos);
+
+        theGraph->M++;
+    }
+
+    return OK;
+}
+
 /********************************************************************
  gp_DynamicInsertEdge()
  Refer to documentation for gp_InsertEdge() for parameter description.
@@ -2008,16 +2867,20 @@ int gp_DynamicInsertEdge(graphP theGraph, int u, int e_u, int e_ulink,
 
     if (Result == AT_EDGE_CAPACITY_LIMIT)
     {
-        // The candidate edge capacity is double the current capacity
-        int candidateEdgeCapacity = gp_GetEdgeCapacity(theGraph) << 1;
-        int N = gp_GetN(theGraph);
+        // The candidate edge capacity is double the current capacity,
+        // (or INT_MAX, which gp_EnsureEdgeCapacity() will reject, if
+        // doubling would overflow)
+        int candidateEdgeCapacity = gp_GetEdgeCapacity(theGraph) <= (INT_MAX >> 1)
+                                        ? gp_GetEdgeCapacity(theGraph) << 1
+                                        : INT_MAX;
+        int maxSimpleEdges = _GetMaxSimpleGraphEdges(gp_GetN(theGraph));
         int newEdgeCapacity = candidateEdgeCapacity;
 
         // If the candidate edge capacity exceeds the number of edges
         // needed in an undirected clique on N vertices, then attempt
         // to use that as the new edge capacity.
-        if (candidateEdgeCapacity > ((N * (N - 1)) >> 1))
-            newEdgeCapacity = ((N * (N - 1)) >> 1);
+        if (candidateEdgeCapacity > maxSimpleEdges)
+            newEdgeCapacity = maxSimpleEdges;
 
         // However, if the edge capacity is already greater than or
         // equal to that maximum capacity needed for an undirected
@@ -2145,6 +3008,7 @@ int _DeleteEdge(graphP theGraph, int e)
     // (the bit twiddle (e & ~1) chooses the lesser of e and its twin)
 #ifdef USE_1BASEDARRAYS
     memset(theGraph->E + (e & ~1), NIL_CHAR, sizeof(edgeRec) << 1);
+    memset(theGraph->edgeVisitStamps + (e & ~1), 0, sizeof(GP_FLAGS_T) << 1);
 #else
     _InitEdgeRec(theGraph, e);
     _InitEdgeRec(theGraph, gp_GetTwin(theGraph, e));
@@ -2168,6 +3032,131 @@ int _DeleteEdge(graphP theGraph, int e)
     return OK;
 }
 
+/****************************************************************************
+ gp_CompactEdgeStorage()
+
+ Deleting edges leaves holes in the edge array E. The holes are reused by
+ later edge additions, but until then every loop from gp_LowerBoundEdges()
+ to gp_UpperBoundEdges() must step over them. This function moves the edges
+ in use down over the holes, keeping their relative order and keeping each
+ edge record paired with its twin, so that gp_UpperBoundEdges() then covers
+ exactly the M edges of the graph.
+
+ The adjacency lists are unchanged except that their edge records are
+ renumbered. If oldToNewMap is not NULL, then it must have room for as many
+ entries as gp_UpperBoundEdges() gave before the call, and it receives the
+ new index of each old edge record e in oldToNewMap[e], or NIL if e was not
+ in use. Edge record indices kept outside of the graph must be translated
+ by the caller with this map. This includes hidden edges saved on theStack
+ by gp_HideVertex(), gp_ContractEdge() and gp_IdentifyVertices(), so it is
+ best to restore those before compacting.
+
+ NOTE: Extensions having parallel edge record extension data elements
+       must overload gp_CompactEdgeStorage() to move their edge data with
+       the map, while gp_UpperBoundEdges() still gives the old bound.
+
+ Returns OK on success, NOTOK on failure
+ ****************************************************************************/
+
+int gp_CompactEdgeStorage(graphP theGraph, int *oldToNewMap)
+{
+    int *theMap = oldToNewMap;
+    int e, newE, Result = OK;
+
+    if (theGraph == NULL)
+        return NOTOK;
+
+    if (theMap == NULL && theGraph->numEdgeHoles == 0)
+        return OK;
+
+    if (theMap == NULL &&
+        (theMap = (int *)gp_MemAlloc((size_t)gp_UpperBoundEdges(theGraph) * sizeof(int))) == NULL)
+        return NOTOK;
+
+    for (e = 0; e < gp_LowerBoundEdges(theGraph); e++)
+        theMap[e] = NIL;
+
+    newE = gp_LowerBoundEdges(theGraph);
+    for (e = gp_LowerBoundEdges(theGraph); e < gp_UpperBoundEdges(theGraph); e += 2)
+    {
+        if (gp_EdgeInUse(theGraph, e))
+        {
+            theMap[e] = newE;
+            theMap[e + 1] = newE + 1;
+            newE += 2;
+        }
+        else
+            theMap[e] = theMap[e + 1] = NIL;
+    }
+
+    if (theGraph->numEdgeHoles > 0)
+        Result = theGraph->functions->fpCompactEdgeStorage(theGraph, theMap);
+
+    if (oldToNewMap == NULL)
+        gp_MemFree(theMap);
+
+    return Result;
+}
+
+int _CompactEdgeStorage(graphP theGraph, int *oldToNewMap)
+{
+    GP_INDEX_T *theIndex = theGraphEdgeIndex(theGraph);
+    int oldUpperBound = gp_UpperBoundEdges(theGraph);
+    int newUpperBound = gp_LowerBoundEdges(theGraph) + (gp_GetM(theGraph) << 1);
+    int v, e, newE, slot;
+
+    // Redirect the vertices to the new locations of their first and last edges
+    for (v = gp_LowerBoundVertexStorage(theGraph); v < gp_UpperBoundVertexStorage(theGraph); v++)
+    {
+        if (gp_IsEdge(theGraph, gp_GetFirstEdge(theGraph, v)))
+        {
+            gp_SetFirstEdge(theGraph, v, oldToNewMap[gp_GetFirstEdge(theGraph, v)]);
+            gp_SetLastEdge(theGraph, v, oldToNewMap[gp_GetLastEdge(theGraph, v)]);
+        }
+    }
+
+    // Each edge record moves to the same or a lower index, so moving them in
+    // ascending order never overwrites an edge record that has yet to move.
+    // Hidden edges are in use, and their links are translated too so that
+    // they can still be restored.
+    for (e = gp_LowerBoundEdges(theGraph); e < oldUpperBound; e++)
+    {
+        if ((newE = oldToNewMap[e]) == NIL)
+            continue;
+
+        theGraph->E[newE] = theGraph->E[e];
+        theGraph->edgeVisitStamps[newE] = theGraph->edgeVisitStamps[e];
+
+        if (gp_IsEdge(theGraph, gp_GetNextEdge(theGraph, newE)))
+            gp_SetNextEdge(theGraph, newE, oldToNewMap[gp_GetNextEdge(theGraph, newE)]);
+        if (gp_IsEdge(theGraph, gp_GetPrevEdge(theGraph, newE)))
+            gp_SetPrevEdge(theGraph, newE, oldToNewMap[gp_GetPrevEdge(theGraph, newE)]);
+    }
+
+    // Clear the vacated edge records, which gp_CopyGraphInUse() and the
+    // edge addition methods expect to be in their initial state
+#ifdef USE_1BASEDARRAYS
+    memset(theGraph->E + newUpperBound, NIL_CHAR, (size_t)(oldUpperBound - newUpperBound) * sizeof(edgeRec));
+    memset(theGraph->edgeVisitStamps + newUpperBound, 0, (size_t)(oldUpperBound - newUpperBound) * sizeof(GP_FLAGS_T));
+#else
+    for (e = newUpperBound; e < oldUpperBound; e++)
+        _InitEdgeRec(theGraph, e);
+#endif
+
+    sp_ClearStack(theGraph->edgeHoles);
+    theGraph->numEdgeHoles = 0;
+
+    // The edge index is keyed by endpoints, so its entries can be translated in place
+    if (theIndex != NULL)
+    {
+        for (slot = 0; slot < theGraphEdgeIndexSize(theGraph); slot++)
+            if (theIndex[slot] != NIL)
+                theIndex[slot] = oldToNewMap[theIndex[slot]];
+    }
+
+    return OK;
+}
+
 int gp_ClearEdgeDirectionFlags(graphP theGraph)
 {
     if (theGraph == NULL)
@@ -2234,6 +3223,11 @@ void _RestoreEdgeRecord(graphP theGraph, int e)
     int nextEdge = gp_GetNextEdge(theGraph, e),
         prevEdge = gp_GetPrevEdge(theGraph, e);
 
+    _ClearEdgeDependentGraphFlags(theGraph);
+
+    if (theGraphEdgeIndex(theGraph) != NULL)
+        _IndexEdgeRecord(theGraph, gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e)), e);
+
     if (gp_IsEdge(theGraph, nextEdge))
         gp_SetPrevEdge(theGraph, nextEdge, e);
     else
@@ -2666,7 +3660,7 @@ int _IdentifyVertices(graphP theGraph, int u, int v, int eBefore)
     e = gp_GetFirstEdge(theGraph, v);
     while (gp_IsEdge(theGraph, e))
     {
-        gp_SetNeighbor(theGraph, gp_GetTwin(theGraph, e), u);
+        _SetEdgeRecordOwner(theGraph, e, u);
         e = gp_GetNextEdge(theGraph, e);
     }
 
@@ -2816,7 +3810,7 @@ int _RestoreVertex(graphP theGraph)
         e = e_v_first;
         while (gp_IsEdge(theGraph, e))
         {
-            gp_SetNeighbor(theGraph, gp_GetTwin(theGraph, e), v);
+            _SetEdgeRecordOwner(theGraph, e, v);
             e = (e == e_v_last ? NIL : gp_GetNextEdge(theGraph, e));
         }
     }
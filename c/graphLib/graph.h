@@ -33,6 +33,13 @@ extern "C"
 
     void gp_Free(graphP *pGraph);
 
+    // The number of bytes of memory used by a graph, optionally broken down
+    // by part of the graph (see graphMemoryUsageStruct at the end of this file)
+    typedef struct graphMemoryUsageStruct graphMemoryUsageStruct;
+    typedef graphMemoryUsageStruct *graphMemoryUsageP;
+
+    size_t gp_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail);
+
 // N=# of vertices; NV=# of virtual vertices; M=# of edges
 #define gp_GetN(theGraph) ((theGraph)->N)
 #define gp_GetNV(theGraph) ((theGraph)->NV)
@@ -41,12 +48,18 @@ extern "C"
 
     // Basic graph utility methods
     int gp_CopyGraph(graphP dstGraph, graphP srcGraph);
+    int gp_CopyGraphInUse(graphP dstGraph, graphP srcGraph);
     graphP gp_DupGraph(graphP theGraph);
     int gp_CopyAdjacencyLists(graphP dstGraph, graphP srcGraph);
 
     int gp_CreateRandomGraph(graphP theGraph);
     int gp_CreateRandomGraphEx(graphP theGraph, int numEdges);
 
+    // The random graph generators use the graph's random number generator,
+    // if one has been set, or else the calling thread's default generator
+    void gp_SetRandomGenerator(graphP theGraph, randomGeneratorP theGenerator);
+    randomGeneratorP gp_GetRandomGenerator(graphP theGraph);
+
     // Basic graph I/O methods: see graphIO.h
     // Intermediate graph I/O methods: see g6-read-iterator.h and g6-write-iterator.h
 
@@ -62,14 +75,23 @@ extern "C"
     int gp_GetVertexInDegree(graphP theGraph, int v);
     int gp_GetVertexOutDegree(graphP theGraph, int v);
 
+    // Optional edge index that maintains vertex degrees and hashes the edge
+    // records so that gp_IsNeighbor(), gp_FindEdge(), gp_GetVertexDegree()
+    // and the directed neighbor methods take constant expected time
+    int gp_EnableEdgeIndex(graphP theGraph);
+    void gp_DisableEdgeIndex(graphP theGraph);
+    int gp_IsEdgeIndexEnabled(graphP theGraph);
+
     // Basic graph structure manipulators
     int gp_AddEdge(graphP theGraph, int u, int ulink, int v, int vlink);
     int gp_DynamicAddEdge(graphP theGraph, int u, int ulink, int v, int vlink);
+    int gp_AddEdgesBulk(graphP theGraph, const int *u, const int *v, int count, unsigned flags);
     int gp_InsertEdge(graphP theGraph, int u, int e_u, int e_ulink,
                       int v, int e_v, int e_vlink);
     int gp_DynamicInsertEdge(graphP theGraph, int u, int e_u, int e_ulink,
                              int v, int e_v, int e_vlink);
     int gp_DeleteEdge(graphP theGraph, int e);
+    int gp_CompactEdgeStorage(graphP theGraph, int *oldToNewMap);
     int gp_ClearEdgeDirectionFlags(graphP theGraph);
     int gp_TransposeDirectedGraph(graphP theGraph);
 
@@ -125,7 +147,7 @@ extern "C"
             DFS children of the vertex).
 
      flags: Bits 0-15 reserved for library; bits 16 and higher for apps
-            Bit 0: visited, for vertices and virtual vertices
+            Bit 0: reserved (visited flag is kept in vertexVisitStamps)
             Bit 1: marked, 2nd visited flag, for while visiting all
                     Used in K4 homeomorph search algorithm
             Bit 2: Obstruction type VERTEX_TYPE_SET (versus not set, i.e. VERTEX_TYPE_UNKNOWN)
@@ -136,9 +158,9 @@ extern "C"
 
     struct vertexRec
     {
-        int link[2];
-        int index;
-        unsigned flags;
+        GP_INDEX_T link[2];
+        GP_INDEX_T index;
+        GP_FLAGS_T flags;
     };
 
     typedef struct vertexRec vertexRec;
@@ -230,14 +252,16 @@ extern "C"
 #define gp_GetIndex(theGraph, v) (theGraph->V[v].index)
 #define gp_SetIndex(theGraph, v, theIndex) (theGraph->V[v].index = theIndex)
 
-// Initializer for non-virtual and virtual vertex flags
-#define gp_InitFlags(theGraph, v) (theGraph->V[v].flags = 0)
+// Initializer for non-virtual and virtual vertex flags (and visited stamp)
+#define gp_InitFlags(theGraph, v) (theGraph->V[v].flags = 0, theGraph->vertexVisitStamps[v] = 0)
 
-// Definition and accessors for the non-virtual and virtual vertex visited flag
-#define VERTEX_VISITED_MASK 1
-#define gp_GetVisited(theGraph, v) (theGraph->V[v].flags & VERTEX_VISITED_MASK)
-#define gp_ClearVisited(theGraph, v) (theGraph->V[v].flags &= ~VERTEX_VISITED_MASK)
-#define gp_SetVisited(theGraph, v) (theGraph->V[v].flags |= VERTEX_VISITED_MASK)
+// Accessors for the non-virtual and virtual vertex visited flag
+// A vertex is visited if its stamp equals the graph's current vertex visit
+// epoch, so _ClearVertexVisitedFlags() clears all of them by advancing the
+// epoch. The epoch is never 0, so a stamp of 0 always means 'not visited'.
+#define gp_GetVisited(theGraph, v) (theGraph->vertexVisitStamps[v] == theGraph->vertexVisitEpoch)
+#define gp_ClearVisited(theGraph, v) (theGraph->vertexVisitStamps[v] = 0)
+#define gp_SetVisited(theGraph, v) (theGraph->vertexVisitStamps[v] = theGraph->vertexVisitEpoch)
 
 // Definition and accessors for the non-virtual and virtual vertex marked flag
 // Essentially, this is a second visitation flag that can help applications that
@@ -261,7 +285,7 @@ extern "C"
         this edge record (an index into array V).
 
      flags: Bits 0-15 reserved for library; bits 16 and higher for apps
-            Bit 0: Visited
+            Bit 0: Reserved (visited flag is kept in edgeVisitStamps)
             Bit 1: Marked (2nd visited flag, for while visiting all)
             Bit 2: DFS type has been set, versus not set
             Bit 3: DFS tree edge, versus cycle edge (co-tree edge, etc.)
@@ -273,9 +297,9 @@ extern "C"
 
     struct edgeRec
     {
-        int link[2];
-        int neighbor;
-        unsigned flags;
+        GP_INDEX_T link[2];
+        GP_INDEX_T neighbor;
+        GP_FLAGS_T flags;
     };
 
     typedef struct edgeRec edgeRec;
@@ -313,14 +337,16 @@ extern "C"
 #define gp_GetNeighbor(theGraph, e) (theGraph->E[e].neighbor)
 #define gp_SetNeighbor(theGraph, e, v) (theGraph->E[e].neighbor = v)
 
-// Initializer for edge flags
-#define gp_InitEdgeFlags(theGraph, e) (theGraph->E[e].flags = 0)
+// Initializer for edge flags (and visited stamp)
+#define gp_InitEdgeFlags(theGraph, e) (theGraph->E[e].flags = 0, theGraph->edgeVisitStamps[e] = 0)
+
+// Accessors for the edge visited flag, which is stamp-based in the same
+// way as the vertex visited flag (see gp_GetVisited())
+#define gp_GetEdgeVisited(theGraph, e) (theGraph->edgeVisitStamps[e] == theGraph->edgeVisitEpoch)
+#define gp_ClearEdgeVisited(theGraph, e) (theGraph->edgeVisitStamps[e] = 0)
+#define gp_SetEdgeVisited(theGraph, e) (theGraph->edgeVisitStamps[e] = theGraph->edgeVisitEpoch)
 
 // Definitions of and access to edge flags
-#define EDGE_VISITED_MASK 1
-#define gp_GetEdgeVisited(theGraph, e) (theGraph->E[e].flags & EDGE_VISITED_MASK)
-#define gp_ClearEdgeVisited(theGraph, e) (theGraph->E[e].flags &= ~EDGE_VISITED_MASK)
-#define gp_SetEdgeVisited(theGraph, e) (theGraph->E[e].flags |= EDGE_VISITED_MASK)
 
 // Definition and accessors for the edge marked flag
 // Essentially, this is a second visitation flag that can help applications that
@@ -446,6 +472,11 @@ extern "C"
 // calling gp_EnsureEdgeCapacity(), gp_DynamicAddEdge(), or gp_DynamicInsertEdge().
 #define AT_EDGE_CAPACITY_LIMIT -1
 
+// Flags for gp_AddEdgesBulk() that omit loops and edges whose endpoints are
+// already adjacent (including by an edge added earlier in the same call)
+#define ADDEDGES_SKIPLOOPS 1
+#define ADDEDGES_SKIPDUPLICATES 2
+
 // A bounds-checking version of gp_IsEdge() for DEBUG mode compilation
 #ifdef DEBUG
 #undef gp_IsEdge
@@ -483,6 +514,12 @@ extern "C"
                 edgeHoles: free locations in E where edges have been deleted
                 numEdgeHoles: package private member indicating the number of edge holes.
 
+                vertexVisitStamps, edgeVisitStamps: arrays parallel to V and E
+                    whose entries record the epoch in which a vertex or edge
+                    record was last marked visited
+                vertexVisitEpoch, edgeVisitEpoch: the current visit epochs; all
+                    visited flags of a kind are cleared by advancing its epoch
+
                 graphFlags: Additional state information about the graph
                 embedFlags: records the type of embedding requested (uses EMBEDFLAGS)
 
@@ -510,6 +547,9 @@ extern "C"
         stackP edgeHoles;
         int numEdgeHoles;
 
+        GP_FLAGS_T *vertexVisitStamps, *edgeVisitStamps;
+        GP_FLAGS_T vertexVisitEpoch, edgeVisitEpoch;
+
         unsigned graphFlags, embedFlags;
 
         // Used by base Graph class and its subclasses
@@ -527,6 +567,34 @@ extern "C"
     typedef struct graphStruct graphStruct;
     typedef graphStruct *graphP;
 
+    /********************************************************************
+     Graph memory usage report, in bytes (see gp_GetMemoryUsage())
+        graph: the graph record, its function table, private data and
+               extension records
+        base: the vertex and edge records, visited stamps, edge holes
+              and stack
+        DFSUtils: the DFSUtils vertex infos and bicomp root lists
+        planarity: the Planarity vertex infos, external face records,
+                   isolator context and sorted DFS child lists
+        extensions: the total for the contexts of the graph extensions,
+                    each of which is also reported by moduleID in the
+                    first numExtensions entries of extension[]
+     ********************************************************************/
+
+#define GP_MEMORYUSAGE_MAXEXTENSIONS 32
+
+    struct graphMemoryUsageStruct
+    {
+        size_t graph, base, DFSUtils, planarity, extensions;
+
+        int numExtensions;
+        struct
+        {
+            int moduleID;
+            size_t bytes;
+        } extension[GP_MEMORYUSAGE_MAXEXTENSIONS];
+    };
+
 #ifdef __cplusplus
 }
 #endif
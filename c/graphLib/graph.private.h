@@ -64,9 +64,32 @@ extern "C"
                 lists of each vertex
         extFace: For Planarity graphs, an array of (N + NV) external face
                 short circuit records
+        randomGenerator: caller-owned random number generator used by the
+                random graph generators, or NULL to use the thread default
+        storage, storageSize: the single block of memory from which V, E,
+                the visited stamps, DVI, PVI, extFace and IC are carved
+                (see _AllocateGraphStorage() in graph.c)
+        vertexDegree, edgeIndex: NULL unless gp_EnableEdgeIndex() was called,
+                in which case they hold the degree of every vertex and an
+                open addressing hash table of the edge records in use, with
+                edgeIndexSize slots of which edgeIndexCount are occupied
+        edgeDependentGraphFlags: the graph flags that an extension has
+                registered as describing the current edges, e.g. that they
+                form an embedding, which are cleared from graphFlags whenever
+                an edge record is attached, detached or restored
      ********************************************************************/
     struct graphPrivateDataStruct
     {
+        // Private data members of the base Graph class
+        randomGeneratorP randomGenerator;
+        void *storage;
+        size_t storageSize;
+        GP_INDEX_T *vertexDegree;
+        GP_INDEX_T *edgeIndex;
+        int edgeIndexSize;
+        int edgeIndexCount;
+        unsigned edgeDependentGraphFlags;
+
         // Private Data members specific to a DFSUtilsGraph subclass
         listCollectionP BicompRootLists;
         DFSUtils_VertexInfoP DVI;
@@ -93,6 +116,18 @@ extern "C"
 #define theGraphExtFace(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->extFace)
 #define theGraphIC(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->IC)
 
+#define theGraphRandomGenerator(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->randomGenerator)
+#define theGraphStorage(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->storage)
+#define theGraphStorageSize(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->storageSize)
+#define theGraphVertexDegree(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->vertexDegree)
+#define theGraphEdgeIndex(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->edgeIndex)
+#define theGraphEdgeIndexSize(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->edgeIndexSize)
+#define theGraphEdgeIndexCount(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->edgeIndexCount)
+#define theGraphEdgeDependentGraphFlags(theGraph) (((graphPrivateDataP)((theGraph)->privateData))->edgeDependentGraphFlags)
+
+#define _ClearEdgeDependentGraphFlags(theGraph) \
+    ((theGraph)->graphFlags &= ~theGraphEdgeDependentGraphFlags(theGraph))
+
 /********************************************************************
  Additional edge link accessors and manipulators
  ********************************************************************/
@@ -0,0 +1,441 @@
+/*
+Copyright (c) 1997-2026, John M. Boyer
+All rights reserved.
+See the LICENSE.TXT file for licensing information.
+*/
+
+#include "graphCSR.h"
+#include "io/graphIO.h"
+#include "io/strOrFile.h"
+
+#include <stdlib.h>
+
+// Imported methods
+extern int _WriteGraphMLStartTag(strOrFileP outputContainer);
+extern int _WriteGraphMLEndTag(strOrFileP outputContainer);
+
+// Private functions
+int _CSRWrite(gpCSR *theCSR, strOrFileP outputContainer, int Mode);
+int _CSRWriteAdjList(gpCSR *theCSR, strOrFileP outputContainer);
+int _CSRWriteGraphML(gpCSR *theCSR, strOrFileP outputContainer);
+
+/********************************************************************
+ gp_BuildCSR()
+
+ Fills theCSR with a compressed sparse row snapshot of theGraph (see
+ graphCSR.h). The arrays of theCSR are allocated by this method and
+ are released by gp_FreeCSR(), which must also be called before
+ reusing theCSR for another snapshot.
+
+ The graph must not have edges incident to virtual vertices, which is
+ the case for a graph that has been read or created, and for the
+ result of gp_Embed().
+
+ Returns OK on success, NOTOK on failure.
+ ********************************************************************/
+
+int gp_BuildCSR(graphP theGraph, gpCSR *theCSR)
+{
+    int *arcOfEdge = NULL;
+    int numArcs, a, v, e;
+
+    if (theGraph == NULL || theCSR == NULL || gp_GetN(theGraph) <= 0)
+        return NOTOK;
+
+    memset(theCSR, 0, sizeof(gpCSR));
+
+    theCSR->N = gp_GetN(theGraph);
+    theCSR->M = gp_GetM(theGraph);
+    theCSR->lowerBound = gp_LowerBoundVertices(theGraph);
+    theCSR->zeroBasedIO = gp_GetGraphFlags(theGraph) & GRAPHFLAGS_ZEROBASEDIO ? TRUE : FALSE;
+
+    numArcs = 2 * theCSR->M;
+
+    // The arc arrays get at least one entry so that an edgeless graph
+    // is not confused with an allocation failure
+    if ((theCSR->offset = (int *)gp_MemAlloc((gp_UpperBoundVertices(theGraph) + 1) * sizeof(int))) == NULL ||
+        (theCSR->neighbor = (int *)gp_MemAlloc((numArcs + 1) * sizeof(int))) == NULL ||
+        (theCSR->twin = (int *)gp_MemAlloc((numArcs + 1) * sizeof(int))) == NULL ||
+        (theCSR->edgeId = (int *)gp_MemAlloc((numArcs + 1) * sizeof(int))) == NULL ||
+        (theCSR->direction = (unsigned char *)gp_MemAlloc((numArcs + 1) * sizeof(unsigned char))) == NULL ||
+        (arcOfEdge = (int *)gp_MemAlloc(gp_UpperBoundEdges(theGraph) * sizeof(int))) == NULL)
+    {
+        gp_MemFree(arcOfEdge);
+        gp_FreeCSR(theCSR);
+        return NOTOK;
+    }
+
+    // Copy each adjacency list into the next run of arcs, recording the
+    // arc of each edge record so the twin arcs can be resolved below
+    a = 0;
+    for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+    {
+        theCSR->offset[v] = a;
+
+        e = gp_GetFirstEdge(theGraph, v);
+        while (gp_IsEdge(theGraph, e))
+        {
+            if (a >= numArcs || gp_IsVirtualVertex(theGraph, gp_GetNeighbor(theGraph, e)))
+            {
+                gp_MemFree(arcOfEdge);
+                gp_FreeCSR(theCSR);
+                return NOTOK;
+            }
+
+            theCSR->neighbor[a] = gp_GetNeighbor(theGraph, e);
+            theCSR->edgeId[a] = e;
+            theCSR->direction[a] = (unsigned char)gp_GetDirection(theGraph, e);
+            arcOfEdge[e] = a++;
+
+            e = gp_GetNextEdge(theGraph, e);
+        }
+    }
+    theCSR->offset[gp_UpperBoundVertices(theGraph)] = a;
+
+    if (a != numArcs)
+    {
+        gp_MemFree(arcOfEdge);
+        gp_FreeCSR(theCSR);
+        return NOTOK;
+    }
+
+    for (a = 0; a < numArcs; ++a)
+        theCSR->twin[a] = arcOfEdge[gp_GetTwin(theGraph, theCSR->edgeId[a])];
+
+    gp_MemFree(arcOfEdge);
+    return OK;
+}
+
+/********************************************************************
+ gp_FreeCSR()
+
+ Releases the arrays of theCSR (but not theCSR itself, which is
+ typically a local variable of the caller).
+ ********************************************************************/
+
+void gp_FreeCSR(gpCSR *theCSR)
+{
+    if (theCSR == NULL)
+        return;
+
+    if (theCSR->offset != NULL)
+        gp_MemFree(theCSR->offset);
+    if (theCSR->neighbor != NULL)
+        gp_MemFree(theCSR->neighbor);
+    if (theCSR->twin != NULL)
+        gp_MemFree(theCSR->twin);
+    if (theCSR->edgeId != NULL)
+        gp_MemFree(theCSR->edgeId);
+    if (theCSR->direction != NULL)
+        gp_MemFree(theCSR->direction);
+
+    memset(theCSR, 0, sizeof(gpCSR));
+}
+
+/********************************************************************
+ gp_CSRCountEmbeddingFaces()
+
+ The CSR analog of gp_CountEmbeddingFaces() for a snapshot of a graph
+ containing a planar embedding. The arcs are scanned in order, and
+ each arc not yet on a traversed face starts the traversal of a new
+ face. The connected components are counted by a breadth-first search
+ of the snapshot, so unlike gp_CountEmbeddingFaces(), a DFS numbering
+ is not needed.
+
+ Returns the number of faces if the count agrees with the extended
+ Euler formula, or -1 on error.
+ ********************************************************************/
+
+int gp_CSRCountEmbeddingFaces(gpCSR *theCSR)
+{
+    unsigned char *arcVisited = NULL, *vertexVisited = NULL;
+    int *queue = NULL;
+    int numArcs, numCycles = 0, numComponents = 0, numFaces = -1;
+    int a, aNext, v, w, qHead, qTail;
+
+    if (theCSR == NULL || theCSR->offset == NULL)
+        return -1;
+
+    numArcs = 2 * theCSR->M;
+
+    if ((arcVisited = (unsigned char *)gp_MemCalloc(numArcs + 1, sizeof(unsigned char))) == NULL ||
+        (vertexVisited = (unsigned char *)gp_MemCalloc(gp_CSRUpperBoundVertices(theCSR), sizeof(unsigned char))) == NULL ||
+        (queue = (int *)gp_MemAlloc(theCSR->N * sizeof(int))) == NULL)
+        goto gp_CSRCountEmbeddingFaces_Cleanup;
+
+    // Traverse each face once, starting from its lowest numbered arc
+    for (a = 0; a < numArcs; ++a)
+    {
+        if (arcVisited[a])
+            continue;
+
+        aNext = a;
+        do
+        {
+            aNext = gp_CSRGetNextFaceArc(theCSR, aNext);
+            if (arcVisited[aNext])
+                goto gp_CSRCountEmbeddingFaces_Cleanup;
+
+            arcVisited[aNext] = TRUE;
+        } while (aNext != a);
+
+        numCycles++;
+    }
+
+    // The traversal counts an outer face for each connected component
+    // with an edge, but the extended Euler formula counts one outer face
+    // shared by all components, which is added back after this loop
+    for (v = gp_CSRLowerBoundVertices(theCSR); v < gp_CSRUpperBoundVertices(theCSR); ++v)
+    {
+        if (vertexVisited[v])
+            continue;
+
+        numComponents++;
+        if (gp_CSRGetDegree(theCSR, v) > 0)
+            numCycles--;
+
+        vertexVisited[v] = TRUE;
+        qHead = qTail = 0;
+        queue[qTail++] = v;
+        while (qHead < qTail)
+        {
+            w = queue[qHead++];
+            for (a = gp_CSRGetFirstArc(theCSR, w); a < gp_CSRGetEndArc(theCSR, w); ++a)
+            {
+                if (!vertexVisited[theCSR->neighbor[a]])
+                {
+                    vertexVisited[theCSR->neighbor[a]] = TRUE;
+                    queue[qTail++] = theCSR->neighbor[a];
+                }
+            }
+        }
+    }
+
+    numCycles++;
+
+    numFaces = numCycles == theCSR->M - theCSR->N + 1 + numComponents ? numCycles : -1;
+
+gp_CSRCountEmbeddingFaces_Cleanup:
+
+    if (queue != NULL)
+        gp_MemFree(queue);
+    if (vertexVisited != NULL)
+        gp_MemFree(vertexVisited);
+    if (arcVisited != NULL)
+        gp_MemFree(arcVisited);
+
+    return numFaces;
+}
+
+/********************************************************************
+ gp_CSRWrite()
+
+ The CSR analog of gp_Write(). Pass WRITE_ADJLIST or WRITE_GRAPHML for
+ writeMode. The adjacency list output is the same as gp_Write() gives
+ for the graph from which the snapshot was built, except that no
+ extension data is appended. The GraphML output numbers the edges in
+ the order of their first arcs, rather than by edge record location.
+
+ Returns NOTOK on error, OK on success.
+ ********************************************************************/
+
+int gp_CSRWrite(gpCSR *theCSR, char const *fileName, int writeMode)
+{
+    int RetVal = OK;
+    strOrFileP outputContainer = NULL;
+
+    if (theCSR == NULL || fileName == NULL || strlen(fileName) == 0)
+        return NOTOK;
+
+    if (strcmp(fileName, "nullwrite") == 0)
+        return OK;
+
+    if ((outputContainer = sf_NewOutputContainer(NULL, fileName)) == NULL)
+        return NOTOK;
+
+    RetVal = _CSRWrite(theCSR, outputContainer, writeMode);
+
+    sf_Free(&outputContainer);
+
+    return RetVal;
+}
+
+/********************************************************************
+ gp_CSRWriteToString()
+
+ The CSR analog of gp_WriteToString(), with writeMode as for
+ gp_CSRWrite().
+
+ Returns NOTOK on error, or OK on success along with an allocated string
+         *pOutputStr that the caller must gp_MemFree()
+ ********************************************************************/
+
+int gp_CSRWriteToString(gpCSR *theCSR, char **pOutputStr, int writeMode)
+{
+    int RetVal = OK;
+    strOrFileP outputContainer = NULL;
+
+    if (theCSR == NULL || pOutputStr == NULL || (*pOutputStr) != NULL)
+        return NOTOK;
+
+    if ((outputContainer = sf_NewOutputContainer(pOutputStr, NULL)) == NULL)
+        return NOTOK;
+
+    RetVal = _CSRWrite(theCSR, outputContainer, writeMode);
+
+    sf_Free(&outputContainer);
+
+    if ((*pOutputStr) == NULL)
+        RetVal = NOTOK;
+    else if (strlen(*pOutputStr) == 0)
+    {
+        gp_MemFree((*pOutputStr));
+        (*pOutputStr) = NULL;
+        RetVal = NOTOK;
+    }
+
+    return RetVal;
+}
+
+/********************************************************************
+ _CSRWrite()
+ ********************************************************************/
+
+int _CSRWrite(gpCSR *theCSR, strOrFileP outputContainer, int Mode)
+{
+    int RetVal = NOTOK;
+
+    if (theCSR->offset == NULL)
+        RetVal = NOTOK;
+    else if (Mode == WRITE_ADJLIST)
+        RetVal = _CSRWriteAdjList(theCSR, outputContainer);
+    else if (Mode == WRITE_GRAPHML)
+        RetVal = _CSRWriteGraphML(theCSR, outputContainer);
+
+    if (RetVal != OK)
+        sf_SetOutputErrorFlag(outputContainer);
+
+    return RetVal;
+}
+
+/********************************************************************
+ _CSRWriteAdjList()
+
+ Writes the same format as _WriteAdjList(), including its order of
+ each adjacency list from last to first edge record.
+ ********************************************************************/
+
+int _CSRWriteAdjList(gpCSR *theCSR, strOrFileP outputContainer)
+{
+    int v, a;
+    int zeroBasedVertexOffset = 0, adjacencyListTerminator = NIL;
+
+    if (sf_fputs("N=", outputContainer) == EOF ||
+        sf_WriteInteger(theCSR->N, outputContainer) != OK ||
+        sf_fputs("\n", outputContainer) == EOF)
+        return NOTOK;
+
+    // See _WriteAdjList() regarding 0-based output of a 1-based graph
+    if (theCSR->zeroBasedIO)
+    {
+        zeroBasedVertexOffset = gp_CSRLowerBoundVertices(theCSR);
+        adjacencyListTerminator = -1;
+    }
+
+    for (v = gp_CSRLowerBoundVertices(theCSR); v < gp_CSRUpperBoundVertices(theCSR); ++v)
+    {
+        if (sf_WriteInteger(v - zeroBasedVertexOffset, outputContainer) != OK ||
+            sf_fputs(":", outputContainer) == EOF)
+            return NOTOK;
+
+        for (a = gp_CSRGetEndArc(theCSR, v) - 1; a >= gp_CSRGetFirstArc(theCSR, v); --a)
+        {
+            if (theCSR->direction[a] != EDGEFLAG_DIRECTION_INONLY)
+            {
+                if (sf_fputs(" ", outputContainer) == EOF ||
+                    sf_WriteInteger(theCSR->neighbor[a] - zeroBasedVertexOffset, outputContainer) != OK)
+                    return NOTOK;
+            }
+        }
+
+        if (sf_fputs(" ", outputContainer) == EOF ||
+            sf_WriteInteger(adjacencyListTerminator, outputContainer) != OK ||
+            sf_fputs("\n", outputContainer) == EOF)
+            return NOTOK;
+    }
+
+    return OK;
+}
+
+/********************************************************************
+ _CSRWriteGraphML()
+
+ Writes the same GraphML document as _WriteGraphMLGraph(), except for
+ the order and hence the numbering of the edge elements.
+ ********************************************************************/
+
+int _CSRWriteGraphML(gpCSR *theCSR, strOrFileP outputContainer)
+{
+    int v, a, sourceArc, sourceVertex, targetVertex;
+    int zeroBasedVertexOffset = 0, edgeID = 1;
+
+    if (theCSR->zeroBasedIO)
+        zeroBasedVertexOffset = gp_CSRLowerBoundVertices(theCSR);
+
+    if (_WriteGraphMLStartTag(outputContainer) != OK ||
+        sf_fputs("  <graph id=\"G1\" edgedefault=\"undirected\">\n", outputContainer) == EOF)
+        return NOTOK;
+
+    for (v = gp_CSRLowerBoundVertices(theCSR); v < gp_CSRUpperBoundVertices(theCSR); ++v)
+    {
+        if (sf_fputs("    <node id=\"n", outputContainer) == EOF ||
+            sf_WriteInteger(v - zeroBasedVertexOffset, outputContainer) != OK ||
+            sf_fputs("\"/>\n", outputContainer) == EOF)
+            return NOTOK;
+    }
+
+    // Each edge is written when its first arc is reached, and as for
+    // _WriteGraphMLGraphEdges(), the source is the tail of the edge if
+    // it is directed
+    for (v = gp_CSRLowerBoundVertices(theCSR); v < gp_CSRUpperBoundVertices(theCSR); ++v)
+    {
+        for (a = gp_CSRGetFirstArc(theCSR, v); a < gp_CSRGetEndArc(theCSR, v); ++a)
+        {
+            if (theCSR->twin[a] < a)
+                continue;
+
+            sourceArc = a;
+            sourceVertex = v;
+            targetVertex = theCSR->neighbor[a];
+            if (theCSR->direction[a] == EDGEFLAG_DIRECTION_INONLY)
+            {
+                sourceArc = theCSR->twin[a];
+                sourceVertex = theCSR->neighbor[a];
+                targetVertex = v;
+            }
+
+            if (sf_fputs("    <edge id=\"e", outputContainer) == EOF ||
+                sf_WriteInteger(edgeID, outputContainer) != OK ||
+                sf_fputs("\" source=\"n", outputContainer) == EOF ||
+                sf_WriteInteger(sourceVertex - zeroBasedVertexOffset, outputContainer) != OK ||
+                sf_fputs("\" target=\"n", outputContainer) == EOF ||
+                sf_WriteInteger(targetVertex - zeroBasedVertexOffset, outputContainer) != OK)
+                return NOTOK;
+
+            if (theCSR->direction[sourceArc] != 0 &&
+                sf_fputs("\" directed=\"true", outputContainer) == EOF)
+                return NOTOK;
+
+            if (sf_fputs("\"/>\n", outputContainer) == EOF)
+                return NOTOK;
+
+            edgeID++;
+        }
+    }
+
+    if (sf_fputs("  </graph>\n", outputContainer) == EOF ||
+        _WriteGraphMLEndTag(outputContainer) != OK)
+        return NOTOK;
+
+    return OK;
+}
@@ -0,0 +1,88 @@
+/*
+Copyright (c) 1997-2026, John M. Boyer
+All rights reserved.
+See the LICENSE.TXT file for licensing information.
+*/
+
+#ifndef GRAPHCSR_H
+#define GRAPHCSR_H
+
+#include "graph.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /********************************************************************
+     Compressed sparse row (CSR) snapshot of a graph
+
+     A CSR snapshot stores the adjacency lists of a graph in contiguous
+     arrays, so that read-only passes over a large graph, such as face
+     traversal of an embedding or writing the graph, scan memory
+     sequentially instead of chasing links through the edge records.
+     The snapshot is immutable; it does not reflect changes made to the
+     graph after it was built.
+
+     Each edge record of the graph becomes an 'arc' of the snapshot.
+     The arcs of vertex v are stored at positions offset[v] through
+     offset[v+1]-1, in the same order as the adjacency list of v, so
+     the rotation order of a planar embedding is preserved.
+
+        N, M: the number of vertices and edges of the graph
+        lowerBound: gp_LowerBoundVertices() of the graph; vertices keep
+                    the same numbers they have in the graph, and offset
+                    has entries for positions lowerBound to lowerBound+N
+        zeroBasedIO: TRUE if the graph had GRAPHFLAGS_ZEROBASEDIO set
+
+        offset: the position of the first arc of each vertex
+        neighbor: the vertex to which each arc leads
+        twin: the position of the arc for the same edge in the other direction
+        edgeId: the location in the graph's edge record array E of each arc
+        direction: the EDGEFLAG_DIRECTION_* flags of each arc's edge record
+     ********************************************************************/
+
+    typedef struct
+    {
+        int N, M;
+        int lowerBound;
+        int zeroBasedIO;
+
+        int *offset;
+        int *neighbor;
+        int *twin;
+        int *edgeId;
+        unsigned char *direction;
+    } gpCSR;
+
+    int gp_BuildCSR(graphP theGraph, gpCSR *theCSR);
+    void gp_FreeCSR(gpCSR *theCSR);
+
+// Vertex iteration bounds, which are the same as those of the graph
+#define gp_CSRLowerBoundVertices(theCSR) ((theCSR)->lowerBound)
+#define gp_CSRUpperBoundVertices(theCSR) ((theCSR)->lowerBound + (theCSR)->N)
+
+// Arc iteration for vertex v and constant time degree query
+#define gp_CSRGetFirstArc(theCSR, v) ((theCSR)->offset[v])
+#define gp_CSRGetEndArc(theCSR, v) ((theCSR)->offset[(v) + 1])
+#define gp_CSRGetDegree(theCSR, v) ((theCSR)->offset[(v) + 1] - (theCSR)->offset[v])
+
+// Analog of gp_GetNextEdgeCircular() for the arcs of vertex v
+#define gp_CSRGetNextArcCircular(theCSR, v, a) \
+    ((a) + 1 < gp_CSRGetEndArc(theCSR, v) ? (a) + 1 : gp_CSRGetFirstArc(theCSR, v))
+
+// The face traversal successor of arc a, i.e. the arc that follows the
+// twin of a in the rotation of the vertex to which a leads
+#define gp_CSRGetNextFaceArc(theCSR, a) \
+    gp_CSRGetNextArcCircular(theCSR, (theCSR)->neighbor[a], (theCSR)->twin[a])
+
+    int gp_CSRCountEmbeddingFaces(gpCSR *theCSR);
+
+    int gp_CSRWrite(gpCSR *theCSR, char const *fileName, int writeMode);
+    int gp_CSRWriteToString(gpCSR *theCSR, char **pOutputStr, int writeMode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GRAPHCSR_H */
@@ -19,7 +19,7 @@ See the LICENSE.TXT file for licensing information.
 int _SortVertices(graphP theGraph);
 
 // Imported methods
-extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+extern void _ClearVertexVisitedFlags(graphP theGraph);
 
 /********************************************************************
  gp_ExtendWith_DFSUtils()
@@ -131,7 +131,7 @@ int gp_DepthFirstSearch(graphP theGraph)
 
     /* Clear the visited flags because they are used to detect what has
         been visited as the DFS traverses the graph. */
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     /* This outer loop causes the connected subgraphs of a disconnected
             graph to be numbered */
@@ -213,6 +213,9 @@ int gp_SortVertices(graphP theGraph)
     if (gp_ExtendWith_DFSUtils(theGraph) != OK)
         return NOTOK;
 
+    // Renumbering the vertices changes the keys of the edge index, if any
+    gp_DisableEdgeIndex(theGraph);
+
     return theGraph->functions->fpSortVertices(theGraph);
 }
 
@@ -258,6 +261,24 @@ int _SortVertices(graphP theGraph)
 
     _gp_LogLine("\ngraphDFSUtils.c/_SortVertices() start");
 
+    // If each vertex is already at the position given by its index, e.g. if
+    // the DFS visited the vertices in order, then the sort only needs to
+    // invert the bit that records the sort order of the graph, as the
+    // relabeling of the edges and DFS parents would not change them
+    for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+        if (gp_GetIndex(theGraph, v) != v)
+            break;
+
+    if (v == gp_UpperBoundVertices(theGraph))
+    {
+        theGraph->graphFlags &= ~GRAPHFLAGS_LOWPOINTSCOMPUTED;
+        theGraph->graphFlags ^= GRAPHFLAGS_SORTEDBYDFI;
+
+        _gp_LogLine("graphDFSUtils.c/_SortVertices() end\n");
+
+        return OK;
+    }
+
     /* Change labels of edges from v to DFI(v)-- or vice versa
        Also, if any links go back to locations 0 to n-1, then they
        need to be changed because we are reordering the vertices */
@@ -297,7 +318,7 @@ int _SortVertices(graphP theGraph)
        location, so we cannot use index==v as a test for whether the
        correct vertex is in location 'index'. */
 
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     /* We visit each vertex location, skipping those marked as visited since
        we've already moved the correct vertex into that location. The
@@ -399,7 +420,7 @@ int gp_ComputeLowpoints(graphP theGraph)
 
     sp_ClearStack(theStack);
 
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     // This outer loop causes the connected subgraphs of a disconnected graph to be processed
     for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph);)
@@ -682,3 +703,67 @@ int gp_GetLowpoint(graphP theGraph, int v)
 
     return gp_GetVertexLowpoint(theGraph, v);
 }
+
+/********************************************************************
+ gp_GetOriginalVertexIndex()
+
+ Returns the position that the vertex at position v had before the
+ graph was sorted by DFI, or v if the graph is not sorted by DFI.
+ Since gp_SortVertices() stores this in the index of each vertex, a
+ caller can work with a graph left in DFI order, e.g. by gp_Embed(),
+ without sorting it back into its original order, which relabels
+ every vertex and edge record.
+ Returns NIL on error, such as invalid parameters.
+ ********************************************************************/
+int gp_GetOriginalVertexIndex(graphP theGraph, int v)
+{
+    if (theGraph == NULL ||
+        v < gp_LowerBoundVertices(theGraph) || v >= gp_UpperBoundVertices(theGraph))
+    {
+#ifdef DEBUG
+        NOTOK;
+        ;
+#endif
+        return NIL;
+    }
+
+    if (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI)
+        return gp_GetIndex(theGraph, v);
+
+    return v;
+}
+
+/********************************************************************
+ gp_GetDFIOfOriginal()
+
+ Once the DFS tree has been created in theGraph, this method fills
+ dfiOfOriginal, which must have gp_UpperBoundVertices(theGraph)
+ elements, so that dfiOfOriginal[u] is the DFI of the vertex whose
+ original position is u. This is the inverse of the permutation given
+ by gp_GetOriginalVertexIndex() when the graph is sorted by DFI, and
+ it is obtained in one pass over the vertices, whether or not the
+ graph is sorted by DFI.
+ Returns OK on success, NOTOK on error, such as a NULL parameter or
+ DFS tree not created yet.
+ ********************************************************************/
+int gp_GetDFIOfOriginal(graphP theGraph, int *dfiOfOriginal)
+{
+    int v;
+
+    if (theGraph == NULL || dfiOfOriginal == NULL ||
+        !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_DFSNUMBERED))
+        return NOTOK;
+
+    if (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI)
+    {
+        for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+            dfiOfOriginal[gp_GetIndex(theGraph, v)] = v;
+    }
+    else
+    {
+        for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+            dfiOfOriginal[v] = gp_GetIndex(theGraph, v);
+    }
+
+    return OK;
+}
@@ -54,6 +54,12 @@ extern "C"
         int gp_GetLeastAncestor(graphP theGraph, int v);
         int gp_GetLowpoint(graphP theGraph, int v);
 
+        // Methods that relate the vertex positions of a graph sorted by DFI,
+        // such as the result of gp_Embed(), to the original vertex positions,
+        // so that the graph need not be sorted back into its original order
+        int gp_GetOriginalVertexIndex(graphP theGraph, int v);
+        int gp_GetDFIOfOriginal(graphP theGraph, int *dfiOfOriginal);
+
 // A DFS tree root is one that has no DFS parent. There is one DFS tree root
 // per connected component of a graph (connected, not biconnected; component, not bicomp)
 #define gp_IsDFSTreeRoot(theGraph, v) gp_IsNotVertex(theGraph, gp_GetParent(theGraph, v))
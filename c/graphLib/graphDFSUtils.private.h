@@ -36,7 +36,7 @@ extern "C"
 
     struct DFSUtils_VertexInfo
     {
-        int parent, leastAncestor, lowpoint, visitedIndex;
+        GP_INDEX_T parent, leastAncestor, lowpoint, visitedIndex;
     };
 
     typedef struct DFSUtils_VertexInfo DFSUtils_VertexInfo;
@@ -32,6 +32,9 @@ extern "C"
 // Depth-first search public API methods and definitions
 #include "graphDFSUtils.h"
 
+// Compressed sparse row snapshot of a graph for read-only passes
+#include "graphCSR.h"
+
 // Planarity-specific public API methods and definitions
 #include "planarityRelated/graphPlanarity.h"
 
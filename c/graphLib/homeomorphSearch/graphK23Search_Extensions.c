@@ -25,6 +25,7 @@ int _K23Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R
 int _K23Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
 int _K23Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph);
 int _K23Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
+void _K23Search_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail);
 
 /* Forward declarations of functions used by the extension system */
 
@@ -67,7 +68,7 @@ int gp_ExtendWith_K23Search(graphP theGraph)
         return NOTOK;
 
     // Allocate a new extension context
-    context = (K23SearchContext *)malloc(sizeof(K23SearchContext));
+    context = (K23SearchContext *)gp_MemAlloc(sizeof(K23SearchContext));
     if (context == NULL)
     {
         return NOTOK;
@@ -82,6 +83,7 @@ int gp_ExtendWith_K23Search(graphP theGraph)
     context->functions.fpEmbedPostprocess = _K23Search_EmbedPostprocess;
     context->functions.fpCheckEmbeddingIntegrity = _K23Search_CheckEmbeddingIntegrity;
     context->functions.fpCheckObstructionIntegrity = _K23Search_CheckObstructionIntegrity;
+    context->functions.fpGetMemoryUsage = _K23Search_GetMemoryUsage;
 
     // Store the K23 search context, including the data structure and the
     // function pointers, as an extension of the graph
@@ -109,6 +111,25 @@ int gp_Detach_K23Search(graphP theGraph)
     return gp_RemoveExtension(theGraph, K23SEARCH_ID);
 }
 
+/********************************************************************
+ _K23Search_GetMemoryUsage()
+ ********************************************************************/
+
+void _K23Search_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail)
+{
+    K23SearchContext *context = NULL;
+    gp_FindExtension(theGraph, K23SEARCH_ID, (void *)&context);
+
+    if (context != NULL)
+    {
+        // Get the memory usage of the base class(es)
+        context->functions.fpGetMemoryUsage(theGraph, detail);
+
+        // The K2,3 search context has no parallel arrays
+        gp_AddExtensionMemoryUsage(detail, K23SEARCH_ID, sizeof(K23SearchContext));
+    }
+}
+
 /********************************************************************
  _K23Search_DupContext()
  ********************************************************************/
@@ -116,7 +137,7 @@ int gp_Detach_K23Search(graphP theGraph)
 void *_K23Search_DupContext(void *pContext, void *theGraph)
 {
     K23SearchContext *context = (K23SearchContext *)pContext;
-    K23SearchContext *newContext = (K23SearchContext *)malloc(sizeof(K23SearchContext));
+    K23SearchContext *newContext = (K23SearchContext *)gp_MemAlloc(sizeof(K23SearchContext));
 
     if (newContext != NULL)
     {
@@ -140,7 +161,7 @@ int _K23Search_CopyData(void *dstContext, void *srcContext)
 
 void _K23Search_FreeContext(void *pContext)
 {
-    free(pContext);
+    gp_MemFree(pContext);
 }
 
 /********************************************************************
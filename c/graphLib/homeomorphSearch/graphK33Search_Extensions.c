@@ -41,12 +41,14 @@ void _K33Search_MergeVertex(graphP theGraph, int W, int WPrevLink, int R);
 int _K33Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R);
 int _K33Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
 int _K33Search_DeleteEdge(graphP theGraph, int e);
+int _K33Search_CompactEdgeStorage(graphP theGraph, int *oldToNewMap);
 int _K33Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph);
 int _K33Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
 
 int _K33Search_EnsureVertexCapacity(graphP theGraph, int N);
 void _K33Search_ResetGraphStorage(graphP theGraph);
 int _K33Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity);
+void _K33Search_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail);
 
 /* Forward declarations of functions used by the extension system */
 
@@ -89,7 +91,7 @@ int gp_ExtendWith_K33Search(graphP theGraph)
         return NOTOK;
 
     // Allocate a new extension context
-    context = (K33SearchContext *)malloc(sizeof(K33SearchContext));
+    context = (K33SearchContext *)gp_MemAlloc(sizeof(K33SearchContext));
     if (context == NULL)
     {
         return NOTOK;
@@ -119,6 +121,8 @@ int gp_ExtendWith_K33Search(graphP theGraph)
     context->functions.fpResetGraphStorage = _K33Search_ResetGraphStorage;
     context->functions.fpEnsureEdgeCapacity = _K33Search_EnsureEdgeCapacity;
     context->functions.fpDeleteEdge = _K33Search_DeleteEdge;
+    context->functions.fpCompactEdgeStorage = _K33Search_CompactEdgeStorage;
+    context->functions.fpGetMemoryUsage = _K33Search_GetMemoryUsage;
 
     _K33Search_ClearStructures(context);
 
@@ -175,7 +179,7 @@ void _K33Search_ClearStructures(K33SearchContext *context)
     if (!context->initialized)
     {
         // Before initialization, the pointers are stray, not NULL
-        // Once NULL or allocated, free() or LCFree() can do the job
+        // Once NULL or allocated, gp_MemFree() or LCFree() can do the job
         context->E = NULL;
         context->VI = NULL;
 
@@ -189,19 +193,19 @@ void _K33Search_ClearStructures(K33SearchContext *context)
     {
         if (context->E != NULL)
         {
-            free(context->E);
+            gp_MemFree(context->E);
             context->E = NULL;
         }
         if (context->VI != NULL)
         {
-            free(context->VI);
+            gp_MemFree(context->VI);
             context->VI = NULL;
         }
 
         LCFree(&context->separatedDFSChildLists);
         if (context->buckets != NULL)
         {
-            free(context->buckets);
+            gp_MemFree(context->buckets);
             context->buckets = NULL;
         }
         LCFree(&context->bin);
@@ -221,10 +225,10 @@ int _K33Search_CreateStructures(K33SearchContext *context)
     if (gp_GetN(context->theGraph) <= 0)
         return NOTOK;
 
-    if ((context->E = (K33Search_EdgeRecP)malloc(Esize * sizeof(K33Search_EdgeRec))) == NULL ||
-        (context->VI = (K33Search_VertexInfoP)malloc(VIsize * sizeof(K33Search_VertexInfo))) == NULL ||
+    if ((context->E = (K33Search_EdgeRecP)gp_MemAlloc(Esize * sizeof(K33Search_EdgeRec))) == NULL ||
+        (context->VI = (K33Search_VertexInfoP)gp_MemAlloc(VIsize * sizeof(K33Search_VertexInfo))) == NULL ||
         (context->separatedDFSChildLists = LCNew(VIsize)) == NULL ||
-        (context->buckets = (int *)malloc(VIsize * sizeof(int))) == NULL ||
+        (context->buckets = (int *)gp_MemAlloc(VIsize * sizeof(int))) == NULL ||
         (context->bin = LCNew(VIsize)) == NULL)
     {
         return NOTOK;
@@ -324,7 +328,7 @@ int _K33Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
     newEsize = gp_UpperBoundEdgeStorage(theGraph);
 
     // We must successfully allocate the new parallel edge array
-    newE = (K33Search_EdgeRecP)malloc(newEsize * sizeof(K33Search_EdgeRec));
+    newE = (K33Search_EdgeRecP)gp_MemAlloc(newEsize * sizeof(K33Search_EdgeRec));
     if (newE == NULL)
         return NOTOK;
 
@@ -336,11 +340,42 @@ int _K33Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
 
     // Set the new edge array into the context and free the old one
     context->E = newE;
-    free(oldE);
+    gp_MemFree(oldE);
 
     return OK;
 }
 
+/********************************************************************
+ _K33Search_GetMemoryUsage()
+ ********************************************************************/
+
+void _K33Search_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail)
+{
+    K33SearchContext *context = NULL;
+    size_t bytes = 0;
+
+    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+
+    if (context != NULL)
+    {
+        // Get the memory usage of the base class(es)
+        context->functions.fpGetMemoryUsage(theGraph, detail);
+
+        bytes = sizeof(K33SearchContext);
+
+        if (context->E != NULL)
+            bytes += (size_t)gp_UpperBoundEdgeStorage(theGraph) * sizeof(K33Search_EdgeRec);
+        if (context->VI != NULL)
+            bytes += (size_t)gp_UpperBoundVertices(theGraph) * sizeof(K33Search_VertexInfo);
+        if (context->buckets != NULL)
+            bytes += (size_t)gp_UpperBoundVertices(theGraph) * sizeof(int);
+        bytes += LCGetMemoryUsage(context->separatedDFSChildLists);
+        bytes += LCGetMemoryUsage(context->bin);
+
+        gp_AddExtensionMemoryUsage(detail, K33SEARCH_ID, bytes);
+    }
+}
+
 /********************************************************************
  _K33Search_DupContext()
  ********************************************************************/
@@ -348,7 +383,7 @@ int _K33Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
 void *_K33Search_DupContext(void *pContext, void *theGraph)
 {
     K33SearchContext *context = (K33SearchContext *)pContext;
-    K33SearchContext *newContext = (K33SearchContext *)malloc(sizeof(K33SearchContext));
+    K33SearchContext *newContext = (K33SearchContext *)gp_MemAlloc(sizeof(K33SearchContext));
 
     if (newContext != NULL)
     {
@@ -439,7 +474,7 @@ void _K33Search_FreeContext(void *pContext)
     K33SearchContext *context = (K33SearchContext *)pContext;
 
     _K33Search_ClearStructures(context);
-    free(pContext);
+    gp_MemFree(pContext);
 }
 
 /********************************************************************
@@ -808,6 +843,37 @@ int _K33Search_DeleteEdge(graphP theGraph, int e)
     return context->functions.fpDeleteEdge(theGraph, e);
 }
 
+/********************************************************************
+ _K33Search_CompactEdgeStorage()
+ Moves the K_{3,3} search-specific edge data along with the edge records.
+ ********************************************************************/
+
+int _K33Search_CompactEdgeStorage(graphP theGraph, int *oldToNewMap)
+{
+    K33SearchContext *context = NULL;
+    int e, newUpperBound = gp_LowerBoundEdges(theGraph) + (gp_GetM(theGraph) << 1);
+
+    gp_FindExtension(theGraph, K33SEARCH_ID, (void *)&context);
+    if (context == NULL)
+        return NOTOK;
+
+    // The base class has not yet compacted the graph, so the upper bound
+    // of the edges still includes the edge holes
+    if (context->E != NULL)
+    {
+        for (e = gp_LowerBoundEdges(theGraph); e < gp_UpperBoundEdges(theGraph); e++)
+        {
+            if (oldToNewMap[e] != NIL)
+                context->E[oldToNewMap[e]] = context->E[e];
+        }
+
+        for (e = newUpperBound; e < gp_UpperBoundEdges(theGraph); e++)
+            _K33Search_InitEdgeRec(context, e);
+    }
+
+    return context->functions.fpCompactEdgeStorage(theGraph, oldToNewMap);
+}
+
 /********************************************************************
  ********************************************************************/
 
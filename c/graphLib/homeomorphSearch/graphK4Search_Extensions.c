@@ -34,12 +34,14 @@ void _K4Search_InitEdgeRec(K4SearchContext *context, int e);
 int _K4Search_HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R);
 int _K4Search_EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult);
 int _K4Search_DeleteEdge(graphP theGraph, int e);
+int _K4Search_CompactEdgeStorage(graphP theGraph, int *oldToNewMap);
 int _K4Search_CheckEmbeddingIntegrity(graphP theGraph, graphP origGraph);
 int _K4Search_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
 
 int _K4Search_EnsureVertexCapacity(graphP theGraph, int N);
 void _K4Search_ResetGraphStorage(graphP theGraph);
 int _K4Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity);
+void _K4Search_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail);
 
 /* Forward declarations of functions used by the extension system */
 
@@ -82,7 +84,7 @@ int gp_ExtendWith_K4Search(graphP theGraph)
         return NOTOK;
 
     // Allocate a new extension context
-    context = (K4SearchContext *)malloc(sizeof(K4SearchContext));
+    context = (K4SearchContext *)gp_MemAlloc(sizeof(K4SearchContext));
     if (context == NULL)
     {
         return NOTOK;
@@ -107,6 +109,8 @@ int gp_ExtendWith_K4Search(graphP theGraph)
     context->functions.fpResetGraphStorage = _K4Search_ResetGraphStorage;
     context->functions.fpEnsureEdgeCapacity = _K4Search_EnsureEdgeCapacity;
     context->functions.fpDeleteEdge = _K4Search_DeleteEdge;
+    context->functions.fpCompactEdgeStorage = _K4Search_CompactEdgeStorage;
+    context->functions.fpGetMemoryUsage = _K4Search_GetMemoryUsage;
 
     _K4Search_ClearStructures(context);
 
@@ -163,7 +167,7 @@ void _K4Search_ClearStructures(K4SearchContext *context)
     if (!context->initialized)
     {
         // Before initialization, the pointers are stray, not NULL
-        // Once NULL or allocated, free() or LCFree() can do the job
+        // Once NULL or allocated, gp_MemFree() or LCFree() can do the job
         context->E = NULL;
 
         context->handlingBlockedBicomp = FALSE;
@@ -174,7 +178,7 @@ void _K4Search_ClearStructures(K4SearchContext *context)
     {
         if (context->E != NULL)
         {
-            free(context->E);
+            gp_MemFree(context->E);
             context->E = NULL;
         }
         context->handlingBlockedBicomp = FALSE;
@@ -191,7 +195,7 @@ int _K4Search_CreateStructures(K4SearchContext *context)
     if (gp_GetN(context->theGraph) <= 0)
         return NOTOK;
 
-    if ((context->E = (K4Search_EdgeRecP)malloc(gp_UpperBoundEdgeStorage(context->theGraph) * sizeof(K4Search_EdgeRec))) == NULL ||
+    if ((context->E = (K4Search_EdgeRecP)gp_MemAlloc(gp_UpperBoundEdgeStorage(context->theGraph) * sizeof(K4Search_EdgeRec))) == NULL ||
         0)
     {
         return NOTOK;
@@ -286,7 +290,7 @@ int _K4Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
     newEsize = gp_UpperBoundEdgeStorage(theGraph);
 
     // We must successfully allocate the new parallel edge array
-    newE = (K4Search_EdgeRecP)malloc(newEsize * sizeof(K4Search_EdgeRec));
+    newE = (K4Search_EdgeRecP)gp_MemAlloc(newEsize * sizeof(K4Search_EdgeRec));
     if (newE == NULL)
         return NOTOK;
 
@@ -298,11 +302,36 @@ int _K4Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
 
     // Set the new edge array into the context and free the old one
     context->E = newE;
-    free(oldE);
+    gp_MemFree(oldE);
 
     return OK;
 }
 
+/********************************************************************
+ _K4Search_GetMemoryUsage()
+ ********************************************************************/
+
+void _K4Search_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail)
+{
+    K4SearchContext *context = NULL;
+    size_t bytes = 0;
+
+    gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+
+    if (context != NULL)
+    {
+        // Get the memory usage of the base class(es)
+        context->functions.fpGetMemoryUsage(theGraph, detail);
+
+        bytes = sizeof(K4SearchContext);
+
+        if (context->E != NULL)
+            bytes += (size_t)gp_UpperBoundEdgeStorage(theGraph) * sizeof(K4Search_EdgeRec);
+
+        gp_AddExtensionMemoryUsage(detail, K4SEARCH_ID, bytes);
+    }
+}
+
 /********************************************************************
  _K4Search_DupContext()
  ********************************************************************/
@@ -310,7 +339,7 @@ int _K4Search_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
 void *_K4Search_DupContext(void *pContext, void *theGraph)
 {
     K4SearchContext *context = (K4SearchContext *)pContext;
-    K4SearchContext *newContext = (K4SearchContext *)malloc(sizeof(K4SearchContext));
+    K4SearchContext *newContext = (K4SearchContext *)gp_MemAlloc(sizeof(K4SearchContext));
 
     if (newContext != NULL)
     {
@@ -386,7 +415,7 @@ void _K4Search_FreeContext(void *pContext)
     K4SearchContext *context = (K4SearchContext *)pContext;
 
     _K4Search_ClearStructures(context);
-    free(pContext);
+    gp_MemFree(pContext);
 }
 
 /********************************************************************
@@ -548,6 +577,37 @@ int _K4Search_DeleteEdge(graphP theGraph, int e)
     return context->functions.fpDeleteEdge(theGraph, e);
 }
 
+/********************************************************************
+ _K4Search_CompactEdgeStorage()
+ Moves the K_4 search-specific edge data along with the edge records.
+ ********************************************************************/
+
+int _K4Search_CompactEdgeStorage(graphP theGraph, int *oldToNewMap)
+{
+    K4SearchContext *context = NULL;
+    int e, newUpperBound = gp_LowerBoundEdges(theGraph) + (gp_GetM(theGraph) << 1);
+
+    gp_FindExtension(theGraph, K4SEARCH_ID, (void *)&context);
+    if (context == NULL)
+        return NOTOK;
+
+    // The base class has not yet compacted the graph, so the upper bound
+    // of the edges still includes the edge holes
+    if (context->E != NULL)
+    {
+        for (e = gp_LowerBoundEdges(theGraph); e < gp_UpperBoundEdges(theGraph); e++)
+        {
+            if (oldToNewMap[e] != NIL)
+                context->E[oldToNewMap[e]] = context->E[e];
+        }
+
+        for (e = newUpperBound; e < gp_UpperBoundEdges(theGraph); e++)
+            _K4Search_InitEdgeRec(context, e);
+    }
+
+    return context->functions.fpCompactEdgeStorage(theGraph, oldToNewMap);
+}
+
 /********************************************************************
  ********************************************************************/
 
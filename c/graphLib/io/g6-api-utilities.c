@@ -23,6 +23,7 @@ int _g6_ValidateOrderOfEncodedGraph(char *graphBuff, int order);
 // well as to check the validity of the encoding produced before attempting to
 // write.
 int _g6_ValidateGraphEncoding(char *graphBuff, const int order, const size_t numChars);
+int _g6_ValidateGraphEncodingChars(char *graphBuff, const int order, const size_t numChars);
 
 /* Private functions */
 size_t _g6_GetMaxEdgeCount(int);
@@ -106,11 +107,7 @@ int _g6_ValidateOrderOfEncodedGraph(char *graphBuff, int order)
 
 int _g6_ValidateGraphEncoding(char *graphBuff, const int order, const size_t numChars)
 {
-    int exitCode = OK;
-
-    size_t numPaddingZeroes = 0, numCharsForGraphEncoding = 0;
-    size_t expectedNumPaddingZeroes = 0, expectedNumChars = 0;
-    char finalByte = '\0';
+    size_t numCharsForGraphEncoding = 0, expectedNumChars = 0;
 
     if (graphBuff == NULL || strlen(graphBuff) == 0)
     {
@@ -118,9 +115,6 @@ int _g6_ValidateGraphEncoding(char *graphBuff, const int order, const size_t num
         return NOTOK;
     }
 
-    expectedNumPaddingZeroes = _g6_GetExpectedNumPaddingZeroes(order, numChars);
-    finalByte = graphBuff[numChars - 1] - 63;
-
     // Num edges of the graph (and therefore the number of bits) is (n * (n-1))/2, and
     // since each resulting byte needs to correspond to an ascii character between 63 and 126,
     // each group is only comprised of 6 bits (to which we add 63 for the final byte value)
@@ -137,6 +131,28 @@ int _g6_ValidateGraphEncoding(char *graphBuff, const int order, const size_t num
         return NOTOK;
     }
 
+    return _g6_ValidateGraphEncodingChars(graphBuff, order, numChars);
+}
+
+// Validates the numChars characters of the graphBuff, which need not be null-
+// terminated, so the caller is responsible for having checked that numChars is
+// the number of characters expected for the order.
+int _g6_ValidateGraphEncodingChars(char *graphBuff, const int order, const size_t numChars)
+{
+    int exitCode = OK;
+
+    size_t numPaddingZeroes = 0, expectedNumPaddingZeroes = 0;
+    char finalByte = '\0';
+
+    if (graphBuff == NULL || numChars == 0)
+    {
+        gp_ErrorMessage("Invalid encoding: graphBuff is NULL or empty.");
+        return NOTOK;
+    }
+
+    expectedNumPaddingZeroes = _g6_GetExpectedNumPaddingZeroes(order, numChars);
+    finalByte = graphBuff[numChars - 1] - 63;
+
     // Check that characters are valid ASCII characters between 62 and 126
     for (size_t i = 0; i < numChars; i++)
     {
@@ -4,9 +4,17 @@ All rights reserved.
 See the LICENSE.TXT file for licensing information.
 */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "strOrFile.h"
 
 #include "g6-read-iterator.h"
@@ -20,6 +28,7 @@ extern int _g6_GetNumCharsForOrder(int order);
 extern size_t _g6_GetExpectedNumPaddingZeroes(const int order, const size_t numChars);
 extern int _g6_ValidateOrderOfEncodedGraph(char *graphBuff, int order);
 extern int _g6_ValidateGraphEncoding(char *graphBuff, const int order, const size_t numChars);
+extern int _g6_ValidateGraphEncodingChars(char *graphBuff, const int order, const size_t numChars);
 
 /* Private function declarations (exported within system) */
 int _g6_ReadGraphFromStrOrFile(graphP theGraph, strOrFileP *pInputContainer);
@@ -32,6 +41,16 @@ int _g6_ValidateHeader(strOrFileP inputContainer);
 int _g6_ValidateFirstChar(char c, const int lineNum);
 int _g6_DetermineOrderFromInput(strOrFileP inputContainer, int *order);
 
+int _g6_MapFile(G6ReadIteratorP theG6ReadIterator, char const *const infileName);
+void _g6_UnmapFile(G6ReadIteratorP theG6ReadIterator);
+int _g6_ReadMappedGraph(G6ReadIteratorP theG6ReadIterator);
+
+int _g6_DetermineMappedGraphCount(G6ReadIteratorP theG6ReadIterator);
+int _g6_ReadGraphIndexFile(G6ReadIteratorP theG6ReadIterator);
+int _g6_BuildGraphIndex(G6ReadIteratorP theG6ReadIterator);
+char *_g6_GetGraphIndexFileName(G6ReadIteratorP theG6ReadIterator);
+void _g6_FreeGraphIndex(G6ReadIteratorP theG6ReadIterator);
+
 int _g6_DecodeGraph(char *graphBuff, const int order, const int numChars, graphP theGraph);
 
 int _g6_ReadGraphFromFile(graphP theGraph, char *pathToG6File);
@@ -57,8 +76,47 @@ struct G6ReadIteratorStruct
     graphP currGraph;
 
     int endReached;
+
+    // If the reader was initialized with g6_InitReaderWithMappedFile(), then
+    // the file contents are in mappedData, which is mapped into memory by the
+    // OS if mappedByOS is TRUE or otherwise read into allocated memory. The
+    // first line is read with the inputContainer, and the remaining lines are
+    // read directly from mappedData, starting at mappedPos.
+    char *mappedData;
+    size_t mappedSize;
+    size_t mappedPos;
+    int mappedByOS;
+
+    // For random access to the graphs of a mapped file, mappedFirstGraphPos
+    // is the position of the second line, and mappedNumGraphs is the number
+    // of graphs in the file, or 0 if not yet determined. If every line from
+    // the second one on has mappedLineWidth chars, including the line ending,
+    // then the position of each graph is computed. Otherwise, mappedLineWidth
+    // is 0, and graphIndex has the position of every G6_INDEX_STRIDE-th graph,
+    // starting with the second graph, built by one scan of the file. The
+    // index sidecar file is only read, and only written by
+    // g6_WriteGraphIndexFile(), if useGraphIndexFile is set by a call to
+    // g6_UseGraphIndexFile(); graphIndexSaved is TRUE if the index in memory
+    // was read from or written to the sidecar.
+    char *mappedFileName;
+    size_t mappedFirstGraphPos;
+    size_t mappedLineWidth;
+    int mappedNumGraphs;
+    size_t *graphIndex;
+    int graphIndexSize;
+    int graphIndexSaved;
+    int useGraphIndexFile;
 };
 
+// The index sidecar file of a mapped .g6 file has the name of the .g6 file
+// plus this extension, and it starts with this header, followed by the size
+// of the .g6 file, the index stride and the number of graphs; then, the
+// positions in the .g6 file of graphs 1, 1 + stride, 1 + 2*stride, etc. follow,
+// one per line.
+#define G6_INDEX_EXTENSION ".idx"
+#define G6_INDEX_HEADER ">>g6index<<"
+#define G6_INDEX_STRIDE 4096
+
 /********************************************************************
  Public and package private method implementations for read iterator
  ********************************************************************/
@@ -84,7 +142,7 @@ int g6_NewReader(G6ReadIteratorP *pG6ReadIterator, graphP theGraph)
 
     // numGraphsRead, order, numCharsForOrder, numCharsForGraphEncoding, and
     // currGraphBuffSize all set to 0
-    (*pG6ReadIterator) = (G6ReadIteratorP)calloc(1, sizeof(G6ReadIteratorStruct));
+    (*pG6ReadIterator) = (G6ReadIteratorP)gp_MemCalloc(1, sizeof(G6ReadIteratorStruct));
 
     if ((*pG6ReadIterator) == NULL)
     {
@@ -223,6 +281,200 @@ int g6_InitReaderWithFileName(G6ReadIteratorP theG6ReadIterator, char const *con
         (&inputContainer));
 }
 
+/********************************************************************
+ g6_InitReaderWithMappedFile()
+
+ Initializes the reader like g6_InitReaderWithFileName(), except that
+ the whole file is mapped into memory (or, on platforms without mmap,
+ read into memory) and each line after the first is found with memchr
+ and validated and decoded where it lies, without being copied through
+ the string-or-file container.  This is intended for very large .g6
+ files, such as the output of geng.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int g6_InitReaderWithMappedFile(G6ReadIteratorP theG6ReadIterator, char const *const infileName)
+{
+    strOrFileP inputContainer = NULL;
+    char *firstLine = NULL, *firstNewline = NULL;
+    size_t firstLineLen = 0;
+
+    if (theG6ReadIterator == NULL)
+    {
+        gp_ErrorMessage("Invalid parameter: theG6ReadIterator must be non-NULL.");
+        return NOTOK;
+    }
+
+    if (_g6_IsReaderInitialized(theG6ReadIterator, FALSE) || theG6ReadIterator->mappedData != NULL)
+    {
+        gp_ErrorMessage("Unable to initialize reader, as it was already "
+                        "previously initialized.");
+        return NOTOK;
+    }
+
+    if (infileName == NULL || strlen(infileName) == 0)
+    {
+        gp_ErrorMessage("Unable to initialize reader with empty infile name.");
+        return NOTOK;
+    }
+
+    if (_g6_MapFile(theG6ReadIterator, infileName) != OK)
+    {
+        gp_ErrorMessage("Unable to map \"%.*s\" into memory.", FILENAME_MAX, infileName);
+        return NOTOK;
+    }
+
+    if (theG6ReadIterator->mappedSize == 0)
+    {
+        gp_ErrorMessage("Unable to initialize reader: .g6 infile is empty.");
+        return NOTOK;
+    }
+
+    // The header and order of the first line are processed, and the first
+    // graph is read, by the usual methods using a container for the first line
+    firstNewline = (char *)memchr(theG6ReadIterator->mappedData, '\n', theG6ReadIterator->mappedSize);
+    firstLineLen = firstNewline == NULL ? theG6ReadIterator->mappedSize
+                                        : (size_t)(firstNewline - theG6ReadIterator->mappedData) + 1;
+
+    if ((firstLine = (char *)gp_MemAlloc(firstLineLen + 1)) == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate memory for first line of .g6 file.");
+        return NOTOK;
+    }
+
+    memcpy(firstLine, theG6ReadIterator->mappedData, firstLineLen);
+    firstLine[firstLineLen] = '\0';
+    theG6ReadIterator->mappedPos = theG6ReadIterator->mappedFirstGraphPos = firstLineLen;
+
+    // The file name is kept to find the index sidecar file, if one is needed
+    if ((theG6ReadIterator->mappedFileName = (char *)gp_MemAlloc(strlen(infileName) + 1)) == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate memory for name of mapped file.");
+        gp_MemFree(firstLine);
+        return NOTOK;
+    }
+    strcpy(theG6ReadIterator->mappedFileName, infileName);
+
+    inputContainer = sf_NewInputContainer(firstLine, NULL);
+    gp_MemFree(firstLine);
+
+    if (inputContainer == NULL)
+    {
+        gp_ErrorMessage("Unable to initialize reader with mapped file, as we "
+                        "failed to allocate the inputContainer.");
+        return NOTOK;
+    }
+
+    return _g6_InitReaderWithStrOrFile(
+        theG6ReadIterator,
+        (&inputContainer));
+}
+
+/********************************************************************
+ _g6_MapFile()
+ _g6_UnmapFile()
+
+ Map the file into (or unmap it from) the reader's mappedData.  With
+ mmap, a zero-length file is not mapped, and mappedData stays NULL.
+ ********************************************************************/
+
+int _g6_MapFile(G6ReadIteratorP theG6ReadIterator, char const *const infileName)
+{
+#ifdef HAVE_SYS_MMAN_H
+    struct stat fileStat;
+    void *mappedData = NULL;
+    int fd = open(infileName, O_RDONLY);
+
+    if (fd < 0)
+        return NOTOK;
+
+    if (fstat(fd, &fileStat) != 0)
+    {
+        close(fd);
+        return NOTOK;
+    }
+
+    if (fileStat.st_size > 0)
+    {
+        mappedData = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mappedData == MAP_FAILED)
+        {
+            close(fd);
+            return NOTOK;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(mappedData, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+#endif
+        theG6ReadIterator->mappedData = (char *)mappedData;
+        theG6ReadIterator->mappedSize = (size_t)fileStat.st_size;
+        theG6ReadIterator->mappedByOS = TRUE;
+    }
+
+    // The mapping remains valid after the file descriptor is closed
+    close(fd);
+#else
+    FILE *infile = fopen(infileName, "rb");
+    long fileSize = 0;
+
+    if (infile == NULL)
+        return NOTOK;
+
+    if (fseek(infile, 0, SEEK_END) != 0 || (fileSize = ftell(infile)) < 0 ||
+        fseek(infile, 0, SEEK_SET) != 0)
+    {
+        fclose(infile);
+        return NOTOK;
+    }
+
+    if (fileSize > 0)
+    {
+        if ((theG6ReadIterator->mappedData = (char *)gp_MemAlloc((size_t)fileSize)) == NULL ||
+            fread(theG6ReadIterator->mappedData, 1, (size_t)fileSize, infile) != (size_t)fileSize)
+        {
+            gp_MemFree(theG6ReadIterator->mappedData);
+            theG6ReadIterator->mappedData = NULL;
+            fclose(infile);
+            return NOTOK;
+        }
+        theG6ReadIterator->mappedSize = (size_t)fileSize;
+        theG6ReadIterator->mappedByOS = FALSE;
+    }
+
+    fclose(infile);
+#endif
+
+    return OK;
+}
+
+void _g6_UnmapFile(G6ReadIteratorP theG6ReadIterator)
+{
+    if (theG6ReadIterator->mappedData != NULL)
+    {
+#ifdef HAVE_SYS_MMAN_H
+        if (theG6ReadIterator->mappedByOS)
+            munmap(theG6ReadIterator->mappedData, theG6ReadIterator->mappedSize);
+        else
+#endif
+            gp_MemFree(theG6ReadIterator->mappedData);
+
+        theG6ReadIterator->mappedData = NULL;
+    }
+
+    theG6ReadIterator->mappedSize = theG6ReadIterator->mappedPos = 0;
+    theG6ReadIterator->mappedByOS = FALSE;
+
+    if (theG6ReadIterator->mappedFileName != NULL)
+    {
+        gp_MemFree(theG6ReadIterator->mappedFileName);
+        theG6ReadIterator->mappedFileName = NULL;
+    }
+
+    _g6_FreeGraphIndex(theG6ReadIterator);
+    theG6ReadIterator->mappedFirstGraphPos = theG6ReadIterator->mappedLineWidth = 0;
+    theG6ReadIterator->mappedNumGraphs = 0;
+}
+
 int _g6_InitReaderWithStrOrFile(G6ReadIteratorP theG6ReadIterator, strOrFileP *pInputContainer)
 {
     if (theG6ReadIterator == NULL)
@@ -343,7 +595,7 @@ int _g6_InitReader(G6ReadIteratorP theG6ReadIterator)
     theG6ReadIterator->numCharsForGraphEncoding = _g6_GetNumCharsForEncoding(order);
     // Must add 3 bytes for newline, possible carriage return, and null terminator
     theG6ReadIterator->currGraphBuffSize = theG6ReadIterator->numCharsForOrder + theG6ReadIterator->numCharsForGraphEncoding + 3;
-    theG6ReadIterator->currGraphBuff = (char *)calloc(theG6ReadIterator->currGraphBuffSize, sizeof(char));
+    theG6ReadIterator->currGraphBuff = (char *)gp_MemCalloc(theG6ReadIterator->currGraphBuffSize, sizeof(char));
 
     if (theG6ReadIterator->currGraphBuff == NULL)
     {
@@ -477,6 +729,10 @@ int g6_ReadGraph(G6ReadIteratorP theG6ReadIterator)
         return NOTOK;
     }
 
+    // After the first line, a mapped file is read directly from memory
+    if (theG6ReadIterator->mappedData != NULL && theG6ReadIterator->numGraphsRead > 0)
+        return _g6_ReadMappedGraph(theG6ReadIterator);
+
     inputContainer = theG6ReadIterator->inputContainer;
     lineNum = theG6ReadIterator->numGraphsRead + 1;
     currGraphBuff = theG6ReadIterator->currGraphBuff;
@@ -550,21 +806,663 @@ int g6_ReadGraph(G6ReadIteratorP theG6ReadIterator)
     return OK;
 }
 
+/********************************************************************
+ g6_SetReaderGraph()
+
+ Sets the graph into which the reader decodes the following graphs,
+ so that a caller can rotate among several graphs, e.g. to decode the
+ next graph while the previous one is still in use. The graph must
+ already have the order of the graphs in the input, e.g. by a call
+ to gp_EnsureVertexCapacity().  Like the graph given to the reader by
+ g6_NewReader(), the graph is reset by g6_ReadGraph() before a graph
+ is decoded into it.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int g6_SetReaderGraph(G6ReadIteratorP theG6ReadIterator, graphP theGraph)
+{
+    if (!_g6_IsReaderInitialized(theG6ReadIterator, TRUE))
+    {
+        gp_ErrorMessage("G6ReadIterator is not initialized.");
+        return NOTOK;
+    }
+
+    if (theGraph == NULL || gp_GetN(theGraph) != theG6ReadIterator->order)
+    {
+        gp_ErrorMessage("Unable to set reader graph, as it must have the order "
+                        "%d of the graphs in the .g6 input.",
+                        theG6ReadIterator->order);
+        return NOTOK;
+    }
+
+    // Only the first graph is decoded without a reset, as the reader graph
+    // is reset by the initialization of the reader
+    if (theG6ReadIterator->numGraphsRead == 0 && theGraph != theG6ReadIterator->currGraph)
+        gp_ResetGraphStorage(theGraph);
+
+    theGraph->graphFlags |= GRAPHFLAGS_ZEROBASEDIO;
+    theG6ReadIterator->currGraph = theGraph;
+
+    return OK;
+}
+
+/********************************************************************
+ _g6_ReadMappedGraph()
+
+ Reads the next line of a mapped file with the same validation as
+ g6_ReadGraph(), but without copying the line: memchr (which is
+ vectorized by common C libraries) finds the end of the line, and
+ the graph is validated and decoded where it lies in mappedData.
+ ********************************************************************/
+
+int _g6_ReadMappedGraph(G6ReadIteratorP theG6ReadIterator)
+{
+    char *lineStart = NULL, *lineEnd = NULL;
+    size_t lineLen = 0;
+    const int lineNum = theG6ReadIterator->numGraphsRead + 1;
+    const int order = theG6ReadIterator->order;
+    const int numCharsForOrder = theG6ReadIterator->numCharsForOrder;
+    const size_t numCharsForGraphEncoding = theG6ReadIterator->numCharsForGraphEncoding;
+    graphP currGraph = theG6ReadIterator->currGraph;
+
+    if (theG6ReadIterator->mappedPos >= theG6ReadIterator->mappedSize)
+    {
+        theG6ReadIterator->endReached = TRUE;
+        return OK;
+    }
+
+    lineStart = theG6ReadIterator->mappedData + theG6ReadIterator->mappedPos;
+    lineLen = theG6ReadIterator->mappedSize - theG6ReadIterator->mappedPos;
+
+    if ((lineEnd = (char *)memchr(lineStart, '\n', lineLen)) != NULL)
+        lineLen = (size_t)(lineEnd - lineStart);
+
+    theG6ReadIterator->mappedPos += lineLen + (lineEnd != NULL ? 1 : 0);
+
+    if (lineLen > 0 && lineStart[lineLen - 1] == '\r')
+        lineLen--;
+
+    if (lineLen != numCharsForOrder + numCharsForGraphEncoding)
+    {
+        gp_ErrorMessage("Invalid line length read on line %d",
+                        lineNum);
+        return NOTOK;
+    }
+
+    if (_g6_ValidateFirstChar(lineStart[0], lineNum) != OK)
+        return NOTOK;
+
+    if (_g6_ValidateOrderOfEncodedGraph(lineStart, order) != OK)
+    {
+        gp_ErrorMessage("Order of graph on line %d is incorrect.",
+                        lineNum);
+        return NOTOK;
+    }
+
+    if (_g6_ValidateGraphEncodingChars(lineStart + numCharsForOrder, order, numCharsForGraphEncoding) != OK)
+    {
+        gp_ErrorMessage("Graph on line %d is invalid.", lineNum);
+        return NOTOK;
+    }
+
+    gp_ResetGraphStorage(currGraph);
+    // Ensures zero-based flag is set after reinitializing graph.
+    currGraph->graphFlags |= GRAPHFLAGS_ZEROBASEDIO;
+
+    if (_g6_DecodeGraph(lineStart + numCharsForOrder, order, numCharsForGraphEncoding, currGraph) != OK)
+    {
+        gp_ErrorMessage("Unable to interpret bits on line %d to populate "
+                        "adjacency matrix.",
+                        lineNum);
+        return NOTOK;
+    }
+
+    theG6ReadIterator->numGraphsRead = lineNum;
+
+    return OK;
+}
+
+/********************************************************************
+ g6_GetGraphCount()
+
+ Returns the number of graphs in the .g6 file of a reader initialized
+ with g6_InitReaderWithMappedFile(), which is at least 1, or 0 on error.
+
+ If every line after the first has the same length, as in the output
+ of geng, then the count is computed from the file size in constant
+ time. Otherwise, the count is obtained from the index sidecar file,
+ if its use was enabled by g6_UseGraphIndexFile() and there is a valid
+ one for the file, or else by one scan of the file that also builds the
+ index used by g6_SeekToGraph().
+ ********************************************************************/
+
+int g6_GetGraphCount(G6ReadIteratorP theG6ReadIterator)
+{
+    if (!_g6_IsReaderInitialized(theG6ReadIterator, TRUE))
+    {
+        gp_ErrorMessage("G6ReadIterator is not initialized.");
+        return 0;
+    }
+
+    if (theG6ReadIterator->mappedData == NULL)
+    {
+        gp_ErrorMessage("Unable to count graphs, as the reader was not "
+                        "initialized with a mapped file.");
+        return 0;
+    }
+
+    if (theG6ReadIterator->mappedNumGraphs == 0 &&
+        _g6_DetermineMappedGraphCount(theG6ReadIterator) != OK)
+        return 0;
+
+    return theG6ReadIterator->mappedNumGraphs;
+}
+
+/********************************************************************
+ g6_SeekToGraph()
+
+ Positions the reader so that the next call to g6_ReadGraph() reads
+ the graph with the zero-based number graphNum, i.e. the graph on line
+ graphNum + 1 of the .g6 input, and so that line numbers in messages
+ are still those of the whole input. Seeking to the number of graphs
+ in the input, or to any greater number, positions the reader at its
+ end, so that the next call to g6_ReadGraph() reports the end reached.
+
+ For a reader initialized with g6_InitReaderWithMappedFile(), the seek
+ takes constant time if the lines are of fixed width, and otherwise it
+ scans at most G6_INDEX_STRIDE lines after an indexed position (see
+ g6_GetGraphCount()). The only graph that cannot be sought after it
+ has been read is the first, as it is read with the header and order.
+
+ For other readers, the seek can only be forward, and it is done by
+ reading the graphs in between.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int g6_SeekToGraph(G6ReadIteratorP theG6ReadIterator, int graphNum)
+{
+    size_t graphPos = 0;
+    char *lineEnd = NULL;
+
+    if (!_g6_IsReaderInitialized(theG6ReadIterator, TRUE))
+    {
+        gp_ErrorMessage("G6ReadIterator is not initialized.");
+        return NOTOK;
+    }
+
+    if (graphNum < 0)
+    {
+        gp_ErrorMessage("Unable to seek to negative graph number %d.", graphNum);
+        return NOTOK;
+    }
+
+    if (theG6ReadIterator->mappedData == NULL)
+    {
+        if (graphNum < theG6ReadIterator->numGraphsRead)
+        {
+            gp_ErrorMessage("Unable to seek backward to graph %d, as the reader "
+                            "was not initialized with a mapped file.",
+                            graphNum);
+            return NOTOK;
+        }
+
+        while (theG6ReadIterator->numGraphsRead < graphNum)
+        {
+            if (g6_ReadGraph(theG6ReadIterator) != OK)
+                return NOTOK;
+
+            if (theG6ReadIterator->endReached)
+                break;
+        }
+
+        return OK;
+    }
+
+    if (g6_GetGraphCount(theG6ReadIterator) == 0)
+        return NOTOK;
+
+    if (graphNum > theG6ReadIterator->mappedNumGraphs)
+        graphNum = theG6ReadIterator->mappedNumGraphs;
+
+    if (graphNum == 0)
+    {
+        if (theG6ReadIterator->numGraphsRead > 0)
+        {
+            gp_ErrorMessage("Unable to seek back to the first graph after it "
+                            "has been read.");
+            return NOTOK;
+        }
+
+        return OK;
+    }
+
+    // Seeking to the end needs no position computation or index lookup, and
+    // the index has no entry for the end, e.g. of a file with only one graph
+    if (graphNum == theG6ReadIterator->mappedNumGraphs)
+        graphPos = theG6ReadIterator->mappedSize;
+    else if (theG6ReadIterator->mappedLineWidth > 0)
+    {
+        graphPos = theG6ReadIterator->mappedFirstGraphPos +
+                   (size_t)(graphNum - 1) * theG6ReadIterator->mappedLineWidth;
+    }
+    else
+    {
+        if (theG6ReadIterator->graphIndex == NULL ||
+            (graphNum - 1) / G6_INDEX_STRIDE >= theG6ReadIterator->graphIndexSize)
+        {
+            gp_ErrorMessage("Unable to seek to graph %d, as the index of the "
+                            ".g6 file has no entry for it.",
+                            graphNum);
+            return NOTOK;
+        }
+
+        graphPos = theG6ReadIterator->graphIndex[(graphNum - 1) / G6_INDEX_STRIDE];
+
+        for (int i = 0; i < (graphNum - 1) % G6_INDEX_STRIDE && graphPos < theG6ReadIterator->mappedSize; i++)
+        {
+            lineEnd = (char *)memchr(theG6ReadIterator->mappedData + graphPos, '\n',
+                                     theG6ReadIterator->mappedSize - graphPos);
+            graphPos = lineEnd == NULL ? theG6ReadIterator->mappedSize
+                                       : (size_t)(lineEnd - theG6ReadIterator->mappedData) + 1;
+        }
+    }
+
+    if (graphPos > theG6ReadIterator->mappedSize)
+        graphPos = theG6ReadIterator->mappedSize;
+
+    if (graphPos < theG6ReadIterator->mappedSize && theG6ReadIterator->mappedData[graphPos - 1] != '\n')
+    {
+        gp_ErrorMessage("Unable to seek to graph %d, as line %d of the .g6 "
+                        "file does not start at the expected position.",
+                        graphNum, graphNum + 1);
+        return NOTOK;
+    }
+
+    theG6ReadIterator->mappedPos = graphPos;
+    theG6ReadIterator->numGraphsRead = graphNum;
+    theG6ReadIterator->endReached = FALSE;
+
+    return OK;
+}
+
+/********************************************************************
+ _g6_DetermineMappedGraphCount()
+
+ The lines after the first are taken to be of fixed width if the size
+ of the rest of the file is a multiple of the width (allowing for the
+ line ending of the last line to be missing) and if the first and last
+ of those lines end where expected; each line is still validated when
+ it is read. The line ending is expected to be that of the first line.
+ ********************************************************************/
+
+int _g6_DetermineMappedGraphCount(G6ReadIteratorP theG6ReadIterator)
+{
+    char *mappedData = theG6ReadIterator->mappedData;
+    size_t mappedSize = theG6ReadIterator->mappedSize;
+    size_t firstGraphPos = theG6ReadIterator->mappedFirstGraphPos;
+    size_t eolLen = 1, lineWidth = 0, numLines = 0, remainder = 0;
+    int isFixedWidth = FALSE;
+
+    // A file of one line has one graph
+    if (firstGraphPos >= mappedSize)
+    {
+        theG6ReadIterator->mappedNumGraphs = 1;
+        return OK;
+    }
+
+    if (firstGraphPos >= 2 && mappedData[firstGraphPos - 2] == '\r')
+        eolLen = 2;
+
+    lineWidth = theG6ReadIterator->numCharsForOrder + theG6ReadIterator->numCharsForGraphEncoding + eolLen;
+    numLines = (mappedSize - firstGraphPos) / lineWidth;
+    remainder = (mappedSize - firstGraphPos) % lineWidth;
+
+    isFixedWidth = (remainder == 0 || remainder == lineWidth - eolLen);
+
+    if (isFixedWidth && numLines > 0)
+        isFixedWidth = mappedData[firstGraphPos + lineWidth - 1] == '\n' &&
+                       mappedData[firstGraphPos + numLines * lineWidth - 1] == '\n';
+
+    if (isFixedWidth && remainder > 0)
+        isFixedWidth = memchr(mappedData + mappedSize - remainder, '\n', remainder) == NULL;
+
+    if (!isFixedWidth)
+    {
+        if (theG6ReadIterator->useGraphIndexFile &&
+            _g6_ReadGraphIndexFile(theG6ReadIterator) == OK)
+            return OK;
+
+        return _g6_BuildGraphIndex(theG6ReadIterator);
+    }
+
+    if (remainder > 0)
+        numLines++;
+
+    if (numLines >= INT_MAX)
+    {
+        gp_ErrorMessage("Unable to count graphs, as the .g6 file has more "
+                        "than %d lines.",
+                        INT_MAX);
+        return NOTOK;
+    }
+
+    theG6ReadIterator->mappedLineWidth = lineWidth;
+    theG6ReadIterator->mappedNumGraphs = (int)numLines + 1;
+
+    return OK;
+}
+
+/********************************************************************
+ _g6_BuildGraphIndex()
+
+ Scans the lines of the mapped file after the first, recording the
+ position of every G6_INDEX_STRIDE-th line, starting with the second
+ line, and counting the lines to obtain the number of graphs.
+ ********************************************************************/
+
+int _g6_BuildGraphIndex(G6ReadIteratorP theG6ReadIterator)
+{
+    char *mappedData = theG6ReadIterator->mappedData;
+    size_t mappedSize = theG6ReadIterator->mappedSize;
+    size_t graphPos = theG6ReadIterator->mappedFirstGraphPos;
+    char *lineEnd = NULL;
+    size_t *newGraphIndex = NULL;
+    int graphNum = 1, capacity = 0;
+
+    _g6_FreeGraphIndex(theG6ReadIterator);
+
+    // The capacity is enough if the lines are mostly of the expected width
+    capacity = 1 + (int)((mappedSize - graphPos) /
+                         (((size_t)theG6ReadIterator->numCharsForOrder + theG6ReadIterator->numCharsForGraphEncoding + 1) * G6_INDEX_STRIDE));
+
+    if ((theG6ReadIterator->graphIndex = (size_t *)gp_MemAlloc(capacity * sizeof(size_t))) == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate memory for index of .g6 file.");
+        return NOTOK;
+    }
+
+    while (graphPos < mappedSize)
+    {
+        if ((graphNum - 1) % G6_INDEX_STRIDE == 0)
+        {
+            if (theG6ReadIterator->graphIndexSize == capacity)
+            {
+                capacity *= 2;
+                if ((newGraphIndex = (size_t *)gp_MemRealloc(theG6ReadIterator->graphIndex, capacity * sizeof(size_t))) == NULL)
+                {
+                    gp_ErrorMessage("Unable to allocate memory for index of .g6 file.");
+                    _g6_FreeGraphIndex(theG6ReadIterator);
+                    return NOTOK;
+                }
+                theG6ReadIterator->graphIndex = newGraphIndex;
+            }
+
+            theG6ReadIterator->graphIndex[theG6ReadIterator->graphIndexSize++] = graphPos;
+        }
+
+        if (graphNum == INT_MAX)
+        {
+            gp_ErrorMessage("Unable to index .g6 file, as it has more than %d "
+                            "lines.",
+                            INT_MAX);
+            _g6_FreeGraphIndex(theG6ReadIterator);
+            return NOTOK;
+        }
+
+        graphNum++;
+
+        lineEnd = (char *)memchr(mappedData + graphPos, '\n', mappedSize - graphPos);
+        graphPos = lineEnd == NULL ? mappedSize : (size_t)(lineEnd - mappedData) + 1;
+    }
+
+    theG6ReadIterator->mappedNumGraphs = graphNum;
+    theG6ReadIterator->graphIndexSaved = FALSE;
+
+    return OK;
+}
+
+/********************************************************************
+ _g6_ReadGraphIndexFile()
+
+ Reads the index sidecar file of the mapped file, if there is one.
+ An index file that does not match the size of the mapped file or the
+ index stride, or whose positions are not at line starts, is ignored.
+
+ Returns OK if the index was read, NOTOK otherwise (without message)
+ ********************************************************************/
+
+int _g6_ReadGraphIndexFile(G6ReadIteratorP theG6ReadIterator)
+{
+    char *indexFileName = NULL;
+    FILE *indexFile = NULL;
+    char header[sizeof(G6_INDEX_HEADER)];
+    unsigned long long fileSize = 0, graphPos = 0;
+    int stride = 0, numGraphs = 0, indexSize = 0;
+    int Result = OK;
+
+    if ((indexFileName = _g6_GetGraphIndexFileName(theG6ReadIterator)) == NULL)
+        return NOTOK;
+
+    indexFile = fopen(indexFileName, READTEXT);
+    gp_MemFree(indexFileName);
+
+    if (indexFile == NULL)
+        return NOTOK;
+
+    if (fscanf(indexFile, "%11s %llu %d %d", header, &fileSize, &stride, &numGraphs) != 4 ||
+        strcmp(header, G6_INDEX_HEADER) != 0 ||
+        fileSize != (unsigned long long)theG6ReadIterator->mappedSize ||
+        stride != G6_INDEX_STRIDE || numGraphs < 2)
+    {
+        fclose(indexFile);
+        return NOTOK;
+    }
+
+    indexSize = (numGraphs - 2) / G6_INDEX_STRIDE + 1;
+
+    _g6_FreeGraphIndex(theG6ReadIterator);
+
+    if ((theG6ReadIterator->graphIndex = (size_t *)gp_MemAlloc(indexSize * sizeof(size_t))) == NULL)
+    {
+        fclose(indexFile);
+        return NOTOK;
+    }
+
+    for (int i = 0; i < indexSize && Result == OK; i++)
+    {
+        if (fscanf(indexFile, "%llu", &graphPos) != 1 ||
+            graphPos >= (unsigned long long)theG6ReadIterator->mappedSize ||
+            graphPos < (unsigned long long)theG6ReadIterator->mappedFirstGraphPos ||
+            theG6ReadIterator->mappedData[graphPos - 1] != '\n' ||
+            (i == 0 && graphPos != (unsigned long long)theG6ReadIterator->mappedFirstGraphPos))
+            Result = NOTOK;
+        else
+            theG6ReadIterator->graphIndex[i] = (size_t)graphPos;
+    }
+
+    fclose(indexFile);
+
+    if (Result != OK)
+    {
+        _g6_FreeGraphIndex(theG6ReadIterator);
+        return NOTOK;
+    }
+
+    theG6ReadIterator->graphIndexSize = indexSize;
+    theG6ReadIterator->mappedNumGraphs = numGraphs;
+    theG6ReadIterator->graphIndexSaved = TRUE;
+
+    return OK;
+}
+
+/********************************************************************
+ g6_UseGraphIndexFile()
+
+ Enables or disables the use of the index sidecar file of a mapped .g6
+ file, which is named by the .g6 file name plus ".idx". By default, the
+ use is disabled, so the index of a .g6 file whose lines are not all of
+ the same length is only kept in memory, and nothing is written next to
+ the .g6 file. If the use is enabled before the graphs are counted by
+ g6_GetGraphCount() or g6_SeekToGraph(), then a valid sidecar is read
+ instead of scanning the file, and g6_WriteGraphIndexFile() writes it.
+
+ Returns OK on success, NOTOK on failure
+ ********************************************************************/
+
+int g6_UseGraphIndexFile(G6ReadIteratorP theG6ReadIterator, int useGraphIndexFile)
+{
+    if (theG6ReadIterator == NULL)
+    {
+        gp_ErrorMessage("G6ReadIterator is not allocated.");
+        return NOTOK;
+    }
+
+    theG6ReadIterator->useGraphIndexFile = useGraphIndexFile ? TRUE : FALSE;
+
+    return OK;
+}
+
+/********************************************************************
+ g6_WriteGraphIndexFile()
+
+ If the use of the index sidecar file was enabled by a call to
+ g6_UseGraphIndexFile(), and the reader built an index of its mapped
+ .g6 file, because the lines of the file are not all of the same
+ length, then the index is written to the sidecar file, so that later
+ readers of the file can seek and count without scanning it.
+ Otherwise, there is nothing to write.
+
+ Returns OK on success or if there is nothing to write, NOTOK on failure
+ ********************************************************************/
+
+int g6_WriteGraphIndexFile(G6ReadIteratorP theG6ReadIterator)
+{
+    char *indexFileName = NULL;
+    FILE *indexFile = NULL;
+    int Result = OK;
+
+    if (theG6ReadIterator == NULL || !theG6ReadIterator->useGraphIndexFile ||
+        theG6ReadIterator->graphIndex == NULL || theG6ReadIterator->graphIndexSaved)
+        return OK;
+
+    if ((indexFileName = _g6_GetGraphIndexFileName(theG6ReadIterator)) == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate memory for name of index file.");
+        return NOTOK;
+    }
+
+    if ((indexFile = fopen(indexFileName, WRITETEXT)) == NULL)
+    {
+        gp_ErrorMessage("Unable to open index file \"%.*s\" for writing.",
+                        FILENAME_MAX, indexFileName);
+        gp_MemFree(indexFileName);
+        return NOTOK;
+    }
+
+    if (fprintf(indexFile, "%s %llu %d %d\n", G6_INDEX_HEADER,
+                (unsigned long long)theG6ReadIterator->mappedSize,
+                G6_INDEX_STRIDE, theG6ReadIterator->mappedNumGraphs) < 0)
+        Result = NOTOK;
+
+    for (int i = 0; i < theG6ReadIterator->graphIndexSize && Result == OK; i++)
+    {
+        if (fprintf(indexFile, "%llu\n", (unsigned long long)theG6ReadIterator->graphIndex[i]) < 0)
+            Result = NOTOK;
+    }
+
+    if (fclose(indexFile) != 0)
+        Result = NOTOK;
+
+    if (Result != OK)
+    {
+        gp_ErrorMessage("Unable to write index file \"%.*s\".",
+                        FILENAME_MAX, indexFileName);
+        remove(indexFileName);
+    }
+    else
+        theG6ReadIterator->graphIndexSaved = TRUE;
+
+    gp_MemFree(indexFileName);
+
+    return Result;
+}
+
+char *_g6_GetGraphIndexFileName(G6ReadIteratorP theG6ReadIterator)
+{
+    char *indexFileName = NULL;
+
+    if (theG6ReadIterator->mappedFileName == NULL)
+        return NULL;
+
+    indexFileName = (char *)gp_MemAlloc(strlen(theG6ReadIterator->mappedFileName) + strlen(G6_INDEX_EXTENSION) + 1);
+    if (indexFileName != NULL)
+    {
+        strcpy(indexFileName, theG6ReadIterator->mappedFileName);
+        strcat(indexFileName, G6_INDEX_EXTENSION);
+    }
+
+    return indexFileName;
+}
+
+void _g6_FreeGraphIndex(G6ReadIteratorP theG6ReadIterator)
+{
+    if (theG6ReadIterator->graphIndex != NULL)
+    {
+        gp_MemFree(theG6ReadIterator->graphIndex);
+        theG6ReadIterator->graphIndex = NULL;
+    }
+
+    theG6ReadIterator->graphIndexSize = 0;
+    theG6ReadIterator->graphIndexSaved = FALSE;
+}
+
+// The decoded edges are added to the graph by gp_AddEdgesBulk() in
+// batches of this many edges, which are kept on the stack
+#define G6_DECODE_BATCH_SIZE 256
+
+// Lookup tables for _g6_DecodeGraph(): for each 6-bit value of a graph
+// encoding character (i.e. the character minus 63), the number of set bits and
+// the positions of the set bits counting from the most significant bit, which
+// is the order in which the bits of the upper triangle are encoded.
+static const unsigned char g6NumSetBits[64] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6};
+
+static const unsigned char g6SetBitPositions[64][6] = {
+    {0}, {5}, {4}, {4, 5}, {3}, {3, 5}, {3, 4}, {3, 4, 5},
+    {2}, {2, 5}, {2, 4}, {2, 4, 5}, {2, 3}, {2, 3, 5}, {2, 3, 4}, {2, 3, 4, 5},
+    {1}, {1, 5}, {1, 4}, {1, 4, 5}, {1, 3}, {1, 3, 5}, {1, 3, 4}, {1, 3, 4, 5},
+    {1, 2}, {1, 2, 5}, {1, 2, 4}, {1, 2, 4, 5}, {1, 2, 3}, {1, 2, 3, 5}, {1, 2, 3, 4}, {1, 2, 3, 4, 5},
+    {0}, {0, 5}, {0, 4}, {0, 4, 5}, {0, 3}, {0, 3, 5}, {0, 3, 4}, {0, 3, 4, 5},
+    {0, 2}, {0, 2, 5}, {0, 2, 4}, {0, 2, 4, 5}, {0, 2, 3}, {0, 2, 3, 5}, {0, 2, 3, 4}, {0, 2, 3, 4, 5},
+    {0, 1}, {0, 1, 5}, {0, 1, 4}, {0, 1, 4, 5}, {0, 1, 3}, {0, 1, 3, 5}, {0, 1, 3, 4}, {0, 1, 3, 4, 5},
+    {0, 1, 2}, {0, 1, 2, 5}, {0, 1, 2, 4}, {0, 1, 2, 4, 5}, {0, 1, 2, 3}, {0, 1, 2, 3, 5}, {0, 1, 2, 3, 4}, {0, 1, 2, 3, 4, 5}};
+
 // Takes the character array graphBuff, the derived number of vertices order,
 // and the numChars corresponding to the number of characters after the first byte
 // and performs the inverse transformation of the graph encoding: we subtract 63 from
-// each byte, then only process the 6 least significant bits of the resulting byte. For
-// the final byte, we determine how many padding zeroes to expect, and exclude them
-// from being processed. We index into the adjacency matrix by row and column, which
-// are incremented such that row ranges from 0 to one less than the column index.
+// each byte, then only process the 6 least significant bits of the resulting byte.
+// The bits encode the upper triangle of the adjacency matrix column by column, so
+// bit position p is in column col and row p - col*(col-1)/2, for the col such that
+// row < col.  A first pass over the bytes counts the edges so that the edge capacity
+// is ensured once, and a second pass uses the lookup tables above to jump directly
+// from each set bit to the next, advancing the row and column by the distance
+// between them. The padding zeroes of the final byte are never set, since they were
+// checked by _g6_ValidateGraphEncoding(), so they need no special handling.
 int _g6_DecodeGraph(char *graphBuff, const int order, const int numChars, graphP theGraph)
 {
-    int numPaddingZeroes = _g6_GetExpectedNumPaddingZeroes(order, numChars);
-
-    char currByte = '\0';
-    int bitValue = 0;
+    unsigned char currByte = 0;
+    int numEdges = 0;
+    int bitPos = 0, prevBitPos = 0;
     int row = 0;
     int col = 1;
+    int firstVertex = 0;
+    int u[G6_DECODE_BATCH_SIZE], v[G6_DECODE_BATCH_SIZE];
+    int batchSize = 0;
 
     if (theGraph == NULL)
     {
@@ -573,40 +1471,49 @@ int _g6_DecodeGraph(char *graphBuff, const int order, const int numChars, graphP
         return NOTOK;
     }
 
+    for (int i = 0; i < numChars; i++)
+        numEdges += g6NumSetBits[(unsigned char)(graphBuff[i] - 63) & 63];
+
+    if (numEdges > gp_GetEdgeCapacity(theGraph) &&
+        gp_EnsureEdgeCapacity(theGraph, numEdges) != OK)
+        return NOTOK;
+
+    // Add the offset to the first vertex in in-memory storage, because the
+    // G6 file is 0-based, but in-memory storage may not be.
+    firstVertex = gp_LowerBoundVertexStorage(theGraph);
+
     for (int i = 0; i < numChars; i++)
     {
-        currByte = graphBuff[i] - 63;
-        // j corresponds to the number of places one must bitshift the byte by
-        // to read the next bit in the byte
-        for (int j = sizeof(char) * 5; j >= 0; j--)
+        currByte = (unsigned char)(graphBuff[i] - 63) & 63;
+
+        for (int j = 0; j < g6NumSetBits[currByte]; j++)
         {
-            // If we are on the final byte, we know that the final
-            // numPaddingZeroes bits can be ignored, so we break out of the loop
-            if ((i == numChars) && j == numPaddingZeroes - 1)
-                break;
+            bitPos = 6 * i + g6SetBitPositions[currByte][j];
 
-            if (row == col)
+            row += bitPos - prevBitPos;
+            while (row >= col)
             {
-                row = 0;
+                row -= col;
                 col++;
             }
+            prevBitPos = bitPos;
 
-            bitValue = ((currByte >> j) & 1u) ? 1 : 0;
-            if (bitValue == 1)
+            if (col >= order)
+                return NOTOK;
+
+            u[batchSize] = row + firstVertex;
+            v[batchSize] = col + firstVertex;
+
+            if (++batchSize == G6_DECODE_BATCH_SIZE)
             {
-                // Also add the offset to the first vertex in in-memory storage,
-                // because the G6 file is 0-based, but im-memory storage may not be.
-                if (gp_DynamicAddEdge(theGraph,
-                                      row + gp_LowerBoundVertexStorage(theGraph), 0,
-                                      col + gp_LowerBoundVertexStorage(theGraph), 0) != OK)
+                if (gp_AddEdgesBulk(theGraph, u, v, batchSize, 0) != OK)
                     return NOTOK;
+                batchSize = 0;
             }
-
-            row++;
         }
     }
 
-    return OK;
+    return gp_AddEdgesBulk(theGraph, u, v, batchSize, 0);
 }
 
 void g6_FreeReader(G6ReadIteratorP *pG6ReadIterator)
@@ -621,13 +1528,15 @@ void g6_FreeReader(G6ReadIteratorP *pG6ReadIterator)
 
         if ((*pG6ReadIterator)->currGraphBuff != NULL)
         {
-            free((*pG6ReadIterator)->currGraphBuff);
+            gp_MemFree((*pG6ReadIterator)->currGraphBuff);
             (*pG6ReadIterator)->currGraphBuff = NULL;
         }
 
         (*pG6ReadIterator)->currGraph = NULL;
 
-        free((*pG6ReadIterator));
+        _g6_UnmapFile(*pG6ReadIterator);
+
+        gp_MemFree((*pG6ReadIterator));
         (*pG6ReadIterator) = NULL;
     }
 }
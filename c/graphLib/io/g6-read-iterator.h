@@ -23,9 +23,16 @@ extern "C"
 
     int g6_InitReaderWithString(G6ReadIteratorP theG6ReadIterator, char *inputString);
     int g6_InitReaderWithFileName(G6ReadIteratorP theG6ReadIterator, char const *const infileName);
+    int g6_InitReaderWithMappedFile(G6ReadIteratorP theG6ReadIterator, char const *const infileName);
 
+    int g6_SetReaderGraph(G6ReadIteratorP theG6ReadIterator, graphP theGraph);
     int g6_ReadGraph(G6ReadIteratorP theG6ReadIterator);
 
+    int g6_GetGraphCount(G6ReadIteratorP theG6ReadIterator);
+    int g6_SeekToGraph(G6ReadIteratorP theG6ReadIterator, int graphNum);
+    int g6_UseGraphIndexFile(G6ReadIteratorP theG6ReadIterator, int useGraphIndexFile);
+    int g6_WriteGraphIndexFile(G6ReadIteratorP theG6ReadIterator);
+
     int g6_EndReached(G6ReadIteratorP theG6ReadIterator);
     void g6_FreeReader(G6ReadIteratorP *pG6ReadIterator);
 
@@ -84,7 +84,7 @@ int g6_NewWriter(G6WriteIteratorP *pG6WriteIterator, graphP theGraph)
 
     // order, numCharsForOrder, numCharsForGraphEncoding, and currGraphBuffSize
     // all set to 0
-    (*pG6WriteIterator) = (G6WriteIteratorP)calloc(1, sizeof(G6WriteIteratorStruct));
+    (*pG6WriteIterator) = (G6WriteIteratorP)gp_MemCalloc(1, sizeof(G6WriteIteratorStruct));
 
     if ((*pG6WriteIterator) == NULL)
     {
@@ -303,7 +303,7 @@ int _g6_InitWriter(G6WriteIteratorP theG6WriteIterator)
         return NOTOK;
     }
 
-    theG6WriteIterator->columnOffsets = (size_t *)calloc(theG6WriteIterator->order + 1, sizeof(size_t));
+    theG6WriteIterator->columnOffsets = (size_t *)gp_MemCalloc(theG6WriteIterator->order + 1, sizeof(size_t));
 
     if (theG6WriteIterator->columnOffsets == NULL)
     {
@@ -319,7 +319,7 @@ int _g6_InitWriter(G6WriteIteratorP theG6WriteIterator)
     // Must add 3 bytes for newline, possible carriage return, and null terminator
     theG6WriteIterator->currGraphBuffSize = theG6WriteIterator->numCharsForOrder + theG6WriteIterator->numCharsForGraphEncoding + 3;
 
-    theG6WriteIterator->currGraphBuff = (char *)calloc(theG6WriteIterator->currGraphBuffSize, sizeof(char));
+    theG6WriteIterator->currGraphBuff = (char *)gp_MemCalloc(theG6WriteIterator->currGraphBuffSize, sizeof(char));
 
     if (theG6WriteIterator->currGraphBuff == NULL)
     {
@@ -556,20 +556,20 @@ void g6_FreeWriter(G6WriteIteratorP *pG6WriteIterator)
 
         if ((*pG6WriteIterator)->currGraphBuff != NULL)
         {
-            free((*pG6WriteIterator)->currGraphBuff);
+            gp_MemFree((*pG6WriteIterator)->currGraphBuff);
             (*pG6WriteIterator)->currGraphBuff = NULL;
         }
 
         if ((*pG6WriteIterator)->columnOffsets != NULL)
         {
-            free(((*pG6WriteIterator)->columnOffsets));
+            gp_MemFree(((*pG6WriteIterator)->columnOffsets));
             (*pG6WriteIterator)->columnOffsets = NULL;
         }
 
         // N.B. The G6WriteIterator doesn't "own" the graph, so we don't free it.
         (*pG6WriteIterator)->currGraph = NULL;
 
-        free((*pG6WriteIterator));
+        gp_MemFree((*pG6WriteIterator));
         (*pG6WriteIterator) = NULL;
     }
 }
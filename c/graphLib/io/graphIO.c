@@ -357,8 +357,9 @@ int _ReadLEDAGraph(graphP theGraph, strOrFileP inputContainer)
 {
     int ErrorCode = OK;
 
-    int graphType = 0;
+    int graphType = 0, enabledEdgeIndex = FALSE;
     int N = 0, M = 0, u = NIL, v = NIL;
+    int *uArray = NULL, *vArray = NULL;
     int zeroBasedOffset = (gp_LowerBoundVertexStorage(theGraph) == 0) ? 1 : 0;
     char Line[MAXLINE + 1];
 
@@ -409,27 +410,56 @@ int _ReadLEDAGraph(graphP theGraph, strOrFileP inputContainer)
     if (sf_ReadSkipWhitespace(inputContainer) != OK)
         return NOTOK;
 
-    /* Read and add each edge, omitting loops and parallel edges */
-    for (int m = 0; m < M; m++)
+    // The edges are read into arrays so they can be added by one call
+    // to gp_AddEdgesBulk(), for which the edge capacity is reserved
+    if (M > 0)
     {
-        if (sf_ReadSkipWhitespace(inputContainer) != OK)
-            return NOTOK;
-        if (sf_ReadInteger(&u, inputContainer) != OK)
-            return NOTOK;
-        if (sf_ReadSkipWhitespace(inputContainer) != OK)
-            return NOTOK;
-        if (sf_ReadInteger(&v, inputContainer) != OK)
-            return NOTOK;
-        if (sf_ReadSkipLineRemainder(inputContainer) != OK)
-            return NOTOK;
+        uArray = (int *)gp_MemAlloc((size_t)M * sizeof(int));
+        vArray = (int *)gp_MemAlloc((size_t)M * sizeof(int));
+        if (uArray == NULL || vArray == NULL ||
+            (M > gp_GetEdgeCapacity(theGraph) && gp_EnsureEdgeCapacity(theGraph, M) != OK))
+            ErrorCode = NOTOK;
+    }
 
-        if (u != v && !gp_IsNeighbor(theGraph, u - zeroBasedOffset, v - zeroBasedOffset))
+    /* Read each edge */
+    for (int m = 0; m < M && ErrorCode == OK; m++)
+    {
+        if (sf_ReadSkipWhitespace(inputContainer) != OK ||
+            sf_ReadInteger(&u, inputContainer) != OK ||
+            sf_ReadSkipWhitespace(inputContainer) != OK ||
+            sf_ReadInteger(&v, inputContainer) != OK ||
+            sf_ReadSkipLineRemainder(inputContainer) != OK)
+            ErrorCode = NOTOK;
+
+        else
         {
-            if ((ErrorCode = gp_DynamicAddEdge(theGraph, u - zeroBasedOffset, 0, v - zeroBasedOffset, 0)) != OK)
-                return ErrorCode;
+            uArray[m] = u - zeroBasedOffset;
+            vArray[m] = v - zeroBasedOffset;
         }
     }
 
+    // Add the edges, omitting loops and parallel edges. The edge index
+    // makes the parallel edge tests constant time, which matters when a
+    // vertex has high degree; if the index cannot be enabled, then the
+    // tests traverse adjacency lists instead.
+    if (ErrorCode == OK)
+    {
+        enabledEdgeIndex = gp_EnableEdgeIndex(theGraph) == OK;
+
+        ErrorCode = gp_AddEdgesBulk(theGraph, uArray, vArray, M, ADDEDGES_SKIPLOOPS | ADDEDGES_SKIPDUPLICATES);
+
+        if (enabledEdgeIndex)
+            gp_DisableEdgeIndex(theGraph);
+    }
+
+    if (uArray != NULL)
+        gp_MemFree(uArray);
+    if (vArray != NULL)
+        gp_MemFree(vArray);
+
+    if (ErrorCode != OK)
+        return ErrorCode;
+
     if (zeroBasedOffset)
         theGraph->graphFlags |= GRAPHFLAGS_ZEROBASEDIO;
 
@@ -708,7 +738,7 @@ int _WriteAdjMatrix(graphP theGraph, strOrFileP outputContainer)
         return NOTOK;
 
     // Allocate memory for storing a string expression of one row at a time
-    Row = (char *)malloc((gp_GetN(theGraph) + 2) * sizeof(char));
+    Row = (char *)gp_MemAlloc((gp_GetN(theGraph) + 2) * sizeof(char));
     if (Row == NULL)
         return NOTOK;
 
@@ -741,7 +771,7 @@ int _WriteAdjMatrix(graphP theGraph, strOrFileP outputContainer)
             return NOTOK;
     }
 
-    free(Row);
+    gp_MemFree(Row);
     Row = NULL;
 
     return OK;
@@ -963,7 +993,7 @@ int gp_Write(graphP theGraph, char const *fileName, int writeMode)
  * Writes the information of theGraph into a string that is returned
  * to the caller via the pointer pointer pOutputStr.
  * The string is owned by the caller and should be released with
- * free() when the caller doesn't need the string anymore.
+ * gp_MemFree() when the caller doesn't need the string anymore.
  * The format of the content written into the returned string is based
  * on writeMode: WRITE_G6, WRITE_GRAPHML, WRITE_ADJLIST, or WRITE_ADJMATRIX
  * (the WRITE_DEBUGINFO writeMode is not supported at this time)
@@ -971,7 +1001,7 @@ int gp_Write(graphP theGraph, char const *fileName, int writeMode)
  NOTE: For digraphs, only WRITE_ADJLIST and WRITE_GRAPHML are supported.
 
  Returns NOTOK on error, or OK on success along with an allocated string
-         *pOutputStr that the caller must free()
+         *pOutputStr that the caller must gp_MemFree()
  ********************************************************************/
 int gp_WriteToString(graphP theGraph, char **pOutputStr, int writeMode)
 {
@@ -994,7 +1024,7 @@ int gp_WriteToString(graphP theGraph, char **pOutputStr, int writeMode)
         RetVal = NOTOK;
     else if (pOutputStr != NULL && strlen(*pOutputStr) == 0)
     {
-        free((*pOutputStr));
+        gp_MemFree((*pOutputStr));
         pOutputStr = NULL;
         RetVal = NOTOK;
     }
@@ -1058,7 +1088,7 @@ int _WriteGraph(graphP theGraph, strOrFileP *pOutputContainer, int Mode)
             if (sf_fputs(extraData, (*pOutputContainer)) == EOF)
                 RetVal = NOTOK;
 
-            free(extraData);
+            gp_MemFree(extraData);
             extraData = NULL;
         }
     }
@@ -25,7 +25,7 @@ char *_sf_DuplicateString(char const *const str)
         return NULL;
 
     strLen = strlen(str) + 1;
-    copy = (char *)malloc(strLen * sizeof(char));
+    copy = (char *)gp_MemAlloc(strLen * sizeof(char));
     if (copy != NULL)
         memcpy(copy, str, strLen);
 
@@ -82,7 +82,7 @@ strOrFileP sf_NewInputContainer(char const *const inputStr, char const *const fi
         ((fileName == NULL) && (inputStr == NULL)))
         return NULL;
 
-    theStrOrFile = (strOrFileP)calloc(1, sizeof(strOrFileStruct));
+    theStrOrFile = (strOrFileP)gp_MemCalloc(1, sizeof(strOrFileStruct));
     if (theStrOrFile != NULL)
     {
         theStrOrFile->containerType = INPUT_CONTAINER;
@@ -176,7 +176,7 @@ strOrFileP sf_NewOutputContainer(char **pOutputStr, char const *const fileName)
         ((pOutputStr != NULL) && ((*pOutputStr) != NULL)))
         return NULL;
 
-    theStrOrFile = (strOrFileP)calloc(1, sizeof(strOrFileStruct));
+    theStrOrFile = (strOrFileP)gp_MemCalloc(1, sizeof(strOrFileStruct));
     if (theStrOrFile != NULL)
     {
         theStrOrFile->containerType = OUTPUT_CONTAINER;
@@ -673,13 +673,23 @@ char *sf_fgets(char *str, int count, strOrFileP theStrOrFile)
             char *theStrBuf = sb_GetReadString(theStrOrFile->theStrBuf);
             if (theStrBuf != NULL && sb_GetUnreadCharCount(theStrOrFile->theStrBuf) > 0)
             {
-                if (strncpy(
-                        str + charsToReadFromUngetBuf,
-                        theStrBuf,
-                        charsToReadFromStrOrFile) == NULL)
-                    return NULL;
+                // N.B. As with fgets(), at most one less than the requested
+                // number of characters are read, and reading stops after a
+                // \n, which is retained, so that the read position is left at
+                // the start of the next line
+                int numCharsToCopy = 0;
+
+                while (numCharsToCopy < charsToReadFromStrOrFile - 1 &&
+                       theStrBuf[numCharsToCopy] != '\0')
+                {
+                    if (theStrBuf[numCharsToCopy++] == '\n')
+                        break;
+                }
+
+                memcpy(str + charsToReadFromUngetBuf, theStrBuf, numCharsToCopy);
+                str[charsToReadFromUngetBuf + numCharsToCopy] = '\0';
 
-                sb_SetReadPos(theStrOrFile->theStrBuf, (sb_GetReadPos(theStrOrFile->theStrBuf) + charsToReadFromStrOrFile));
+                sb_SetReadPos(theStrOrFile->theStrBuf, (sb_GetReadPos(theStrOrFile->theStrBuf) + numCharsToCopy));
             }
             else if (charsToReadFromUngetBuf == 0)
                 return NULL;
@@ -878,13 +888,13 @@ void sf_Free(strOrFileP *pStrOrFile)
 
         if ((*pStrOrFile)->fileName != NULL)
         {
-            free((*pStrOrFile)->fileName);
+            gp_MemFree((*pStrOrFile)->fileName);
             (*pStrOrFile)->fileName = NULL;
         }
 
         (*pStrOrFile)->fileMode = NULL;
 
-        free(*pStrOrFile);
+        gp_MemFree(*pStrOrFile);
         (*pStrOrFile) = NULL;
     }
 }
@@ -25,14 +25,14 @@ strBufP sb_New(int capacity)
     if (capacity < 0)
         return NULL;
 
-    theStrBuf = (strBufP)malloc(sizeof(strBuf));
+    theStrBuf = (strBufP)gp_MemAlloc(sizeof(strBuf));
 
     if (theStrBuf != NULL)
     {
-        theStrBuf->buf = (char *)malloc((capacity + 1) * sizeof(char));
+        theStrBuf->buf = (char *)gp_MemAlloc((capacity + 1) * sizeof(char));
         if (theStrBuf->buf == NULL)
         {
-            free(theStrBuf);
+            gp_MemFree(theStrBuf);
             theStrBuf = NULL;
         }
     }
@@ -59,10 +59,10 @@ void sb_Free(strBufP *pStrBuf)
         (*pStrBuf)->capacity = (*pStrBuf)->size = (*pStrBuf)->readPos = 0;
 
         if ((*pStrBuf)->buf != NULL)
-            free((*pStrBuf)->buf);
+            gp_MemFree((*pStrBuf)->buf);
         (*pStrBuf)->buf = NULL;
 
-        free(*pStrBuf);
+        gp_MemFree(*pStrBuf);
         *pStrBuf = NULL;
     }
 }
@@ -195,13 +195,13 @@ int sb_ConcatString(strBufP theStrBuf, char const *s)
     if (theStrBuf->size + slen > theStrBuf->capacity)
     {
         int newLen = theStrBuf->size + slen > 2 * theStrBuf->capacity ? theStrBuf->size + slen : 2 * theStrBuf->capacity;
-        char *newBuf = (char *)malloc((newLen + 1) * sizeof(char));
+        char *newBuf = (char *)gp_MemAlloc((newLen + 1) * sizeof(char));
 
         if (newBuf == NULL)
             return NOTOK;
 
         strcpy(newBuf, theStrBuf->buf);
-        free(theStrBuf->buf);
+        gp_MemFree(theStrBuf->buf);
         theStrBuf->buf = newBuf;
         theStrBuf->capacity = newLen;
     }
@@ -256,7 +256,7 @@ char *sb_TakeString(strBufP theStrBuf)
         return NULL;
 
     theBuf = theStrBuf->buf;
-    theStrBuf->buf = (char *)malloc(sizeof(char));
+    theStrBuf->buf = (char *)gp_MemAlloc(sizeof(char));
     theStrBuf->buf[0] = '\0';
     theStrBuf->size = theStrBuf->capacity = 0;
 
@@ -7,6 +7,12 @@ See the LICENSE.TXT file for licensing information.
 #include <limits.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
+#include <intrin.h>
+#endif
 
 #include "appconst.h"
 
@@ -14,8 +20,9 @@ See the LICENSE.TXT file for licensing information.
 #include "apiutils.private.h"
 
 // The graphLib gp_ErrorMessage() and gp_Message() calls are suppressed by
-// default, but an application can turn them on if desired.
-unsigned quietMode = QUIETMODE_ALL;
+// default, but an application can turn them on if desired. Each thread has
+// its own quiet mode so that threads can use the library independently.
+static GP_THREAD_LOCAL unsigned quietMode = QUIETMODE_ALL;
 
 unsigned gp_GetQuietMode(void)
 {
@@ -80,30 +87,318 @@ void gp_LogErrorMessage(int lineNum, const char *srcFileName, const char *messag
     }
 }
 
+/********************************************************************
+ Random number generation
+
+ The generator is xoshiro256** (Blackman and Vigna), which is fast,
+ has a 256-bit state and passes the standard statistical test suites.
+ A generator's state is expanded from a 64-bit seed with splitmix64,
+ as recommended by the authors, so that nearby seeds (e.g. seed+K
+ for the K-th graph of a run) still produce unrelated streams.
+
+ Each thread has its own default generator so that threads can
+ generate random graphs without sharing (or locking) generator state.
+ ********************************************************************/
+
+static GP_THREAD_LOCAL randomGeneratorStruct threadRandomGenerator;
+static GP_THREAD_LOCAL int threadRandomGeneratorSeeded = FALSE;
+
+uint64_t _SplitMix64(uint64_t *pState);
+uint64_t _RotateLeft64(uint64_t x, int k);
+
+uint64_t _SplitMix64(uint64_t *pState)
+{
+    uint64_t z = (*pState += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t _RotateLeft64(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/********************************************************************
+ gp_SeedRandomGenerator()
+ Initializes the state of theGenerator from the given seed. The same
+ seed always produces the same sequence of random numbers.
+ ********************************************************************/
+
+void gp_SeedRandomGenerator(randomGeneratorP theGenerator, uint64_t seed)
+{
+    uint64_t splitMixState = seed;
+
+    if (theGenerator == NULL)
+        return;
+
+    theGenerator->s[0] = _SplitMix64(&splitMixState);
+    theGenerator->s[1] = _SplitMix64(&splitMixState);
+    theGenerator->s[2] = _SplitMix64(&splitMixState);
+    theGenerator->s[3] = _SplitMix64(&splitMixState);
+}
+
+/********************************************************************
+ gp_GetNextRandomBits()
+ Advances theGenerator and returns its next 64 random bits.
+ ********************************************************************/
+
+uint64_t gp_GetNextRandomBits(randomGeneratorP theGenerator)
+{
+    uint64_t *s = theGenerator->s;
+    uint64_t result = _RotateLeft64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+
+    s[3] = _RotateLeft64(s[3], 45);
+
+    return result;
+}
+
+/********************************************************************
+ gp_GetRandomNumberFromGenerator()
+ Returns a random number between NMin and NMax inclusive, using
+ theGenerator. If NMax < NMin, then NMin is returned.
+
+ Every number in the range is equally likely. Rather than reducing
+ the random bits modulo the range size, which favors small values
+ whenever the range size does not divide 2^32, the high 32 bits are
+ multiplied by the range size and the high half of the product is
+ the result. The rare products whose low half falls in the biased
+ zone are rejected and redrawn (Lemire's method), so there is no
+ division at all in the common case.
+ ********************************************************************/
+
+int gp_GetRandomNumberFromGenerator(randomGeneratorP theGenerator, int NMin, int NMax)
+{
+    uint64_t range, product;
+    uint32_t threshold;
+
+    if (NMax <= NMin)
+        return NMin;
+
+    range = (uint64_t)((int64_t)NMax - (int64_t)NMin) + 1;
+
+    // Only possible for NMin=INT_MIN and NMax=INT_MAX; any 32 bits will do
+    if (range > UINT32_MAX)
+        return (int)((int64_t)NMin + (int64_t)(gp_GetNextRandomBits(theGenerator) >> 32));
+
+    product = (gp_GetNextRandomBits(theGenerator) >> 32) * range;
+    if ((uint32_t)product < (uint32_t)range)
+    {
+        // threshold = 2^32 mod range
+        threshold = (uint32_t)(0 - (uint32_t)range) % (uint32_t)range;
+        while ((uint32_t)product < threshold)
+            product = (gp_GetNextRandomBits(theGenerator) >> 32) * range;
+    }
+
+    return (int)((int64_t)NMin + (int64_t)(product >> 32));
+}
+
+/********************************************************************
+ gp_GetThreadRandomGenerator()
+ Returns the calling thread's default generator. If it has not been
+ seeded with gp_SeedRandomNumber(), then on first use it is seeded
+ from the current time and the address of the thread's own generator,
+ which differs between threads that are running at the same time, so
+ each run and each thread gets a different stream of random numbers.
+ ********************************************************************/
+
+randomGeneratorP gp_GetThreadRandomGenerator(void)
+{
+    if (!threadRandomGeneratorSeeded)
+    {
+        uint64_t seed = ((uint64_t)time(NULL) << 32) ^ (uint64_t)(uintptr_t)&threadRandomGenerator;
+
+        gp_SeedRandomGenerator(&threadRandomGenerator, seed);
+        threadRandomGeneratorSeeded = TRUE;
+    }
+
+    return &threadRandomGenerator;
+}
+
+/********************************************************************
+ gp_SeedRandomNumber()
+ Seeds the calling thread's default generator, like srand().
+ ********************************************************************/
+
+void gp_SeedRandomNumber(unsigned int seed)
+{
+    gp_SeedRandomGenerator(&threadRandomGenerator, seed);
+    threadRandomGeneratorSeeded = TRUE;
+}
+
 /********************************************************************
  gp_GetRandomNumber()
  This function generates a random number between NMin and NMax
- inclusive.  It assumes that the caller has called srand().
- It calls rand(), but before truncating to the proper range,
- it adds the high bits of the rand() result into the low bits.
- The result of this is that the randomness appearing in the
- truncated bits also has an affect on the non-truncated bits.
+ inclusive.  It uses the calling thread's default generator, which
+ may have been seeded with gp_SeedRandomNumber().
  ********************************************************************/
 
 int gp_GetRandomNumber(int NMin, int NMax)
 {
-    int N = rand();
+    return gp_GetRandomNumberFromGenerator(gp_GetThreadRandomGenerator(), NMin, NMax);
+}
 
-    if (NMax < NMin)
-        return NMin;
+/********************************************************************
+ Memory allocation hooks
+
+ The allocator is stored as a process-wide setting since memory may be
+ allocated by one thread and freed by another, e.g. when a graph read
+ by a reader thread is processed by a worker thread.
+ ********************************************************************/
+
+static gp_MallocFunc allocatorMalloc = NULL;
+static gp_ReallocFunc allocatorRealloc = NULL;
+static gp_FreeFunc allocatorFree = NULL;
+static void *allocatorUserData = NULL;
+
+/********************************************************************
+ gp_SetAllocator()
+ Routes all graphLib memory allocation through the given functions,
+ or restores malloc(), realloc() and free() if all three are NULL.
+
+ Returns OK on success, NOTOK if only some of the functions are NULL.
+ ********************************************************************/
+
+int gp_SetAllocator(gp_MallocFunc mallocFunc, gp_ReallocFunc reallocFunc,
+                    gp_FreeFunc freeFunc, void *userData)
+{
+    if (mallocFunc == NULL || reallocFunc == NULL || freeFunc == NULL)
+    {
+        if (mallocFunc != NULL || reallocFunc != NULL || freeFunc != NULL)
+            return NOTOK;
+        userData = NULL;
+    }
 
-    N += ((N & 0xFFFF0000) >> 16);
-    N += ((N & 0x0000FF00) >> 8);
-    N &= 0x7FFFFFFF;
-    N %= (NMax - NMin + 1);
-    return N + NMin;
+    allocatorMalloc = mallocFunc;
+    allocatorRealloc = reallocFunc;
+    allocatorFree = freeFunc;
+    allocatorUserData = userData;
+
+    return OK;
 }
 
+/********************************************************************
+ gp_MemAlloc(), gp_MemCalloc(), gp_MemRealloc(), gp_MemFree()
+ The graphLib analogs of malloc(), calloc(), realloc() and free(),
+ which use the allocator set by gp_SetAllocator(), if any.
+ ********************************************************************/
+
+void *gp_MemAlloc(size_t size)
+{
+    return allocatorMalloc != NULL ? allocatorMalloc(size, allocatorUserData) : malloc(size);
+}
+
+void *gp_MemCalloc(size_t count, size_t size)
+{
+    void *ptr = NULL;
+
+    if (allocatorMalloc == NULL)
+        return calloc(count, size);
+
+    // Like calloc(), fail rather than allocate a wrapped-around size
+    if (size > 0 && count > ((size_t)-1) / size)
+        return NULL;
+
+    if ((ptr = allocatorMalloc(count * size, allocatorUserData)) != NULL)
+        memset(ptr, 0, count * size);
+
+    return ptr;
+}
+
+void *gp_MemRealloc(void *ptr, size_t size)
+{
+    return allocatorRealloc != NULL ? allocatorRealloc(ptr, size, allocatorUserData) : realloc(ptr, size);
+}
+
+void gp_MemFree(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    if (allocatorFree != NULL)
+        allocatorFree(ptr, allocatorUserData);
+    else
+        free(ptr);
+}
+
+/********************************************************************
+ _gp_AtomicLoad()
+ Atomically reads the integer at pValue, so that the writes made by
+ another thread before it stored the value with an atomic operation
+ are visible after the read.
+ ********************************************************************/
+
+int _gp_AtomicLoad(int *pValue)
+{
+#if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
+    return (int)_InterlockedCompareExchange((long volatile *)pValue, 0, 0);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(pValue, __ATOMIC_SEQ_CST);
+#else
+    return *pValue;
+#endif
+}
+
+/********************************************************************
+ _gp_AtomicStore()
+ Atomically sets the integer at pValue to newValue.
+ ********************************************************************/
+
+void _gp_AtomicStore(int *pValue, int newValue)
+{
+#if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
+    _InterlockedExchange((long volatile *)pValue, (long)newValue);
+#elif defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(pValue, newValue, __ATOMIC_SEQ_CST);
+#else
+    *pValue = newValue;
+#endif
+}
+
+/********************************************************************
+ _gp_AtomicIncrement()
+ Atomically increments the integer at pValue and returns the new value.
+ ********************************************************************/
+
+int _gp_AtomicIncrement(int *pValue)
+{
+#if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
+    return (int)_InterlockedIncrement((long volatile *)pValue);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __atomic_add_fetch(pValue, 1, __ATOMIC_SEQ_CST);
+#else
+    return ++(*pValue);
+#endif
+}
+
+/********************************************************************
+ _gp_AtomicCompareAndSwap()
+ Atomically sets the integer at pValue to newValue if it is equal to
+ expectedValue. Returns TRUE if the value was set, FALSE otherwise.
+ ********************************************************************/
+
+int _gp_AtomicCompareAndSwap(int *pValue, int expectedValue, int newValue)
+{
+#if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
+    return _InterlockedCompareExchange((long volatile *)pValue, (long)newValue, (long)expectedValue) == (long)expectedValue ? TRUE : FALSE;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __atomic_compare_exchange_n(pValue, &expectedValue, newValue, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+#else
+    if (*pValue != expectedValue)
+        return FALSE;
+    *pValue = newValue;
+    return TRUE;
+#endif
+}
 
 /********************************************************************
  debugNOTOK()
@@ -141,27 +436,115 @@ int debugNOTOK(void)
  a string to the file Edge_Addition_Planarity_Suite.LOG in the current
  working directory.
 
+ Each thread that logs has its own log file, so that the lines of the
+ threads are not interleaved. The first thread to log writes to the file
+ named above, and each other thread K writes to the file named
+ Edge_Addition_Planarity_Suite.K.LOG
+
  On first write, the file is created or cleared.
  Call this method with NULL to close the log file.
+
+ The log file of a thread is closed when the thread exits, if the
+ platform has thread exit callbacks (pthread keys or Windows fiber local
+ storage), and the log file of the thread that exits the process is
+ closed by an atexit() handler.
  ********************************************************************/
 
 void closeLogFileAtExit(void);
 
+static int logFileCount = 0;
+
+#if defined(WINDOWS)
+
+#include <windows.h>
+
+static INIT_ONCE logFileKeyOnce = INIT_ONCE_STATIC_INIT;
+static DWORD logFileKey = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI _CloseLogFileAtThreadExit(PVOID logfile)
+{
+    if (logfile != NULL)
+        fclose((FILE *)logfile);
+}
+
+static BOOL CALLBACK _InitLogFileKey(PINIT_ONCE initOnce, PVOID param, PVOID *context)
+{
+    (void)initOnce;
+    (void)param;
+    (void)context;
+
+    logFileKey = FlsAlloc(_CloseLogFileAtThreadExit);
+    if (atexit(closeLogFileAtExit) != 0)
+        gp_ErrorMessage("Unable to set up atexit() to close Edge_Addition_Planarity_Suite log file on exit");
+    return TRUE;
+}
+
+#define _InitLogFileCleanup() InitOnceExecuteOnce(&logFileKeyOnce, _InitLogFileKey, NULL, NULL)
+#define _SetLogFileCleanup(logfile) \
+    (logFileKey != FLS_OUT_OF_INDEXES ? (void)FlsSetValue(logFileKey, (PVOID)(logfile)) : (void)0)
+
+#elif defined(HAVE_PTHREAD_H)
+
+#include <pthread.h>
+
+static pthread_once_t logFileKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t logFileKey;
+static int logFileKeyCreated = FALSE;
+
+static void _CloseLogFileAtThreadExit(void *logfile)
+{
+    if (logfile != NULL)
+        fclose((FILE *)logfile);
+}
+
+static void _InitLogFileKey(void)
+{
+    logFileKeyCreated = pthread_key_create(&logFileKey, _CloseLogFileAtThreadExit) == 0;
+    if (atexit(closeLogFileAtExit) != 0)
+        gp_ErrorMessage("Unable to set up atexit() to close Edge_Addition_Planarity_Suite log file on exit");
+}
+
+#define _InitLogFileCleanup() pthread_once(&logFileKeyOnce, _InitLogFileKey)
+#define _SetLogFileCleanup(logfile) \
+    (logFileKeyCreated ? (void)pthread_setspecific(logFileKey, (void *)(logfile)) : (void)0)
+
+#else
+
+static int logFileAtExitSet = FALSE;
+
+static void _InitLogFileCleanup(void)
+{
+    if (_gp_AtomicCompareAndSwap(&logFileAtExitSet, FALSE, TRUE) &&
+        atexit(closeLogFileAtExit) != 0)
+        gp_ErrorMessage("Unable to set up atexit() to close Edge_Addition_Planarity_Suite log file on exit");
+}
+
+#define _SetLogFileCleanup(logfile) ((void)(logfile))
+
+#endif
+
 void _Log(char const *Str)
 {
-    static FILE *logfile = NULL;
-    static int triedlogfile = FALSE;
+    static GP_THREAD_LOCAL FILE *logfile = NULL;
+    static GP_THREAD_LOCAL int triedlogfile = FALSE;
 
     if (logfile == NULL && !triedlogfile)
     {
+        int logFileNum = _gp_AtomicIncrement(&logFileCount);
+        char logFileName[MAXLINE + 1];
+
         triedlogfile = TRUE;
-        if (atexit(closeLogFileAtExit) != 0)
-            gp_ErrorMessage("Unable to set up atexit() to close Edge_Addition_Planarity_Suite log file on exit");
+        if (logFileNum == 1)
+            sprintf(logFileName, "Edge_Addition_Planarity_Suite.LOG");
         else
-        {
-            if ((logfile = fopen("Edge_Addition_Planarity_Suite.LOG", WRITETEXT)) == NULL)
-                gp_ErrorMessage("Unable to open the Edge_Addition_Planarity_Suite log file");
-        }
+            sprintf(logFileName, "Edge_Addition_Planarity_Suite.%d.LOG", logFileNum);
+
+        _InitLogFileCleanup();
+
+        if ((logfile = fopen(logFileName, WRITETEXT)) == NULL)
+            gp_ErrorMessage("Unable to open the Edge_Addition_Planarity_Suite log file");
+        else
+            _SetLogFileCleanup(logfile);
     }
 
     if (logfile != NULL)
@@ -173,6 +556,7 @@ void _Log(char const *Str)
         }
         else
         {
+            _SetLogFileCleanup(NULL);
             fclose(logfile);
             logfile = NULL;
         }
@@ -190,7 +574,7 @@ void closeLogFileAtExit(void)
     _gp_Log(NULL);
 }
 
-static char LogStr[MAXLINE + 1];
+static GP_THREAD_LOCAL char LogStr[MAXLINE + 1];
 
 char *_MakeLogStr1(const char *format, int one)
 {
@@ -12,6 +12,7 @@ extern "C"
 #endif
 
 #include "stdio.h"
+#include <stdint.h>
 
 #define MAXLINE 1024
 
@@ -40,7 +41,11 @@ extern "C"
 #endif
 
     // These methods control whether gp_ErrorMessage() and gp_Message() calls
-    // emit output or skip producing output (the default)
+    // emit output or skip producing output (the default).
+    // The quiet mode is a per-thread setting, so each thread that should emit
+    // output must set it. NOTE: this is a change from earlier releases, in
+    // which the quiet mode was process-wide. A thread now starts with the
+    // default QUIETMODE_ALL even if another thread has called gp_SetQuietMode().
     unsigned gp_GetQuietMode(void);
     void gp_SetQuietMode(unsigned newQuietMode);
 
@@ -55,8 +60,55 @@ extern "C"
 #define gp_ErrorMessage(...) (gp_LogErrorMessage(__LINE__, __FILE__, __VA_ARGS__))
     void gp_LogErrorMessage(int lineNum, const char *srcFileName, const char *message, ...) FORMAT_PRINTF(3, 4);
 
+    // A random number generator (xoshiro256**) whose state is owned by the
+    // caller, so that independent streams of random numbers can be produced,
+    // e.g. one per graph or per thread. A generator must be seeded before use.
+    typedef struct
+    {
+        uint64_t s[4];
+    } randomGeneratorStruct;
+
+    typedef randomGeneratorStruct *randomGeneratorP;
+
+    void gp_SeedRandomGenerator(randomGeneratorP theGenerator, uint64_t seed);
+    uint64_t gp_GetNextRandomBits(randomGeneratorP theGenerator);
+    int gp_GetRandomNumberFromGenerator(randomGeneratorP theGenerator, int NMin, int NMax);
+
+    // Each thread also has a default generator, which is used by the methods
+    // below and by the random graph generators of a graph that has no generator
+    // of its own (see gp_SetRandomGenerator()). Unless gp_SeedRandomNumber() is
+    // called, each thread's default generator is seeded on first use from the
+    // current time and the thread, so it differs between runs and threads.
+    // NOTE: this is a change from earlier releases, in which gp_GetRandomNumber()
+    // called rand(). The default generator does not use rand(), so srand() no
+    // longer affects it; call gp_SeedRandomNumber() (in each thread) instead to
+    // get the same random numbers in every run.
+    randomGeneratorP gp_GetThreadRandomGenerator(void);
+    void gp_SeedRandomNumber(unsigned int seed);
     int gp_GetRandomNumber(int NMin, int NMax);
 
+    // Memory allocation hooks. By default, graphLib allocates memory with
+    // malloc(), realloc() and free(). After gp_SetAllocator(), every graphLib
+    // allocation is made through the given functions instead, which also get
+    // the given user data, e.g. to allocate from a particular NUMA node or to
+    // account for the memory used per request. The allocator is process-wide,
+    // so it should be set before any graphLib objects are created, and memory
+    // obtained from one allocator must not be released with another. Memory
+    // that graphLib returns to the caller, such as the string produced by
+    // gp_WriteToString(), must then be released with gp_MemFree().
+    // Passing NULL for all three functions restores the default allocator.
+    typedef void *(*gp_MallocFunc)(size_t size, void *userData);
+    typedef void *(*gp_ReallocFunc)(void *ptr, size_t size, void *userData);
+    typedef void (*gp_FreeFunc)(void *ptr, void *userData);
+
+    int gp_SetAllocator(gp_MallocFunc mallocFunc, gp_ReallocFunc reallocFunc,
+                        gp_FreeFunc freeFunc, void *userData);
+
+    void *gp_MemAlloc(size_t size);
+    void *gp_MemCalloc(size_t count, size_t size);
+    void *gp_MemRealloc(void *ptr, size_t size);
+    void gp_MemFree(void *ptr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,30 @@ extern "C"
 {
 #endif
 
+    /* PRIVATE DEFINITIONS FOR THREAD SAFETY.
+
+       Library state that must not be shared among threads, such as the quiet
+       mode, the random number generator state and the logging buffers, is
+       declared with GP_THREAD_LOCAL so that each thread has its own copy.
+
+       State that must be shared, such as extension module IDs, is assigned
+       once with the atomic operations below, after which it is only read. */
+
+#if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
+#define GP_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define GP_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+#define GP_THREAD_LOCAL __thread
+#else
+#define GP_THREAD_LOCAL
+#endif
+
+    int _gp_AtomicLoad(int *pValue);
+    void _gp_AtomicStore(int *pValue, int newValue);
+    int _gp_AtomicIncrement(int *pValue);
+    int _gp_AtomicCompareAndSwap(int *pValue, int expectedValue, int newValue);
+
     /* PRIVATE FUNCTIONS FOR ADDITIONAL INFORMATIONAL LOGGING.
 
        If LOGGING is defined by uncommenting it below, then log-related lines
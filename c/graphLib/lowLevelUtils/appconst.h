@@ -90,4 +90,24 @@ extern int debugNOTOK(void);
 #define NIL_CHAR 0xFF
 #endif
 
+// Define GP_SMALL_INDEX (e.g. with configure --enable-small-index) to store the
+// vertex and edge indices and the flags in the graph data structures as 16-bit
+// values. This roughly halves the memory used per graph, which is worthwhile
+// when testing very many small graphs, such as all graphs of a small order.
+// The vertex and edge record storage is then limited to GP_INDEX_MAX locations,
+// so gp_EnsureVertexCapacity() and gp_EnsureEdgeCapacity() fail for larger
+// graphs, and the flags bits 16 and higher are not available to applications.
+// Programs using the library must be compiled with the same setting.
+#include <limits.h>
+
+#ifdef GP_SMALL_INDEX
+typedef short GP_INDEX_T;
+typedef unsigned short GP_FLAGS_T;
+#define GP_INDEX_MAX SHRT_MAX
+#else
+typedef int GP_INDEX_T;
+typedef unsigned GP_FLAGS_T;
+#define GP_INDEX_MAX INT_MAX
+#endif
+
 #endif
@@ -80,13 +80,13 @@ listCollectionP LCNew(int N)
      if (N <= 0)
           return theListColl;
 
-     theListColl = (listCollectionP)malloc(sizeof(listCollectionStruct));
+     theListColl = (listCollectionP)gp_MemAlloc(sizeof(listCollectionStruct));
      if (theListColl != NULL)
      {
-          theListColl->List = (lcnode *)malloc(N * sizeof(lcnode));
+          theListColl->List = (lcnode *)gp_MemAlloc(N * sizeof(lcnode));
           if (theListColl->List == NULL)
           {
-               free(theListColl);
+               gp_MemFree(theListColl);
                theListColl = NULL;
           }
           else
@@ -108,9 +108,9 @@ void LCFree(listCollectionP *pListColl)
           return;
 
      if ((*pListColl)->List != NULL)
-          free((*pListColl)->List);
+          gp_MemFree((*pListColl)->List);
 
-     free(*pListColl);
+     gp_MemFree(*pListColl);
      *pListColl = NULL;
 }
 
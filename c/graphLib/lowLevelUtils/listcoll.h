@@ -15,9 +15,12 @@ extern "C"
 /* This include is needed for memset and memcpy */
 #include <string.h>
 
+/* This include is needed for GP_INDEX_T and NIL_CHAR */
+#include "appconst.h"
+
         typedef struct
         {
-                int prev, next;
+                GP_INDEX_T prev, next;
         } lcnode;
 
         struct listCollectionStruct
@@ -32,6 +35,10 @@ extern "C"
         listCollectionP LCNew(int N);
         void LCFree(listCollectionP *pListColl);
 
+// The number of bytes allocated for a list collection (0 for NULL)
+#define LCGetMemoryUsage(listColl) \
+        ((listColl) == NULL ? 0 : sizeof(listCollectionStruct) + (size_t)(listColl)->N * sizeof(lcnode))
+
         void LCInsertAfter(listCollectionP listColl, int theAnchor, int theNewNode);
         void LCInsertBefore(listCollectionP listColl, int theAnchor, int theNewNode);
 
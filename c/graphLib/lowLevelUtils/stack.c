@@ -12,14 +12,14 @@ stackP sp_New(int capacity)
 {
     stackP theStack;
 
-    theStack = (stackP)malloc(sizeof(stackStruct));
+    theStack = (stackP)gp_MemAlloc(sizeof(stackStruct));
 
     if (theStack != NULL)
     {
-        theStack->S = (int *)malloc(capacity * sizeof(int));
+        theStack->S = (int *)gp_MemAlloc(capacity * sizeof(int));
         if (theStack->S == NULL)
         {
-            free(theStack);
+            gp_MemFree(theStack);
             theStack = NULL;
         }
     }
@@ -41,9 +41,9 @@ void sp_Free(stackP *pStack)
     (*pStack)->capacity = (*pStack)->size = 0;
 
     if ((*pStack)->S != NULL)
-        free((*pStack)->S);
+        gp_MemFree((*pStack)->S);
     (*pStack)->S = NULL;
-    free(*pStack);
+    gp_MemFree(*pStack);
 
     *pStack = NULL;
 }
@@ -34,6 +34,10 @@ extern "C"
 
 #define sp_GetCapacity(theStack) (theStack->capacity)
 
+// The number of bytes allocated for a stack (0 for a NULL stack)
+#define sp_GetMemoryUsage(theStack) \
+        ((theStack) == NULL ? 0 : sizeof(stackStruct) + (size_t)(theStack)->capacity * sizeof(int))
+
 #ifndef SPEED_MACROS
 
         int sp_ClearStack(stackP theStack);
@@ -351,7 +351,7 @@ int _ComputeEdgePositions(DrawPlanarContext *context)
 
     // Sort the vertices by vertical position (in linear time)
 
-    if ((vertexOrder = (int *)malloc(gp_GetN(theEmbedding) * sizeof(int))) == NULL)
+    if ((vertexOrder = (int *)gp_MemAlloc(gp_GetN(theEmbedding) * sizeof(int))) == NULL)
     {
         return NOTOK;
     }
@@ -368,7 +368,7 @@ int _ComputeEdgePositions(DrawPlanarContext *context)
 
     if (gp_GetM(theEmbedding) > 0 && (edgeList = LCNew(gp_LowerBoundEdges(theEmbedding) / 2 + gp_GetM(theEmbedding))) == NULL)
     {
-        free(vertexOrder);
+        gp_MemFree(vertexOrder);
         vertexOrder = NULL;
 
         return NOTOK;
@@ -504,7 +504,7 @@ int _ComputeEdgePositions(DrawPlanarContext *context)
     // Clean up and return
     LCFree(&edgeList);
 
-    free(vertexOrder);
+    gp_MemFree(vertexOrder);
     vertexOrder = NULL;
 
     _gp_LogLine("graphDrawPlanar.c/_ComputeEdgePositions() end\n");
@@ -789,7 +789,7 @@ int _BreakTie(DrawPlanarContext *context, int BicompRoot, int W, int WPrevLink)
  _RenderToString()
  Draws the previously calculated visibility representation in a
  string of size (M+1)*2N + 1 characters, which should be deallocated
- with free().
+ with gp_MemFree().
 
  Returns NULL on failure, or the string containing the visibility
  representation otherwise.  The string can be printed using %s,
@@ -807,7 +807,7 @@ char *_RenderToString(graphP theEmbedding)
         int zeroBasedVertexOffset = 0;
         int n, m, v, vRange, eRange, Mid, Pos;
         int e;
-        char *visRep = (char *)malloc(sizeof(char) * ((M + 1) * 2 * N + 1));
+        char *visRep = (char *)gp_MemAlloc(sizeof(char) * ((M + 1) * 2 * N + 1));
         char numBuffer[32];
 
         if (visRep == NULL)
@@ -819,7 +819,7 @@ char *_RenderToString(graphP theEmbedding)
         // allow edge changes).
         if (sp_NonEmpty(theEmbedding->edgeHoles))
         {
-            free(visRep);
+            gp_MemFree(visRep);
             visRep = NULL;
 
             return NULL;
@@ -898,7 +898,7 @@ char *_RenderToString(graphP theEmbedding)
 
  Creates a rendition of the planar graph visibility representation
  as a string, and return it via the pRenditionString parameter.
- The caller can use free() to get rid of the returned string after use.
+ The caller can use gp_MemFree() to get rid of the returned string after use.
 
  Returns NOTOK for any error, OK otherwise.
  ********************************************************************/
@@ -948,7 +948,7 @@ int gp_DrawPlanar_RenderToFile(graphP theEmbedding, char *theFileName)
         {
             fprintf(outfile, "%s", theRendition);
 
-            free(theRendition);
+            gp_MemFree(theRendition);
             theRendition = NULL;
         }
 
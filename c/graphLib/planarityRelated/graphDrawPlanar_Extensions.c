@@ -12,7 +12,7 @@ See the LICENSE.TXT file for licensing information.
 
 #include <stdlib.h>
 
-extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+extern void _ClearVertexVisitedFlags(graphP theGraph);
 
 extern void _CollectDrawingData(DrawPlanarContext *context, int RootVertex, int W, int WPrevLink);
 extern int _BreakTie(DrawPlanarContext *context, int BicompRoot, int W, int WPrevLink);
@@ -44,7 +44,9 @@ int _DrawPlanar_CheckObstructionIntegrity(graphP theGraph, graphP origGraph);
 int _DrawPlanar_EnsureVertexCapacity(graphP theGraph, int N);
 void _DrawPlanar_ResetGraphStorage(graphP theGraph);
 int _DrawPlanar_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity);
+int _DrawPlanar_CompactEdgeStorage(graphP theGraph, int *oldToNewMap);
 int _DrawPlanar_SortVertices(graphP theGraph);
+void _DrawPlanar_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail);
 
 int _DrawPlanar_ReadPostprocess(graphP theGraph, char *extraData);
 int _DrawPlanar_WritePostprocess(graphP theGraph, char **pExtraData);
@@ -102,7 +104,7 @@ int gp_ExtendWith_DrawPlanar(graphP theGraph)
         return NOTOK;
 
     // Allocate a new extension context
-    context = (DrawPlanarContext *)malloc(sizeof(DrawPlanarContext));
+    context = (DrawPlanarContext *)gp_MemAlloc(sizeof(DrawPlanarContext));
     if (context == NULL)
     {
         return NOTOK;
@@ -130,7 +132,9 @@ int gp_ExtendWith_DrawPlanar(graphP theGraph)
     context->functions.fpEnsureVertexCapacity = _DrawPlanar_EnsureVertexCapacity;
     context->functions.fpResetGraphStorage = _DrawPlanar_ResetGraphStorage;
     context->functions.fpEnsureEdgeCapacity = _DrawPlanar_EnsureEdgeCapacity;
+    context->functions.fpCompactEdgeStorage = _DrawPlanar_CompactEdgeStorage;
     context->functions.fpSortVertices = _DrawPlanar_SortVertices;
+    context->functions.fpGetMemoryUsage = _DrawPlanar_GetMemoryUsage;
 
     context->functions.fpReadPostprocess = _DrawPlanar_ReadPostprocess;
     context->functions.fpWritePostprocess = _DrawPlanar_WritePostprocess;
@@ -196,7 +200,7 @@ void _DrawPlanar_ClearStructures(DrawPlanarContext *context)
     if (!context->initialized)
     {
         // Before initialization, the pointers are stray, not NULL
-        // Once NULL or allocated, free() or LCFree() can do the job
+        // Once NULL or allocated, gp_MemFree() or LCFree() can do the job
         context->E = NULL;
         context->VI = NULL;
 
@@ -208,12 +212,12 @@ void _DrawPlanar_ClearStructures(DrawPlanarContext *context)
     {
         if (context->E != NULL)
         {
-            free(context->E);
+            gp_MemFree(context->E);
             context->E = NULL;
         }
         if (context->VI != NULL)
         {
-            free(context->VI);
+            gp_MemFree(context->VI);
             context->VI = NULL;
         }
 
@@ -235,8 +239,8 @@ int _DrawPlanar_CreateStructures(DrawPlanarContext *context)
     if (gp_GetN(theGraph) <= 0)
         return NOTOK;
 
-    if ((context->E = (DrawPlanar_EdgeRecP)malloc(Esize * sizeof(DrawPlanar_EdgeRec))) == NULL ||
-        (context->VI = (DrawPlanar_VertexInfoP)malloc(VIsize * sizeof(DrawPlanar_VertexInfo))) == NULL)
+    if ((context->E = (DrawPlanar_EdgeRecP)gp_MemAlloc(Esize * sizeof(DrawPlanar_EdgeRec))) == NULL ||
+        (context->VI = (DrawPlanar_VertexInfoP)gp_MemAlloc(VIsize * sizeof(DrawPlanar_VertexInfo))) == NULL)
     {
         return NOTOK;
     }
@@ -270,6 +274,33 @@ int _DrawPlanar_InitStructures(DrawPlanarContext *context)
     return OK;
 }
 
+/********************************************************************
+ _DrawPlanar_GetMemoryUsage()
+ ********************************************************************/
+
+void _DrawPlanar_GetMemoryUsage(graphP theGraph, graphMemoryUsageP detail)
+{
+    DrawPlanarContext *context = NULL;
+    size_t bytes = 0;
+
+    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+
+    if (context != NULL)
+    {
+        // Get the memory usage of the base class(es)
+        context->functions.fpGetMemoryUsage(theGraph, detail);
+
+        bytes = sizeof(DrawPlanarContext);
+
+        if (context->E != NULL)
+            bytes += (size_t)gp_UpperBoundEdgeStorage(theGraph) * sizeof(DrawPlanar_EdgeRec);
+        if (context->VI != NULL)
+            bytes += (size_t)gp_UpperBoundVertices(theGraph) * sizeof(DrawPlanar_VertexInfo);
+
+        gp_AddExtensionMemoryUsage(detail, DRAWPLANAR_ID, bytes);
+    }
+}
+
 /********************************************************************
  _DrawPlanar_DupContext()
  ********************************************************************/
@@ -277,7 +308,7 @@ int _DrawPlanar_InitStructures(DrawPlanarContext *context)
 void *_DrawPlanar_DupContext(void *pContext, void *theGraph)
 {
     DrawPlanarContext *context = (DrawPlanarContext *)pContext;
-    DrawPlanarContext *newContext = (DrawPlanarContext *)malloc(sizeof(DrawPlanarContext));
+    DrawPlanarContext *newContext = (DrawPlanarContext *)gp_MemAlloc(sizeof(DrawPlanarContext));
 
     if (newContext != NULL)
     {
@@ -359,7 +390,7 @@ void _DrawPlanar_FreeContext(void *pContext)
     DrawPlanarContext *context = (DrawPlanarContext *)pContext;
 
     _DrawPlanar_ClearStructures(context);
-    free(pContext);
+    gp_MemFree(pContext);
 }
 
 /********************************************************************
@@ -440,7 +471,7 @@ int _DrawPlanar_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
     newEsize = gp_UpperBoundEdgeStorage(theGraph);
 
     // We must successfully allocate the new parallel edge array
-    newE = (DrawPlanar_EdgeRecP)malloc(newEsize * sizeof(DrawPlanar_EdgeRec));
+    newE = (DrawPlanar_EdgeRecP)gp_MemAlloc(newEsize * sizeof(DrawPlanar_EdgeRec));
     if (newE == NULL)
         return NOTOK;
 
@@ -452,11 +483,43 @@ int _DrawPlanar_EnsureEdgeCapacity(graphP theGraph, int requiredEdgeCapacity)
 
     // Set the new edge array into the context and free the old one
     context->E = newE;
-    free(oldE);
+    gp_MemFree(oldE);
 
     return OK;
 }
 
+/********************************************************************
+ _DrawPlanar_CompactEdgeStorage()
+ Moves the visibility representation of each edge along with its edge
+ records, so a valid drawing remains valid.
+ ********************************************************************/
+
+int _DrawPlanar_CompactEdgeStorage(graphP theGraph, int *oldToNewMap)
+{
+    DrawPlanarContext *context = NULL;
+    int e, newUpperBound = gp_LowerBoundEdges(theGraph) + (gp_GetM(theGraph) << 1);
+
+    gp_FindExtension(theGraph, DRAWPLANAR_ID, (void *)&context);
+    if (context == NULL)
+        return NOTOK;
+
+    // The base class has not yet compacted the graph, so the upper bound
+    // of the edges still includes the edge holes
+    if (context->E != NULL)
+    {
+        for (e = gp_LowerBoundEdges(theGraph); e < gp_UpperBoundEdges(theGraph); e++)
+        {
+            if (oldToNewMap[e] != NIL)
+                context->E[oldToNewMap[e]] = context->E[e];
+        }
+
+        for (e = newUpperBound; e < gp_UpperBoundEdges(theGraph); e++)
+            _DrawPlanar_InitEdgeRec(context, e);
+    }
+
+    return context->functions.fpCompactEdgeStorage(theGraph, oldToNewMap);
+}
+
 /********************************************************************
  ********************************************************************/
 
@@ -488,7 +551,7 @@ int _DrawPlanar_SortVertices(graphP theGraph)
             // to the index values of the vertices.  This could be done very easily with an extra array in
             // which, for each v, newVI[index of v] = VI[v].  However, this loop avoids memory allocation
             // by performing the operation (almost) in-place, except for the pre-existing visitation flags.
-            _ClearVertexVisitedFlags(theGraph, FALSE);
+            _ClearVertexVisitedFlags(theGraph);
             for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
             {
                 // If the correct data has already been placed into position v
@@ -781,7 +844,7 @@ int _DrawPlanar_WritePostprocess(graphP theGraph, char **pExtraData)
         {
             // NOTE: We currently do not support stacking WritePostprocess calls
             // from multiple extensions; it wouldn't be hard, we just don't ;)
-            free((*pExtraData));
+            gp_MemFree((*pExtraData));
             (*pExtraData) = NULL;
 
             return NOTOK;
@@ -798,7 +861,7 @@ int _DrawPlanar_WritePostprocess(graphP theGraph, char **pExtraData)
             if (!context->drawingDataValid)
                 return OK;
 
-            extraData = (char *)calloc((1 + gp_GetN(theGraph) + 2 * gp_GetM(theGraph) + 1) * maxLineSize, sizeof(char));
+            extraData = (char *)gp_MemCalloc((1 + gp_GetN(theGraph) + 2 * gp_GetM(theGraph) + 1) * maxLineSize, sizeof(char));
 
             if (extraData == NULL)
                 return NOTOK;
@@ -817,7 +880,7 @@ int _DrawPlanar_WritePostprocess(graphP theGraph, char **pExtraData)
             // and line array size are needed to handle very large graphs
             if (gp_GetN(theGraph) > 2000000000)
             {
-                free(extraData);
+                gp_MemFree(extraData);
                 extraData = NULL;
 
                 return NOTOK;
@@ -18,24 +18,35 @@ See the LICENSE.TXT file for licensing information.
 #include "../homeomorphSearch/graphK33Search.private.h"
 #include "../homeomorphSearch/graphK4Search.private.h"
 
+// Includes needed by _ExtendForEmbedFlags()
+#include "graphDrawPlanar.h"
+#include "../homeomorphSearch/graphK23Search.h"
+#include "../homeomorphSearch/graphK33Search.h"
+#include "../homeomorphSearch/graphK4Search.h"
+
 // For LOGGING-related declarations
 #include "../lowLevelUtils/apiutils.private.h"
 
 /* Imported functions */
 
-extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+extern void _ClearVertexVisitedFlags(graphP theGraph);
 extern int _FillVertexVisitedIndexes(graphP theGraph, int FillValue);
 
 extern int _IsolateKuratowskiSubgraph(graphP theGraph, int v, int R);
 extern int _IsolateOuterplanarObstruction(graphP theGraph, int v, int R);
 
 extern void _InitVertexRec(graphP theGraph, int v);
+extern void _InitIsolatorContext(graphP theGraph);
 
 extern int _gp_FindEdge(graphP theGraph, int u, int v);
 
 /* Private functions (some are exported to system only) */
 
 int _gp_EmbedFlagsValid(graphP theGraph, int embedFlags);
+int _ExtendForEmbedFlags(graphP theGraph, unsigned embedFlags);
+int _DecideByPrefilters(graphP theGraph, int *pResult);
+int _HasBranchVertices(graphP theGraph, int numBranchVertices);
+int _HasMoreSimpleEdges(graphP theGraph, int maxEdges);
 int _EmbeddingInitialize(graphP theGraph);
 int _EmbeddingInitialize_Optimized(graphP theGraph);
 int _EmbeddingInitialize_Incremental(graphP theGraph);
@@ -60,6 +71,10 @@ int _OrientVerticesInBicomp(graphP theGraph, int BicompRoot, int PreserveSigns);
 int _OrientExternalFacePath(graphP theGraph, int u, int v, int w, int x);
 int _JoinBicomps(graphP theGraph);
 
+/* Private data */
+
+static GP_THREAD_LOCAL embedPrefilterStatsStruct embedPrefilterStats;
+
 /********************************************************************
  gp_Embed()
 
@@ -97,17 +112,52 @@ int _JoinBicomps(graphP theGraph);
   The algorithm extension for gp_Embed() is encoded in the embedFlags,
   and the details of the return value can be found in the extension
   module that defines the embedding flag.
+
+  If EMBEDFLAGS_PLANAR or EMBEDFLAGS_OUTERPLANAR is combined with the
+  EMBEDFLAGS_TESTONLY modifier, then only the return value is computed.
+  The result is taken from the prefilters if one of them applies (see
+  _DecideByPrefilters()).  Otherwise, the embedder stops at the first
+  blocked bicomp without isolating an obstruction, and the
+  postprocessing of an embedding is skipped.
+
+  The prefilters are not used without EMBEDFLAGS_TESTONLY.  The edge
+  and branch vertex counts prove that a graph is nonembeddable, but
+  they do not identify an obstructing subgraph, so a caller that wants
+  the obstruction still needs the embedder to isolate it.  A caller
+  that only wants obstructions for some graphs can use the
+  EMBEDFLAGS_DEFERISOLATION modifier below instead.
+
+  If EMBEDFLAGS_PLANAR or EMBEDFLAGS_OUTERPLANAR is combined with the
+  EMBEDFLAGS_DEFERISOLATION modifier, then the embedder also stops at
+  the first blocked bicomp, but the blockage is recorded so that the
+  obstruction can be isolated later by gp_IsolateObstruction().
  ********************************************************************/
 
 int gp_Embed(graphP theGraph, unsigned embedFlags)
 {
     int v, e, c;
     int RetVal = OK;
+    unsigned testOnly = embedFlags & EMBEDFLAGS_TESTONLY;
+    unsigned deferIsolation = embedFlags & EMBEDFLAGS_DEFERISOLATION;
+
+    embedFlags &= ~(EMBEDFLAGS_TESTONLY | EMBEDFLAGS_DEFERISOLATION);
 
     // Basic safety checks
     if (theGraph == NULL || embedFlags == 0 || gp_GetEmbedFlags(theGraph) != 0)
         return NOTOK;
 
+    // The test-only and deferred isolation modifiers are only supported
+    // by the core algorithms, and they are mutually exclusive
+    if ((testOnly || deferIsolation) && embedFlags != EMBEDFLAGS_PLANAR && embedFlags != EMBEDFLAGS_OUTERPLANAR)
+        return NOTOK;
+
+    if (testOnly && deferIsolation)
+        return NOTOK;
+
+    // The embedder rebuilds the adjacency lists directly, so any edge
+    // index attached by gp_EnableEdgeIndex() would become stale
+    gp_DisableEdgeIndex(theGraph);
+
     // Preprocessing
     if (!_gp_EmbedFlagsValid(theGraph, embedFlags))
     {
@@ -130,7 +180,11 @@ int gp_Embed(graphP theGraph, unsigned embedFlags)
             return NOTOK;
     }
 
-    theGraph->embedFlags = embedFlags;
+    theGraph->embedFlags = embedFlags | testOnly | deferIsolation;
+
+    // In test-only mode, the counts of edges and branch vertices may suffice
+    if (testOnly && _DecideByPrefilters(theGraph, &RetVal))
+        return RetVal;
 
     // Initialize embedding data structures and allow extension algorithms
     // that overload the function to postprocess the DFS
@@ -180,7 +234,359 @@ int gp_Embed(graphP theGraph, unsigned embedFlags)
     // Postprocessing to orient the embedding and merge any remaining separated bicomps.
     // Some extension algorithms may overload this function, e.g. to do nothing if they
     // have no need of an embedding.
-    return theGraph->functions->fpEmbedPostprocess(theGraph, v, RetVal);
+    RetVal = theGraph->functions->fpEmbedPostprocess(theGraph, v, RetVal);
+
+    // The deferred isolation modifier only remains set if an isolation is pending
+    if (RetVal != NONEMBEDDABLE)
+        theGraph->embedFlags &= ~EMBEDFLAGS_DEFERISOLATION;
+
+    // Record that the graph contains a planar or outerplanar embedding, which
+    // is needed by the methods that add edges to it (see gp_TryAddEdgesToEmbedding()).
+    // The flag is cleared as soon as an edge is added, deleted, hidden or restored.
+    if (RetVal == OK && !testOnly &&
+        (embedFlags == EMBEDFLAGS_PLANAR || embedFlags == EMBEDFLAGS_OUTERPLANAR))
+        theGraph->graphFlags |= GRAPHFLAGS_EMBEDDED;
+
+    return RetVal;
+}
+
+/********************************************************************
+ gp_IsolateObstruction()
+
+ After gp_Embed() with the EMBEDFLAGS_DEFERISOLATION modifier returns
+ NONEMBEDDABLE, this method isolates the obstruction in theGraph, just
+ as gp_Embed() would have done without the modifier, using the vertex
+ and bicomp root at which the embedder was blocked, as kept in the
+ isolator context.  Afterward, the modifier is cleared from the graph's
+ embedFlags, so the result can be checked by gp_TestEmbedResultIntegrity().
+
+ Returns NONEMBEDDABLE if the obstruction was isolated,
+         NOTOK if no isolation is pending or on internal error
+ ********************************************************************/
+
+int gp_IsolateObstruction(graphP theGraph)
+{
+    int v, R;
+
+    if (theGraph == NULL || theGraphIC(theGraph) == NULL ||
+        !(gp_GetEmbedFlags(theGraph) & EMBEDFLAGS_DEFERISOLATION))
+        return NOTOK;
+
+    v = theGraphIC(theGraph)->v;
+    R = theGraphIC(theGraph)->r;
+
+    theGraph->embedFlags &= ~EMBEDFLAGS_DEFERISOLATION;
+
+    if (gp_IsNotVertex(theGraph, v) || !gp_IsVirtualVertex(theGraph, R))
+        return NOTOK;
+
+    if (gp_GetEmbedFlags(theGraph) == EMBEDFLAGS_PLANAR)
+    {
+        if (_IsolateKuratowskiSubgraph(theGraph, v, R) != OK)
+            return NOTOK;
+    }
+    else if (gp_GetEmbedFlags(theGraph) == EMBEDFLAGS_OUTERPLANAR)
+    {
+        if (_IsolateOuterplanarObstruction(theGraph, v, R) != OK)
+            return NOTOK;
+    }
+    else
+        return NOTOK;
+
+    return NONEMBEDDABLE;
+}
+
+/********************************************************************
+ gp_IsPlanar()
+ gp_IsOuterplanar()
+
+ Decide whether theGraph is planar (or outerplanar) by invoking
+ gp_Embed() with the EMBEDFLAGS_TESTONLY modifier.  The same
+ preconditions as for gp_Embed() apply, and afterward theGraph
+ contains neither an embedding nor an obstruction.
+
+ Returns OK if theGraph is planar (outerplanar), NONEMBEDDABLE if
+         it is not, or NOTOK on error
+ ********************************************************************/
+
+int gp_IsPlanar(graphP theGraph)
+{
+    return gp_Embed(theGraph, EMBEDFLAGS_PLANAR | EMBEDFLAGS_TESTONLY);
+}
+
+int gp_IsOuterplanar(graphP theGraph)
+{
+    return gp_Embed(theGraph, EMBEDFLAGS_OUTERPLANAR | EMBEDFLAGS_TESTONLY);
+}
+
+/********************************************************************
+ gp_EmbedMulti()
+
+ Runs gp_Embed() with each of the numAlgorithms embedFlags in
+ embedFlagsArray on theGraph, and stores the result of each in the
+ corresponding element of results.
+
+ The depth-first search, the sorting of the vertices by DFI and the
+ lowpoint computation are performed only once, on theGraph itself,
+ which then serves as a template that is copied for each algorithm.
+ Since the copies arrive at gp_Embed() with this DFS state already
+ present, the incremental path of _EmbeddingInitialize() is taken.
+ Afterward, theGraph is left sorted by DFI (see gp_SortVertices()
+ to restore the original order), but it is not embedded.
+
+ embedGraphs - NULL, or an array of numAlgorithms graphs with the same
+     number of vertices as theGraph, each already extended for the
+     corresponding embedFlags (except that Planarity and Outerplanarity
+     are attached by gp_Embed() as usual). Each is given a copy of the
+     template by gp_CopyGraphInUse(), so the same preconditions apply,
+     and each holds the embedding or obstruction afterward, e.g. for
+     gp_TestEmbedResultIntegrity(). If embedGraphs is NULL, then a
+     graph is allocated and extended for each algorithm and freed
+     after its result is obtained.
+
+ A directed graph is not preprocessed, since the DFS utilities do not
+ support it, so each gp_Embed() then performs its own DFS.
+
+ Returns OK if every result is OK or NONEMBEDDABLE, or NOTOK on error,
+     in which case the remaining results are set to NOTOK
+ ********************************************************************/
+
+int gp_EmbedMulti(graphP theGraph, int numAlgorithms, unsigned const *embedFlagsArray,
+                  graphP *embedGraphs, int *results)
+{
+    graphP theEmbedGraph = NULL;
+    int i, Result = OK;
+
+    if (theGraph == NULL || numAlgorithms <= 0 || embedFlagsArray == NULL ||
+        results == NULL || gp_GetEmbedFlags(theGraph) != 0)
+        return NOTOK;
+
+    for (i = 0; i < numAlgorithms; i++)
+        results[i] = NOTOK;
+
+    // Perform the DFS preprocessing shared by all of the algorithms
+    if (!(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_DIRECTEDEDGEDETECTED) &&
+        !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_LOWPOINTSCOMPUTED))
+    {
+        if (gp_ComputeLowpoints(theGraph) != OK)
+            return NOTOK;
+    }
+
+    for (i = 0; i < numAlgorithms && Result == OK; i++)
+    {
+        if (embedGraphs != NULL)
+            theEmbedGraph = embedGraphs[i];
+        else if ((theEmbedGraph = gp_New()) == NULL ||
+                 gp_EnsureVertexCapacity(theEmbedGraph, gp_GetN(theGraph)) != OK ||
+                 _ExtendForEmbedFlags(theEmbedGraph, embedFlagsArray[i]) != OK)
+            Result = NOTOK;
+
+        if (Result == OK && gp_CopyGraphInUse(theEmbedGraph, theGraph) != OK)
+            Result = NOTOK;
+
+        if (Result == OK)
+        {
+            results[i] = gp_Embed(theEmbedGraph, embedFlagsArray[i]);
+            if (results[i] != OK && results[i] != NONEMBEDDABLE)
+                Result = results[i] = NOTOK;
+        }
+
+        if (embedGraphs == NULL)
+            gp_Free(&theEmbedGraph);
+    }
+
+    return Result;
+}
+
+/********************************************************************
+ _ExtendForEmbedFlags()
+
+ Attaches the extension needed by gp_Embed() for the embedFlags, other
+ than Planarity and Outerplanarity, which gp_Embed() attaches itself.
+
+ Returns OK on success, NOTOK if the extension could not be attached
+     or the embedFlags do not indicate a supported algorithm
+ ********************************************************************/
+
+int _ExtendForEmbedFlags(graphP theGraph, unsigned embedFlags)
+{
+    switch (embedFlags & ~EMBEDFLAGS_TESTONLY)
+    {
+    case EMBEDFLAGS_PLANAR:
+    case EMBEDFLAGS_OUTERPLANAR:
+        return OK;
+    case EMBEDFLAGS_DRAWPLANAR:
+        return gp_ExtendWith_DrawPlanar(theGraph);
+    case EMBEDFLAGS_SEARCHFORK23:
+        return gp_ExtendWith_K23Search(theGraph);
+    case EMBEDFLAGS_SEARCHFORK33:
+        return gp_ExtendWith_K33Search(theGraph);
+    case EMBEDFLAGS_SEARCHFORK4:
+        return gp_ExtendWith_K4Search(theGraph);
+    default:
+        return NOTOK;
+    }
+}
+
+/********************************************************************
+ _DecideByPrefilters()
+
+ In test-only mode, some graphs can be decided without the embedder
+ because every obstruction has at least a certain number of edges
+ and of vertices of degree 3 or more, and because a simple graph
+ with too many edges cannot be embedded:
+
+ 1) A simple planar graph with N >= 3 vertices has at most 3N-6 edges,
+    and a simple outerplanar graph with N >= 2 vertices has at most
+    2N-3 edges.  As theGraph may have loops and parallel edges, which
+    do not affect embeddability, this bound is applied to the number
+    of edges not counting them, which is only computed if M exceeds
+    the bound.
+ 2) A subgraph homeomorphic to K_{3,3} or K_5 has at least 9 edges,
+    and one homeomorphic to K_{2,3} or K_4 has at least 6 edges.
+ 3) A subgraph homeomorphic to K_{3,3} or K_5 has at least 5 vertices
+    of degree 3 or more, and one homeomorphic to K_{2,3} or K_4 has
+    at least 2 such vertices.
+
+ The second test is O(1).  The first is O(1) if M is within the bound,
+ and otherwise O(N + M).  The third is O(N + M) but stops as soon as
+ enough branch vertices are found.  Each decision is
+ counted in the thread's prefilter statistics.
+
+ Returns TRUE and sets *pResult to OK or NONEMBEDDABLE if theGraph
+         was decided by a prefilter, FALSE otherwise
+ ********************************************************************/
+
+int _DecideByPrefilters(graphP theGraph, int *pResult)
+{
+    int N = gp_GetN(theGraph), M = gp_GetM(theGraph);
+    int maxEdges, minObstructionEdges, minBranchVertices;
+
+    if (gp_GetEmbedFlags(theGraph) & EMBEDFLAGS_OUTERPLANAR)
+    {
+        maxEdges = 2 * N - 3;
+        minObstructionEdges = 6;
+        minBranchVertices = 2;
+    }
+    else
+    {
+        maxEdges = 3 * N - 6;
+        minObstructionEdges = 9;
+        minBranchVertices = 5;
+    }
+
+    embedPrefilterStats.numTested++;
+
+    if (M >= minObstructionEdges && M > maxEdges && _HasMoreSimpleEdges(theGraph, maxEdges))
+    {
+        embedPrefilterStats.numEdgeBoundHits++;
+        *pResult = NONEMBEDDABLE;
+        return TRUE;
+    }
+
+    if (M < minObstructionEdges)
+    {
+        embedPrefilterStats.numFewEdgesHits++;
+        *pResult = OK;
+        return TRUE;
+    }
+
+    if (!_HasBranchVertices(theGraph, minBranchVertices))
+    {
+        embedPrefilterStats.numFewBranchHits++;
+        *pResult = OK;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/********************************************************************
+ _HasBranchVertices()
+
+ Returns TRUE if theGraph has at least numBranchVertices vertices of
+ degree 3 or more, FALSE otherwise.
+ ********************************************************************/
+
+int _HasBranchVertices(graphP theGraph, int numBranchVertices)
+{
+    int e, degree;
+
+    for (int v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+    {
+        degree = 0;
+        e = gp_GetFirstEdge(theGraph, v);
+        while (gp_IsEdge(theGraph, e) && degree < 3)
+        {
+            degree++;
+            e = gp_GetNextEdge(theGraph, e);
+        }
+
+        if (degree >= 3 && --numBranchVertices == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/********************************************************************
+ _HasMoreSimpleEdges()
+
+ Returns TRUE if theGraph has more than maxEdges edges when loops are
+ not counted and each set of parallel edges is counted once, FALSE
+ otherwise.  Each edge (v, w) is counted from its endpoint v < w, and
+ the neighbors of each vertex v are marked visited (after clearing the
+ visited flags in constant time) so that parallel edges are counted
+ once.  The visited flags are left cleared.
+ ********************************************************************/
+
+int _HasMoreSimpleEdges(graphP theGraph, int maxEdges)
+{
+    int e, w, numSimpleEdges = 0;
+
+    for (int v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph) && numSimpleEdges <= maxEdges; ++v)
+    {
+        _ClearVertexVisitedFlags(theGraph);
+
+        e = gp_GetFirstEdge(theGraph, v);
+        while (gp_IsEdge(theGraph, e))
+        {
+            w = gp_GetNeighbor(theGraph, e);
+            if (w > v && !gp_GetVisited(theGraph, w))
+            {
+                gp_SetVisited(theGraph, w);
+                numSimpleEdges++;
+            }
+
+            e = gp_GetNextEdge(theGraph, e);
+        }
+    }
+
+    _ClearVertexVisitedFlags(theGraph);
+
+    return numSimpleEdges > maxEdges ? TRUE : FALSE;
+}
+
+/********************************************************************
+ gp_GetEmbedPrefilterStats()
+ gp_ClearEmbedPrefilterStats()
+
+ Get or clear the counts of the graphs decided by the prefilters of
+ test-only gp_Embed() calls on the calling thread.
+ ********************************************************************/
+
+void gp_GetEmbedPrefilterStats(embedPrefilterStatsP pStats)
+{
+    if (pStats != NULL)
+        *pStats = embedPrefilterStats;
+}
+
+void gp_ClearEmbedPrefilterStats(void)
+{
+    embedPrefilterStats.numTested = 0;
+    embedPrefilterStats.numEdgeBoundHits = 0;
+    embedPrefilterStats.numFewEdgesHits = 0;
+    embedPrefilterStats.numFewBranchHits = 0;
 }
 
 /********************************************************************
@@ -352,7 +758,7 @@ int _EmbeddingInitialize_Incremental(graphP theGraph)
         return NOTOK;
 
     sp_ClearStack(theStack);
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
     {
@@ -561,7 +967,7 @@ int _EmbeddingInitialize_Optimized(graphP theGraph)
 
     // We clear the visited flags of vertices because they are used to determine
     // which vertices have already been visited as the DFS traverses theGraph.
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     // This outer loop processes each connected component of a disconnected graph
     // No need to compare v < N since DFI will reach N when inner loop processes the
@@ -1390,7 +1796,9 @@ int _WalkDown(graphP theGraph, int v, int RootVertex)
  by isolating an embedding obstruction (a subgraph homeomorphic to
  K_{3,3} or K_5 for planarity, or a subgraph homeomorphic to K_{2,3}
  or K_4 for outerplanarity). Then NONEMBEDDABLE is returned so that
- the WalkDown can terminate.
+ the WalkDown can terminate. If the isolation is deferred, then
+ only the information needed to perform it later is kept (see
+ gp_IsolateObstruction()).
 
  Extension algorithms are able to clear some of the blockages, in
  which case OK is returned to indicate that the WalkDown can proceed.
@@ -1404,9 +1812,23 @@ int _HandleBlockedBicomp(graphP theGraph, int v, int RootVertex, int R)
 {
     int RetVal = NONEMBEDDABLE;
 
+    // In test-only mode, the blockage suffices to decide the result
+    if (gp_GetEmbedFlags(theGraph) & EMBEDFLAGS_TESTONLY)
+        return RetVal;
+
     if (R != RootVertex)
         sp_Push2(theGraph->theStack, R, 0);
 
+    // If isolation is deferred, then the stack is left as is, and the vertex
+    // and root needed to start the isolation are kept in the isolator context
+    if (gp_GetEmbedFlags(theGraph) & EMBEDFLAGS_DEFERISOLATION)
+    {
+        _InitIsolatorContext(theGraph);
+        theGraphIC(theGraph)->v = v;
+        theGraphIC(theGraph)->r = RootVertex;
+        return RetVal;
+    }
+
     if (gp_GetEmbedFlags(theGraph) == EMBEDFLAGS_PLANAR)
     {
         if (_IsolateKuratowskiSubgraph(theGraph, v, RootVertex) != OK)
@@ -1553,8 +1975,9 @@ int _EmbedPostprocess(graphP theGraph, int v, int edgeEmbeddingResult)
     int RetVal = edgeEmbeddingResult;
 
     // If an embedding was found, then post-process the embedding structure give
-    // a consistent orientation to all vertices then eliminate virtual vertices
-    if (edgeEmbeddingResult == OK)
+    // a consistent orientation to all vertices then eliminate virtual vertices,
+    // unless only the result of the embedder was requested
+    if (edgeEmbeddingResult == OK && !(gp_GetEmbedFlags(theGraph) & EMBEDFLAGS_TESTONLY))
     {
         if (_OrientVerticesInEmbedding(theGraph) != OK ||
             _JoinBicomps(theGraph) != OK)
@@ -24,8 +24,13 @@ extern "C"
 /* Graph Flags: see gp_GetGraphFlags()
         GRAPHFLAGS_EXTENDEDWITH_PLANARITY is set by calling gp_ExtendWith_Planarity()
                 This is automatically by gp_Embed() if not already done.
+        GRAPHFLAGS_EMBEDDED is set by gp_Embed() when it returns OK for EMBEDFLAGS_PLANAR
+                or EMBEDFLAGS_OUTERPLANAR without the EMBEDFLAGS_TESTONLY modifier, i.e.
+                when the graph contains a planar or outerplanar embedding. It is cleared
+                when any edge is added, deleted, hidden or restored.
 */
 #define GRAPHFLAGS_EXTENDEDWITH_PLANARITY 65536
+#define GRAPHFLAGS_EMBEDDED 262144
 
     // Graph embedding and result validation methods
     // The embedResult output by gp_Embed() and input to gp_TestEmbedResultIntegrity()
@@ -34,10 +39,29 @@ extern "C"
     int gp_Embed(graphP theGraph, unsigned embedFlags);
     int gp_TestEmbedResultIntegrity(graphP theGraph, graphP origGraph, int embedResult);
 
+    // Isolates the obstruction whose isolation gp_Embed() deferred due to the
+    // EMBEDFLAGS_DEFERISOLATION modifier (see below)
+    int gp_IsolateObstruction(graphP theGraph);
+
+    // Decision-only convenience methods, equivalent to gp_Embed() with the
+    // EMBEDFLAGS_TESTONLY modifier (see below)
+    int gp_IsPlanar(graphP theGraph);
+    int gp_IsOuterplanar(graphP theGraph);
+
+    // Runs several embedding algorithms on copies of theGraph that share
+    // a single depth-first search (see gp_EmbedMulti() in graphEmbed.c)
+    int gp_EmbedMulti(graphP theGraph, int numAlgorithms, unsigned const *embedFlagsArray,
+                      graphP *embedGraphs, int *results);
+
     // Graph embedding face enumeration and listing methods
     int gp_CountEmbeddingFaces(graphP theGraph);
     int gp_CreateEmbeddingFaceList(graphP theGraph, char **pFaceList);
 
+    // Incremental planarity methods that add edges to a planar embedding,
+    // inserting each edge into a face shared by its endpoints if possible
+    int gp_TryAddEdgeToEmbedding(graphP theGraph, int u, int v);
+    int gp_TryAddEdgesToEmbedding(graphP theGraph, const int *u, const int *v, int count);
+
 // A return result value for gp_Embed() to indicate success prior to embedding completion,
 // due to finding an obstruction to embedding.
 #define NONEMBEDDABLE -1
@@ -62,6 +86,46 @@ extern "C"
 #define EMBEDFLAGS_PROJECTIVEPLANAR 512
 #define EMBEDFLAGS_TOROIDAL 1024
 
+// Modifier that can be combined (bitwise-or) with EMBEDFLAGS_PLANAR or
+// EMBEDFLAGS_OUTERPLANAR to only decide whether the graph is embeddable.
+// gp_Embed() stops as soon as an obstruction is detected, without isolating
+// it, and skips orienting and joining the bicomps of a successful embedding.
+// Hence, afterward theGraph contains neither an embedding nor an obstruction,
+// the obstruction minor type is MINORTYPE_NONE, and theGraph should only be
+// reset, e.g. with gp_ResetGraphStorage().
+#define EMBEDFLAGS_TESTONLY 65536
+
+// Modifier that can be combined (bitwise-or) with EMBEDFLAGS_PLANAR or
+// EMBEDFLAGS_OUTERPLANAR to defer the isolation of an obstruction.
+// If the graph is not embeddable, then gp_Embed() returns NONEMBEDDABLE
+// as soon as an obstruction is detected, leaving theGraph in the state of
+// the failed embedding step, with the vertex and bicomp root at which the
+// embedder was blocked kept in the isolator context. The obstruction is
+// then isolated only if gp_IsolateObstruction() is called, which must be
+// done before theGraph is modified in any other way. While the isolation
+// is pending, this modifier remains in the graph's embedFlags, and the
+// obstruction minor type is MINORTYPE_NONE. Otherwise, the modifier is
+// cleared, e.g. if gp_Embed() returns OK with an embedding.
+#define EMBEDFLAGS_DEFERISOLATION 131072
+
+    // In test-only mode, gp_Embed() first tries to decide the result from the
+    // edge count and the number of vertices of degree 3 or more, and runs the
+    // embedder only if these prefilters are inconclusive.  The graphs decided
+    // by each prefilter are counted per thread, and the counts accumulate
+    // until they are cleared.
+    typedef struct
+    {
+        int numTested;        // Number of test-only gp_Embed() calls
+        int numEdgeBoundHits; // NONEMBEDDABLE because M > 3N-6 (or 2N-3)
+        int numFewEdgesHits;  // OK because M is less than any obstruction's
+        int numFewBranchHits; // OK because too few vertices have degree >= 3
+    } embedPrefilterStatsStruct;
+
+    typedef embedPrefilterStatsStruct *embedPrefilterStatsP;
+
+    void gp_GetEmbedPrefilterStats(embedPrefilterStatsP pStats);
+    void gp_ClearEmbedPrefilterStats(void);
+
     // After gp_Embed(), if the result is NONEMBEDDABLE, then this method
     // returns the obstructing minor type from the list below.
     // It is best to compare using a bitwise-and operation.
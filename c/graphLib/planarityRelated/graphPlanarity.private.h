@@ -60,7 +60,7 @@ extern "C"
 
     struct extFaceLinkRec
     {
-        int vertex[2];
+        GP_INDEX_T vertex[2];
     };
 
     typedef struct extFaceLinkRec extFaceLinkRec;
@@ -108,7 +108,7 @@ extern "C"
 
     struct Planarity_VertexInfo
     {
-        int pertinentEdge,
+        GP_INDEX_T pertinentEdge,
             pertinentRoots,
             futurePertinentChild,
             sortedDFSChildList,
@@ -40,6 +40,9 @@ int gp_ExtendWith_Planarity(graphP theGraph)
 
     // Perform "on success" operations
     theGraph->graphFlags |= GRAPHFLAGS_EXTENDEDWITH_PLANARITY;
+
+    // An embedding no longer exists once any edge of it changes
+    theGraphEdgeDependentGraphFlags(theGraph) |= GRAPHFLAGS_EMBEDDED;
     return OK;
 }
 
@@ -61,6 +64,7 @@ int gp_Detach_Planarity(graphP theGraph)
     // Free any data structures allocated by the ExtendWith function
 
     // Indicate successful detachment of Planarity
-    theGraph->graphFlags &= ~GRAPHFLAGS_EXTENDEDWITH_PLANARITY;
+    theGraph->graphFlags &= ~(GRAPHFLAGS_EXTENDEDWITH_PLANARITY | GRAPHFLAGS_EMBEDDED);
+    theGraphEdgeDependentGraphFlags(theGraph) &= ~GRAPHFLAGS_EMBEDDED;
     return OK;
 }
@@ -10,6 +10,8 @@ See the LICENSE.TXT file for licensing information.
 
 #include <stdlib.h>
 
+extern void _ClearEdgeVisitedFlags(graphP theGraph);
+
 static int _ClearEmbeddingFaceEdgeVisitedFlags(graphP theGraph)
 {
     int e, eTwin;
@@ -187,8 +189,8 @@ int gp_CreateEmbeddingFaceList(graphP theGraph, char **pFaceList)
         componentEdgesCapacity = 1;
 
     faceList = sb_New(0);
-    visitedVertices = (int *)calloc((size_t)gp_UpperBoundVertexStorage(theGraph), sizeof(int));
-    componentEdges = (int *)calloc((size_t)componentEdgesCapacity, sizeof(int));
+    visitedVertices = (int *)gp_MemCalloc((size_t)gp_UpperBoundVertexStorage(theGraph), sizeof(int));
+    componentEdges = (int *)gp_MemCalloc((size_t)componentEdgesCapacity, sizeof(int));
 
     if (faceList == NULL || visitedVertices == NULL || componentEdges == NULL)
     {
@@ -255,13 +257,13 @@ gp_CreateEmbeddingFaceList_Cleanup:
 
     if (componentEdges != NULL)
     {
-        free(componentEdges);
+        gp_MemFree(componentEdges);
         componentEdges = NULL;
     }
 
     if (visitedVertices != NULL)
     {
-        free(visitedVertices);
+        gp_MemFree(visitedVertices);
         visitedVertices = NULL;
     }
 
@@ -271,10 +273,309 @@ gp_CreateEmbeddingFaceList_Cleanup:
     {
         if (*pFaceList != NULL)
         {
-            free(*pFaceList);
+            gp_MemFree(*pFaceList);
             *pFaceList = NULL;
         }
     }
 
     return Result;
 }
+
+/********************************************************************
+ _FindSharedFace()
+
+ Looks for a face of the embedding in theGraph that contains both of
+ the vertices u and v, traversing each face incident to u only once.
+ If one is found, then the edge records with which the traversal of
+ the face leaves u and v are returned in pe_u and pe_v. An edge (u, v)
+ whose edge records are inserted just before these in the adjacency
+ lists of u and v then splits the face in two.
+
+ Returns TRUE if a shared face was found, FALSE otherwise
+ ********************************************************************/
+
+static int _FindSharedFace(graphP theGraph, int u, int v, int *pe_u, int *pe_v)
+{
+    int e, eStart, eNext;
+
+    _ClearEdgeVisitedFlags(theGraph);
+
+    eStart = gp_GetFirstEdge(theGraph, u);
+    while (gp_IsEdge(theGraph, eStart))
+    {
+        if (!gp_GetEdgeVisited(theGraph, eStart))
+        {
+            e = eStart;
+            do
+            {
+                gp_SetEdgeVisited(theGraph, e);
+                eNext = gp_GetNextEdgeCircular(theGraph, gp_GetTwin(theGraph, e));
+
+                if (gp_GetNeighbor(theGraph, e) == v)
+                {
+                    *pe_u = eStart;
+                    *pe_v = eNext;
+                    return TRUE;
+                }
+
+                e = eNext;
+            } while (e != eStart);
+        }
+
+        eStart = gp_GetNextEdge(theGraph, eStart);
+    }
+
+    return FALSE;
+}
+
+/********************************************************************
+ _AddEdgeInSharedFace()
+
+ Adds the edge (u, v) to the embedding in theGraph without changing
+ the rest of the embedding, if this is possible because u and v are on
+ a common face or one of them has no edges. In the latter case, the
+ DFS trees no longer give the connected components of theGraph, so the
+ caller must renumber theGraph (see _RenumberByDFS()).
+
+ Returns OK if the edge was added,
+         NONEMBEDDABLE if u and v have no face in common,
+         NOTOK on error
+ ********************************************************************/
+
+static int _AddEdgeInSharedFace(graphP theGraph, int u, int v)
+{
+    int e_u, e_v, temp;
+
+    if (gp_IsNotEdge(theGraph, gp_GetFirstEdge(theGraph, u)) ||
+        gp_IsNotEdge(theGraph, gp_GetFirstEdge(theGraph, v)))
+        return gp_DynamicAddEdge(theGraph, u, 0, v, 0) == OK ? OK : NOTOK;
+
+    // The faces incident to the endpoint of lesser degree are traversed
+    if (gp_GetVertexDegree(theGraph, v) < gp_GetVertexDegree(theGraph, u))
+    {
+        temp = u;
+        u = v;
+        v = temp;
+    }
+
+    if (!_FindSharedFace(theGraph, u, v, &e_u, &e_v))
+        return NONEMBEDDABLE;
+
+    return gp_DynamicInsertEdge(theGraph, u, e_u, 1, v, e_v, 1) == OK ? OK : NOTOK;
+}
+
+/********************************************************************
+ _ReembedWithEdges()
+
+ Embeds, from scratch, a copy of theGraph to which the count edges
+ (u[i], v[i]) are added. If the copy is planar, then its embedding
+ replaces the one in theGraph, keeping the vertex numbering and index
+ members of theGraph, but not the positions of the edge records.
+ Otherwise, theGraph is not changed.
+
+ This costs a full copy and embedding of the graph, i.e. O(N+M) time,
+ no matter how small the part of the embedding that has to change, so
+ it is only meant for the uncommon case of an edge whose endpoints have
+ no face in common.
+
+ Returns OK if the copy is planar, NONEMBEDDABLE if it is not,
+         or NOTOK on error, including if an edge is already present
+ ********************************************************************/
+
+static int _ReembedWithEdges(graphP theGraph, const int *u, const int *v, int count)
+{
+    graphP workGraph = NULL;
+    int e, i, w, Result = OK;
+
+    if ((workGraph = gp_DupGraph(theGraph)) == NULL)
+        return NOTOK;
+
+    gp_ResetGraphStorage(workGraph);
+
+    for (e = gp_LowerBoundEdges(theGraph); e < gp_UpperBoundEdges(theGraph) && Result == OK; e += 2)
+    {
+        if (gp_EdgeInUse(theGraph, e) &&
+            gp_DynamicAddEdge(workGraph, gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e)), 0,
+                              gp_GetNeighbor(theGraph, e), 0) != OK)
+            Result = NOTOK;
+    }
+
+    for (i = 0; i < count && Result == OK; i++)
+    {
+        if (gp_IsNeighbor(workGraph, u[i], v[i]) ||
+            gp_DynamicAddEdge(workGraph, u[i], 0, v[i], 0) != OK)
+            Result = NOTOK;
+    }
+
+    if (Result == OK)
+        Result = gp_Embed(workGraph, EMBEDFLAGS_PLANAR);
+
+    // Put the vertices of the new embedding into the numbering of theGraph,
+    // then give them the index members and sort order of theGraph
+    if (Result == OK)
+    {
+        if (gp_SortVertices(workGraph) != OK)
+            Result = NOTOK;
+
+        for (w = gp_LowerBoundVertices(theGraph); w < gp_UpperBoundVertices(theGraph); ++w)
+            gp_SetIndex(workGraph, w, gp_GetIndex(theGraph, w));
+
+        workGraph->graphFlags &= ~GRAPHFLAGS_SORTEDBYDFI;
+        workGraph->graphFlags |= gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI;
+
+        if (Result == OK && gp_CopyGraphInUse(theGraph, workGraph) != OK)
+            Result = NOTOK;
+    }
+
+    gp_Free(&workGraph);
+
+    return Result;
+}
+
+/********************************************************************
+ _RenumberByDFS()
+
+ Performs a new depth first search of theGraph, after edges added to
+ its embedding have joined DFS trees or changed the DFS parents, so
+ that the DFS trees and depth first indices again agree. If theGraph
+ is sorted by DFI, then it is put in the original vertex order for the
+ search and afterward sorted by the new DFIs, so the numbering given
+ by the new DFS replaces the current numbering of theGraph, and the
+ original numbering is kept. Otherwise, only the DFIs in the index
+ members change.
+
+ Returns OK on success, NOTOK on error
+ ********************************************************************/
+
+static int _RenumberByDFS(graphP theGraph)
+{
+    int sortedByDFI = gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI;
+
+    if (sortedByDFI && gp_SortVertices(theGraph) != OK)
+        return NOTOK;
+
+    theGraph->graphFlags &= ~(GRAPHFLAGS_DFSNUMBERED | GRAPHFLAGS_LOWPOINTSCOMPUTED);
+
+    if (gp_DepthFirstSearch(theGraph) != OK)
+        return NOTOK;
+
+    if (sortedByDFI && gp_SortVertices(theGraph) != OK)
+        return NOTOK;
+
+    return OK;
+}
+
+/********************************************************************
+ gp_TryAddEdgeToEmbedding()
+ gp_TryAddEdgesToEmbedding()
+
+ Given a graph containing a planar embedding, i.e. for which gp_Embed()
+ with EMBEDFLAGS_PLANAR returned OK, these methods add the edge (u, v),
+ or each of the count edges (u[i], v[i]), to the embedding if the graph
+ remains planar. The vertices are given in the current numbering of
+ theGraph, so gp_SortVertices() may be called before or after these
+ methods.
+
+ If an edge joins a vertex that has no edges, or if the graph is
+ embedded again (see below), then the DFS trees change, so a new DFS
+ gives the vertices new DFIs. In the original vertex order, this only
+ changes the index members. If theGraph is sorted by DFI, then the
+ vertices are sorted by the new DFIs, so the current numbering changes,
+ while the original numbering is kept; gp_GetDFIOfOriginal() gives the
+ new numbering.
+
+ Each edge is first inserted by gp_DynamicInsertEdge() into a face of
+ the embedding that contains both of its endpoints, if there is one.
+ This only takes time proportional to the sizes of the faces around
+ one endpoint, and the positions of the other edge records are kept.
+
+ Otherwise, a copy of theGraph with the edge, and with all of the
+ remaining edges of a batch, is embedded once by gp_Embed(), and its
+ embedding replaces the one in theGraph. This is needed whenever no
+ face is shared, since a different embedding may still admit the edge.
+ This also changes the positions of the edge records, and it costs as
+ much as embedding the whole graph again, i.e. O(N+M) time, so these
+ methods are only fast when most edges fall in an existing face.
+
+ A batch is added entirely or not at all. If the edges would make the
+ graph nonplanar, then those already inserted into faces are deleted
+ again, so the embedding is the same as before, though the positions
+ of the edge records for later additions may differ.
+
+ Returns OK if the edges were added to the embedding,
+         NONEMBEDDABLE if the graph with the edges is not planar,
+             in which case theGraph is not changed,
+         NOTOK on error, including if an edge is a loop or is already
+             in the graph, in which case theGraph is not changed
+ ********************************************************************/
+
+int gp_TryAddEdgeToEmbedding(graphP theGraph, int u, int v)
+{
+    return gp_TryAddEdgesToEmbedding(theGraph, &u, &v, 1);
+}
+
+int gp_TryAddEdgesToEmbedding(graphP theGraph, const int *u, const int *v, int count)
+{
+    int i, j, renumber = FALSE, Result = OK;
+
+    if (theGraph == NULL || u == NULL || v == NULL || count < 0 ||
+        gp_GetEmbedFlags(theGraph) != EMBEDFLAGS_PLANAR ||
+        !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_EMBEDDED) ||
+        !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_DFSNUMBERED) ||
+        (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_DIRECTEDEDGEDETECTED))
+        return NOTOK;
+
+    for (i = 0; i < count; i++)
+    {
+        if (u[i] < gp_LowerBoundVertices(theGraph) || u[i] >= gp_UpperBoundVertices(theGraph) ||
+            v[i] < gp_LowerBoundVertices(theGraph) || v[i] >= gp_UpperBoundVertices(theGraph) ||
+            u[i] == v[i])
+            return NOTOK;
+    }
+
+    // Add the edges to shared faces until one cannot be, then add it and
+    // the rest of the edges by embedding the graph once more
+    for (i = 0; i < count; i++)
+    {
+        if (gp_IsNeighbor(theGraph, u[i], v[i]))
+            Result = NOTOK;
+        else
+        {
+            // An edge to a vertex with no edges joins two DFS trees
+            if (gp_IsNotEdge(theGraph, gp_GetFirstEdge(theGraph, u[i])) ||
+                gp_IsNotEdge(theGraph, gp_GetFirstEdge(theGraph, v[i])))
+                renumber = TRUE;
+
+            Result = _AddEdgeInSharedFace(theGraph, u[i], v[i]);
+        }
+
+        if (Result != OK)
+            break;
+    }
+
+    // The new embedding comes with the DFS parents of its own DFS
+    if (Result == NONEMBEDDABLE)
+    {
+        Result = _ReembedWithEdges(theGraph, u + i, v + i, count - i);
+        renumber = TRUE;
+    }
+
+    // If the batch is not added, then delete the edges already inserted,
+    // which leaves the DFS trees as they were
+    if (Result != OK)
+    {
+        for (j = i - 1; j >= 0; j--)
+        {
+            if (gp_DeleteEdge(theGraph, gp_FindEdge(theGraph, u[j], v[j])) != OK)
+                return NOTOK;
+        }
+    }
+    else if (renumber && _RenumberByDFS(theGraph) != OK)
+        return NOTOK;
+
+    // Changing the edges cleared GRAPHFLAGS_EMBEDDED, but theGraph again
+    // contains an embedding, with or without the new edges
+    theGraph->graphFlags |= GRAPHFLAGS_EMBEDDED;
+
+    return Result;
+}
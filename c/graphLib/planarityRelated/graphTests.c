@@ -13,7 +13,7 @@ See the LICENSE.TXT file for licensing information.
 #include "graphPlanarity.h"
 #include "graphPlanarity.private.h"
 
-extern void _ClearVertexVisitedFlags(graphP theGraph, int);
+extern void _ClearVertexVisitedFlags(graphP theGraph);
 
 /* Private function declarations (some exported to system) */
 
@@ -55,15 +55,13 @@ void _MarkExternalFaceVertices(graphP theGraph, int startVertex);
   also provide overriding integrity test routines appropriate to the
   extension algorithm.
 
-  The main method first calls gp_SortVertices on theGraph, if the
-  origGraph is not in DFI order (the common case).  Therefore,
-  extension integrity tests can count on a consistent numbering
-  between theGraph and the origGraph, either DFI order or pre-DFS
-  order if that is the state of the origGraph.
-
-  After all tests, the main method ensures theGraph is restored to
-  DFI order by invoking gp_SortVertices if needed, thus ensuring
-  that theGraph has the documented post-condition of gp_Embed().
+  theGraph is left in DFI order, the documented post-condition of
+  gp_Embed(), even if the origGraph is not in DFI order (the common
+  case).  The subgraph tests compare the two graphs by mapping the
+  vertices of the graph in DFI order to their original positions
+  (see gp_GetOriginalVertexIndex()), so extension integrity tests
+  that compare vertex numbers between theGraph and the origGraph must
+  do the same.
 
   For an embedResult of OK, fpCheckEmbeddingIntegrity is invoked.
   The core planarity implementation does a face walk of all faces
@@ -78,6 +76,12 @@ void _MarkExternalFaceVertices(graphP theGraph, int startVertex);
   subgraph of the input graph.  Other algorithms use overloads to
   make appropriate checks.
 
+  If gp_Embed() was invoked with the EMBEDFLAGS_TESTONLY modifier,
+  then there is neither an embedding nor an obstruction to check,
+  so the embedResult is returned. The same holds if the isolation
+  of an obstruction was deferred and gp_IsolateObstruction() has not
+  yet been called.
+
   Returns NOTOK on integrity check failure or embedResult of NOTOK
           OK for successful integrity check of OK embedResult
           NONEMBEDDABLE for successful integrity check of an
@@ -91,6 +95,9 @@ int gp_TestEmbedResultIntegrity(graphP theGraph, graphP origGraph, int embedResu
     if (theGraph == NULL || origGraph == NULL)
         return NOTOK;
 
+    if (gp_GetEmbedFlags(theGraph) & (EMBEDFLAGS_TESTONLY | EMBEDFLAGS_DEFERISOLATION))
+        return embedResult;
+
     if (embedResult == OK)
     {
         RetVal = theGraph->functions->fpCheckEmbeddingIntegrity(theGraph, origGraph);
@@ -191,7 +198,7 @@ int _CheckAllVerticesOnExternalFace(graphP theGraph)
     int v;
 
     // Mark all vertices unvisited
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     // For each connected component, walk its external face and
     // mark the vertices as visited
@@ -404,7 +411,7 @@ int _TestForCompleteGraphObstruction(graphP theGraph, int numVerts,
         return FALSE;
 
     // We clear all the vertex visited flags
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     // For each pair of image vertices, we test that there is a path
     // between the two vertices.  If so, the visited flags of the
@@ -485,7 +492,7 @@ int _TestForK33GraphObstruction(graphP theGraph, int *degrees, int *imageVerts)
     /* Now test the paths between each of the first three vertices and
            each of the last three vertices */
 
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     for (imageVertPos = 0; imageVertPos < 3; imageVertPos++)
         for (K = 3; K < 6; K++)
@@ -611,7 +618,7 @@ int _TestForK23GraphObstruction(graphP theGraph, int *degrees, int *imageVerts)
          Now test the paths between each of the degree 2 image
          vertices and imageVerts[1]. */
 
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     for (imageVertPos = 2; imageVertPos < 5; imageVertPos++)
     {
@@ -786,55 +793,51 @@ void _MarkPath(graphP theGraph, int e)
  neighbor w was unmarked.  If there exists a marked neighbor, then
  H(v) contains an incident edge that is not incident to G(v).
 
+ If one of the graphs is sorted by DFI and the other is not, then the
+ index of each vertex of the sorted graph is its original position,
+ so its vertices and neighbors are mapped to their original positions
+ rather than sorting the graph out of DFI order and back again.
+ The marks are then made by original position in the visited flags
+ of theGraph, which have an entry for every vertex position.
+
  Returns TRUE if theSubgraph contains only edges from theGraph,
          FALSE otherwise
  ********************************************************************/
 
 int _TestSubgraph(graphP theSubgraph, graphP theGraph)
 {
-    int v, e, degreeCount;
+    int p, vSubgraph, vGraph, w, e, degreeCount;
     int Result = TRUE;
-    int invokeSortOnGraph = FALSE;
-    int invokeSortOnSubgraph = FALSE;
-
-    // If the graph is not sorted by DFI, but the alleged subgraph is,
-    // then "unsort" the alleged subgraph so both have the same vertex order
-    if (!(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI) &&
-        (gp_GetGraphFlags(theSubgraph) & GRAPHFLAGS_SORTEDBYDFI))
-    {
-        invokeSortOnSubgraph = TRUE;
-        gp_SortVertices(theSubgraph);
-    }
-
-    // If the graph is not sorted by DFI, but the alleged subgraph is,
-    // then "unsort" the alleged subgraph so both have the same vertex order
-    if (!(gp_GetGraphFlags(theSubgraph) & GRAPHFLAGS_SORTEDBYDFI) &&
-        (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI))
-    {
-        invokeSortOnGraph = TRUE;
-        gp_SortVertices(theGraph);
-    }
+    int mapSubgraph = (gp_GetGraphFlags(theSubgraph) & GRAPHFLAGS_SORTEDBYDFI) &&
+                      !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI);
+    int mapGraph = (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI) &&
+                   !(gp_GetGraphFlags(theSubgraph) & GRAPHFLAGS_SORTEDBYDFI);
 
     /* We clear all visitation flags */
 
-    _ClearVertexVisitedFlags(theGraph, FALSE);
+    _ClearVertexVisitedFlags(theGraph);
 
     /* For each vertex... */
-    for (v = gp_LowerBoundVertices(theSubgraph), degreeCount = 0; v < gp_UpperBoundVertices(theSubgraph); ++v)
+    for (p = gp_LowerBoundVertices(theSubgraph), degreeCount = 0; p < gp_UpperBoundVertices(theSubgraph); ++p)
     {
+        // Get the same vertex in both graphs
+        vSubgraph = mapGraph ? gp_GetIndex(theGraph, p) : p;
+        vGraph = mapSubgraph ? gp_GetIndex(theSubgraph, p) : p;
+
         /* For each neighbor w in the adjacency list of vertex v in the
               subgraph, set the visited flag in w in the graph */
 
-        e = gp_GetFirstEdge(theSubgraph, v);
+        e = gp_GetFirstEdge(theSubgraph, vSubgraph);
         while (gp_IsEdge(theGraph, e))
         {
-            if (gp_IsNotVertex(theSubgraph, gp_GetNeighbor(theSubgraph, e)))
+            w = gp_GetNeighbor(theSubgraph, e);
+            if (gp_IsNotVertex(theSubgraph, w) || gp_IsVirtualVertex(theSubgraph, w))
             {
                 Result = FALSE;
                 break;
             }
             degreeCount++;
-            gp_SetVisited(theGraph, gp_GetNeighbor(theSubgraph, e));
+            gp_SetVisited(theGraph, mapSubgraph ? gp_GetIndex(theSubgraph, w) : w);
             e = gp_GetNextEdge(theSubgraph, e);
         }
 
@@ -844,15 +847,16 @@ int _TestSubgraph(graphP theSubgraph, graphP theGraph)
         /* For each neighbor w in the adjacency list of vertex v in the graph,
               clear the visited flag in w in the graph */
 
-        e = gp_GetFirstEdge(theGraph, v);
+        e = gp_GetFirstEdge(theGraph, vGraph);
         while (gp_IsEdge(theGraph, e))
         {
-            if (gp_IsNotVertex(theGraph, gp_GetNeighbor(theGraph, e)))
+            w = gp_GetNeighbor(theGraph, e);
+            if (gp_IsNotVertex(theGraph, w) || gp_IsVirtualVertex(theGraph, w))
             {
                 Result = FALSE;
                 break;
             }
-            gp_ClearVisited(theGraph, gp_GetNeighbor(theGraph, e));
+            gp_ClearVisited(theGraph, mapGraph ? gp_GetIndex(theGraph, w) : w);
             e = gp_GetNextEdge(theGraph, e);
         }
 
@@ -863,10 +867,11 @@ int _TestSubgraph(graphP theSubgraph, graphP theGraph)
            ensure that the visited flag in w was cleared (otherwise, the "subgraph"
            would incorrectly contain an adjacency not contained in the ("super") graph) */
 
-        e = gp_GetFirstEdge(theSubgraph, v);
+        e = gp_GetFirstEdge(theSubgraph, vSubgraph);
         while (gp_IsEdge(theGraph, e))
         {
-            if (gp_GetVisited(theGraph, gp_GetNeighbor(theSubgraph, e)))
+            w = gp_GetNeighbor(theSubgraph, e);
+            if (gp_GetVisited(theGraph, mapSubgraph ? gp_GetIndex(theSubgraph, w) : w))
             {
                 Result = FALSE;
                 break;
@@ -878,12 +883,6 @@ int _TestSubgraph(graphP theSubgraph, graphP theGraph)
             break;
     }
 
-    // Restore the DFI sort order of either graph if it had to be reordered at the start
-    if (invokeSortOnSubgraph)
-        gp_SortVertices(theSubgraph);
-    if (invokeSortOnGraph)
-        gp_SortVertices(theGraph);
-
     // Assuming theSubgraph is a subgraph, we also do an extra integrity check to ensure
     // proper edge array utilization
     if (Result == TRUE)
@@ -15,6 +15,7 @@ extern "C"
 #include "../graphLib/graphLib.h"
 
 #include "platformTime.h"
+#include "platformThread.h"
 
 #define FILENAMEMAXLENGTH 128
 #define ALGORITHMNAMEMAXLENGTH 32
@@ -41,22 +42,26 @@ extern "C"
         char const *const commandString,
         char const *infileName, char *outfileName, char *outfile2Name,
         char *inputStr, char **pOutputStr, char **pOutput2Str);
-    int RandomGraph(char const *const commandString, int extraEdges, int numVertices, char *outfileName, char *outfile2Name);
-    int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraphs, char *outfileName, int forceQuiet, int useExGenerator);
+    int RandomGraph(char const *const commandString, int extraEdges, int numVertices, unsigned long long const *pSeed, char *outfileName, char *outfile2Name);
+    int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraphs, unsigned long long const *pSeed, int numThreads, char *outfileName, int forceQuiet, int useExGenerator);
     int TransformGraph(char const *const commandString, char const *const infileName, char *inputStr, int *outputBase, char const *outfileName, char **pOutputStr);
-    int TestAllGraphs(char const *const commandString, char const *const infileName, char *outfileName, char **pOutputStr);
+    int TestAllGraphs(char const *const commandString, char const *const infileName, int numThreads, int firstGraph, int numGraphs, char *outfileName, char **pOutputStr);
 
     /* Command line, Menu, and Configuration */
     int menu(void);
     int commandLine(int argc, char *argv[]);
     int legacyCommandLine(int argc, char *argv[]);
 
+    /* Tests of the Graph Library API, run by the quick regression tests */
+    int runLibraryTests(void);
+
     extern char Mode,
         OrigOut,
         OrigOutFormat,
         EmbeddableOut,
         ObstructedOut,
-        AdjListsForEmbeddingsOut;
+        AdjListsForEmbeddingsOut,
+        G6IndexFileOut;
 
     int Reconfigure(void);
 
@@ -87,6 +92,8 @@ extern "C"
 
     int ConstructTransformationExpectedResultFileName(char const *infileName, char **outfileName, char command, int actualOrExpectedFlag);
     void WriteAlgorithmResults(graphP theGraph, int Result, char command, platform_time start, platform_time end, char const *infileName);
+    void AddEmbedPrefilterStats(embedPrefilterStatsP theSum, embedPrefilterStatsP theStats);
+    void WriteEmbedPrefilterStats(embedPrefilterStatsP theStats);
 
     int GetNumCharsToReprInt(int theNum, int *numCharsRequired);
 
@@ -4,6 +4,8 @@ All rights reserved.
 See the LICENSE.TXT file for licensing information.
 */
 
+#include <limits.h>
+
 #include "planarity.h"
 
 #if defined(_MSC_VER) && !defined(__llvm__) && !defined(__INTEL_COMPILER)
@@ -21,10 +23,15 @@ int callSpecificGraph(int argc, char *argv[]);
 int callRandomMaxPlanarGraph(int argc, char *argv[]);
 int callRandomNonplanarGraph(int argc, char *argv[]);
 int callTestAllGraphs(int argc, char *argv[]);
+int parseOptionalNumThreads(int argc, char *argv[], int *pOffset, int *pNumThreads);
+int parseOptionalSeed(int argc, char *argv[], int *pOffset, unsigned long long *pSeed, int *pSeedGiven);
+int parseOptionalRange(int argc, char *argv[], int *pOffset, int *pFirstGraph, int *pNumGraphs);
+int parseOptionalIndexFile(int argc, char *argv[], int *pOffset, char *pIndexFileOut);
 int callTransformGraph(int argc, char *argv[]);
 
 int runSpecificGraphTests(void);
 int runRandomGraphsTests(void);
+int runRandomGeneratorTest(void);
 int runGraphTransformationTests(void);
 int runTestAllGraphsTests(void);
 int runFaceListTest(void);
@@ -32,7 +39,10 @@ int runHideRestoreTests(void);
 int runIdentifyContractTests(void);
 int runSpecificGraphTest(char const *command, char const *infileName, int inputInMemFlag);
 int runGraphTransformationTest(char const *command, char const *infileName, int inputInMemFlag);
-int runTestAllGraphsTest(char const *commandString, char const *infileName);
+int runTestAllGraphsTest(char const *commandString, char const *infileName, int numThreads);
+int runTestAllGraphsRangeTest(char const *commandString, char const *infileName, int numThreads);
+int writeMixedLineEndingG6File(char const *infileName, char const *outfileName, int numGraphs);
+int runTestAllGraphsMultiTest(char const *commandString, char const *infileName);
 int runHideRestoreTest(graphP theGraph);
 int runIdentifyContractTest(graphP theGraph);
 int runDigraphTests(void);
@@ -248,6 +258,8 @@ int runQuickRegressionTests(int argc, char *argv[])
         retVal = NOTOK;
     else if (runGraphMLTests() != OK)
         retVal = NOTOK;
+    else if (runLibraryTests() != OK)
+        retVal = NOTOK;
 
     // All done.
     if (retVal == OK)
@@ -264,27 +276,113 @@ int runQuickRegressionTests(int argc, char *argv[])
 int runRandomGraphsTests(void)
 {
     int retVal = OK;
+    unsigned long long seed = 12345;
 
     gp_Message("Starting Random Graph Tests");
 
-    if (RandomGraphs("-p", 1000, 20, NULL, TRUE, FALSE) != OK)
+    if (RandomGraphs("-p", 1000, 20, NULL, 1, NULL, TRUE, FALSE) != OK)
     {
         gp_ErrorMessage("gp_CreateRandomGraph() test failed.");
         retVal = NOTOK;
     }
 
-    if (RandomGraphs("-p", 1000, 20, NULL, TRUE, TRUE) != OK)
+    if (RandomGraphs("-p", 1000, 20, NULL, 1, NULL, TRUE, TRUE) != OK)
     {
         gp_ErrorMessage("gp_CreateRandomGraphEx() test failed.");
         retVal = NOTOK;
     }
 
+    if (RandomGraphs("-p", 1000, 20, &seed, 4, NULL, TRUE, TRUE) != OK)
+    {
+        gp_ErrorMessage("gp_CreateRandomGraphEx() test with 4 threads failed.");
+        retVal = NOTOK;
+    }
+
+    if (runRandomGeneratorTest() != OK)
+    {
+        gp_ErrorMessage("Seeded random graph reproducibility test failed.");
+        retVal = NOTOK;
+    }
+
     if (retVal == OK)
         gp_Message("Finished Random Graph Tests.\n");
 
     return retVal;
 }
 
+/****************************************************************************
+ runRandomGeneratorTest()
+ Tests that the random number generator only produces numbers in the
+ requested range, and that a graph generated with a seeded generator can
+ be regenerated exactly by reseeding the generator with the same seed.
+ ****************************************************************************/
+
+int runRandomGeneratorTest(void)
+{
+    int Result = OK;
+    int i, r, counts[10];
+    randomGeneratorStruct theGenerator;
+    graphP theGraph = NULL, theRegeneratedGraph = NULL;
+    char *graphStr = NULL, *regeneratedGraphStr = NULL;
+
+    memset(counts, 0, 10 * sizeof(int));
+
+    gp_SeedRandomGenerator(&theGenerator, 12345);
+    for (i = 0; i < 100000; i++)
+    {
+        if ((r = gp_GetRandomNumberFromGenerator(&theGenerator, 10, 19)) < 10 || r > 19)
+            return NOTOK;
+
+        counts[r - 10]++;
+    }
+
+    // Each count is expected to be 10000, with a standard deviation under 100
+    for (i = 0; i < 10; i++)
+        if (counts[i] < 9500 || counts[i] > 10500)
+            return NOTOK;
+
+    if (gp_GetRandomNumberFromGenerator(&theGenerator, 5, 5) != 5 ||
+        gp_GetRandomNumberFromGenerator(&theGenerator, 5, 4) != 5)
+        return NOTOK;
+
+    theGraph = gp_New();
+    theRegeneratedGraph = gp_New();
+    if (theGraph == NULL || theRegeneratedGraph == NULL ||
+        gp_EnsureVertexCapacity(theGraph, 50) != OK ||
+        gp_EnsureVertexCapacity(theRegeneratedGraph, 50) != OK)
+        Result = NOTOK;
+
+    if (Result == OK)
+    {
+        gp_SeedRandomGenerator(&theGenerator, 12345);
+        gp_SetRandomGenerator(theGraph, &theGenerator);
+        Result = gp_CreateRandomGraphEx(theGraph, 3 * 50 - 6 + 10);
+    }
+
+    if (Result == OK)
+    {
+        gp_SeedRandomGenerator(&theGenerator, 12345);
+        gp_SetRandomGenerator(theRegeneratedGraph, &theGenerator);
+        Result = gp_CreateRandomGraphEx(theRegeneratedGraph, 3 * 50 - 6 + 10);
+    }
+
+    if (Result == OK &&
+        (gp_WriteToString(theGraph, &graphStr, WRITE_ADJLIST) != OK ||
+         gp_WriteToString(theRegeneratedGraph, &regeneratedGraphStr, WRITE_ADJLIST) != OK ||
+         strcmp(graphStr, regeneratedGraphStr) != 0))
+        Result = NOTOK;
+
+    if (graphStr != NULL)
+        free(graphStr);
+    if (regeneratedGraphStr != NULL)
+        free(regeneratedGraphStr);
+
+    gp_Free(&theGraph);
+    gp_Free(&theRegeneratedGraph);
+
+    return Result;
+}
+
 int runSpecificGraphTests(void)
 {
     int retVal = OK;
@@ -591,36 +689,93 @@ int runTestAllGraphsTests(void)
     int retVal = OK;
 
     // Run TestAllGraphs Tests
-    if (runTestAllGraphsTest("-p", "n8.mALL.g6") != OK)
+    if (runTestAllGraphsTest("-p", "n8.mALL.g6", 1) != OK)
     {
         gp_ErrorMessage("Planarity test on all graphs failed.");
         retVal = NOTOK;
     }
-    if (runTestAllGraphsTest("-d", "n8.mALL.g6") != OK)
+    if (runTestAllGraphsTest("-d", "n8.mALL.g6", 1) != OK)
     {
         gp_ErrorMessage("Planar graph drawing test on all graphs failed.");
         retVal = NOTOK;
     }
-    if (runTestAllGraphsTest("-o", "n8.mALL.g6") != OK)
+    if (runTestAllGraphsTest("-o", "n8.mALL.g6", 1) != OK)
     {
         gp_ErrorMessage("Outerplanarity test on all graphs failed.");
         retVal = NOTOK;
     }
-    if (runTestAllGraphsTest("-2", "n8.mALL.g6") != OK)
+    if (runTestAllGraphsTest("-2", "n8.mALL.g6", 1) != OK)
     {
         gp_ErrorMessage("K2,3 homeomorph search test on all graphs failed.");
         retVal = NOTOK;
     }
-    if (runTestAllGraphsTest("-3", "n8.mALL.g6") != OK)
+    if (runTestAllGraphsTest("-3", "n8.mALL.g6", 1) != OK)
     {
         gp_ErrorMessage("K3,3 homeomorph search test on all graphs failed.");
         retVal = NOTOK;
     }
-    if (runTestAllGraphsTest("-4", "n8.mALL.g6") != OK)
+    if (runTestAllGraphsTest("-4", "n8.mALL.g6", 1) != OK)
     {
         gp_ErrorMessage("K4 homeomorph search test on all graphs failed.");
         retVal = NOTOK;
     }
+    if (runTestAllGraphsTest("-pt", "n8.mALL.g6", 1) != OK)
+    {
+        gp_ErrorMessage("Planarity test-only on all graphs failed.");
+        retVal = NOTOK;
+    }
+    if (runTestAllGraphsTest("-ot", "n8.mALL.g6", 1) != OK)
+    {
+        gp_ErrorMessage("Outerplanarity test-only on all graphs failed.");
+        retVal = NOTOK;
+    }
+
+    // Run TestAllGraphs Tests with the input divided among worker threads
+    if (runTestAllGraphsTest("-p", "n8.mALL.g6", 4) != OK)
+    {
+        gp_ErrorMessage("Multithreaded planarity test on all graphs failed.");
+        retVal = NOTOK;
+    }
+    if (runTestAllGraphsTest("-3", "n8.mALL.g6", 4) != OK)
+    {
+        gp_ErrorMessage("Multithreaded K3,3 homeomorph search test on all graphs failed.");
+        retVal = NOTOK;
+    }
+
+    // Run TestAllGraphs Tests on ranges of the input that together cover it
+    if (runTestAllGraphsRangeTest("-p", "n8.mALL.g6", 1) != OK)
+    {
+        gp_ErrorMessage("Planarity test on ranges of all graphs failed.");
+        retVal = NOTOK;
+    }
+    if (runTestAllGraphsRangeTest("-o", "n8.mALL.g6", 4) != OK)
+    {
+        gp_ErrorMessage("Multithreaded outerplanarity test on ranges of all graphs failed.");
+        retVal = NOTOK;
+    }
+    if (runTestAllGraphsRangeTest("-p", "K10.g6", 1) != OK)
+    {
+        gp_ErrorMessage("Planarity test on ranges of a file with one graph failed.");
+        retVal = NOTOK;
+    }
+
+    // One more graph than the index stride makes the end of the file the
+    // start of the next stride, for which the index of the lines has no entry
+    if (writeMixedLineEndingG6File("n8.mALL.g6", "n8.mixedEOL.g6", 4097) != OK ||
+        runTestAllGraphsRangeTest("-p", "n8.mixedEOL.g6", 1) != OK ||
+        runTestAllGraphsRangeTest("-p", "n8.mixedEOL.g6", 4) != OK)
+    {
+        gp_ErrorMessage("Planarity test on ranges of a file with lines not of fixed width failed.");
+        retVal = NOTOK;
+    }
+    remove("n8.mixedEOL.g6");
+
+    // Run all of the algorithms in one pass over the input
+    if (runTestAllGraphsMultiTest("-pdo234", "n8.mALL.g6") != OK)
+    {
+        gp_ErrorMessage("Test of all algorithms on all graphs in one pass failed.");
+        retVal = NOTOK;
+    }
 
     return retVal;
 }
@@ -984,7 +1139,7 @@ int runIdentifyContractTest(graphP theGraph)
     return Result;
 }
 
-int runTestAllGraphsTest(char const *commandString, char const *infileName)
+int runTestAllGraphsTest(char const *commandString, char const *infileName, int numThreads)
 {
     char *outputStr = NULL;
     int Result = OK;
@@ -997,7 +1152,7 @@ int runTestAllGraphsTest(char const *commandString, char const *infileName)
         return NOTOK;
     }
 
-    Result = TestAllGraphs(commandString, infileName, NULL, &outputStr);
+    Result = TestAllGraphs(commandString, infileName, numThreads, 0, 0, NULL, &outputStr);
 
     if (Result == OK)
     {
@@ -1008,6 +1163,7 @@ int runTestAllGraphsTest(char const *commandString, char const *infileName)
         const char *K33SearchValidationStr = "-3 12346 7200 5146 SUCCESS";
         const char *K4SearchValidationStr = "-4 12346 1715 10631 SUCCESS";
         const char *theValidationStr = NULL;
+        char modifiedValidationStr[MAXLINE + 1];
 
         switch (command)
         {
@@ -1034,6 +1190,14 @@ int runTestAllGraphsTest(char const *commandString, char const *infileName)
             break;
         }
 
+        // A modifier (e.g. test-only) must produce the same counts as the
+        // command without it, and the output reports it after the command
+        if (theValidationStr != NULL && modifier != '\0')
+        {
+            sprintf(modifiedValidationStr, "-%c%c%s", command, modifier, theValidationStr + 2);
+            theValidationStr = modifiedValidationStr;
+        }
+
         if (theValidationStr != NULL)
             Result = strstr(outputStr, theValidationStr) ? OK : NOTOK;
     }
@@ -1049,6 +1213,185 @@ int runTestAllGraphsTest(char const *commandString, char const *infileName)
     return Result == OK ? OK : NOTOK;
 }
 
+/****************************************************************************
+ runTestAllGraphsMultiTest()
+ Runs the algorithm commands in the commandString in one pass over the input
+ file and checks that the counts for each command match those obtained when
+ the command is run by itself, and that asking for more than one thread for
+ the commands is rejected.
+ ****************************************************************************/
+
+int runTestAllGraphsMultiTest(char const *commandString, char const *infileName)
+{
+    char *outputStr = NULL;
+    int Result = OK, quietModeCache;
+    const char *validationStrs[] = {"-p 12346 6966 5380 SUCCESS",
+                                    "-d 12346 6966 5380 SUCCESS",
+                                    "-o 12346 1150 11196 SUCCESS",
+                                    "-2 12346 1251 11095 SUCCESS",
+                                    "-3 12346 7200 5146 SUCCESS",
+                                    "-4 12346 1715 10631 SUCCESS"};
+
+    Result = TestAllGraphs(commandString, infileName, 1, 0, 0, NULL, &outputStr);
+
+    for (int i = 0; Result == OK && i < 6; i++)
+    {
+        if (strchr(commandString + 1, validationStrs[i][1]) != NULL &&
+            strstr(outputStr, validationStrs[i]) == NULL)
+            Result = NOTOK;
+    }
+
+    if (outputStr != NULL)
+    {
+        free(outputStr);
+        outputStr = NULL;
+    }
+
+    // Run the early-out quietly
+    if (Result == OK)
+    {
+        quietModeCache = gp_GetQuietMode();
+        gp_SetQuietMode(QUIETMODE_ALL);
+
+        if (TestAllGraphs(commandString, infileName, 2, 0, 0, NULL, &outputStr) == OK)
+            Result = NOTOK;
+
+        gp_SetQuietMode(quietModeCache);
+    }
+
+    gp_Message(" ");
+
+    if (outputStr != NULL)
+    {
+        free(outputStr);
+        outputStr = NULL;
+    }
+
+    return Result == OK ? OK : NOTOK;
+}
+
+/****************************************************************************
+ runTestAllGraphsRangeTest()
+ Runs the command on the whole input file and then on consecutive ranges of
+ its graphs, the last two given as F: to run to the end of the file, the
+ second of which seeks to the end, and checks that the sums of the counts
+ over the ranges match the counts for the whole file. A final range starting
+ past the end of the file must also succeed with no graphs tested.
+ ****************************************************************************/
+
+int runTestAllGraphsRangeTest(char const *commandString, char const *infileName, int numThreads)
+{
+    int Result = OK;
+    char *outputStr = NULL;
+    char *resultsLine = NULL;
+    int rangeStarts[5], rangeCounts[5];
+    int numTested = 0, numOK = 0, numNONEMBEDDABLE = 0;
+    int totalTested = 0, totalOK = 0, totalNONEMBEDDABLE = 0;
+    int sumTested = 0, sumOK = 0, sumNONEMBEDDABLE = 0;
+
+    for (int i = -1; i < 5 && Result == OK; i++)
+    {
+        // The first run is on the whole file, which gives the ranges
+        if (i < 0)
+            Result = TestAllGraphs(commandString, infileName, numThreads, 0, 0, NULL, &outputStr);
+        else if (i != 1 || rangeCounts[i] > 0)
+            Result = TestAllGraphs(commandString, infileName, numThreads, rangeStarts[i], rangeCounts[i], NULL, &outputStr);
+        else
+            continue;
+
+        // The counts are on the line after the header line
+        if (Result == OK)
+        {
+            resultsLine = outputStr == NULL ? NULL : strchr(outputStr, '\n');
+            if (resultsLine == NULL ||
+                sscanf(resultsLine + 1, "%*s %d %d %d", &numTested, &numOK, &numNONEMBEDDABLE) != 3)
+                Result = NOTOK;
+        }
+
+        if (Result == OK && i < 0)
+        {
+            totalTested = numTested;
+            totalOK = numOK;
+            totalNONEMBEDDABLE = numNONEMBEDDABLE;
+
+            rangeStarts[0] = 0;
+            rangeCounts[0] = 1;
+            rangeStarts[1] = 1;
+            rangeCounts[1] = (totalTested + 1) / 2 - 1;
+            rangeStarts[2] = (totalTested + 1) / 2;
+            rangeCounts[2] = 0;
+            rangeStarts[3] = totalTested;
+            rangeCounts[3] = 0;
+            rangeStarts[4] = totalTested + 1;
+            rangeCounts[4] = 1;
+        }
+        else if (Result == OK)
+        {
+            sumTested += numTested;
+            sumOK += numOK;
+            sumNONEMBEDDABLE += numNONEMBEDDABLE;
+
+            // Seeking to or past the end gives no graphs to test
+            if (i >= 3 && numTested != 0)
+                Result = NOTOK;
+        }
+
+        if (outputStr != NULL)
+        {
+            free(outputStr);
+            outputStr = NULL;
+        }
+    }
+
+    if (Result == OK &&
+        (sumTested != totalTested || sumOK != totalOK || sumNONEMBEDDABLE != totalNONEMBEDDABLE))
+        Result = NOTOK;
+
+    gp_Message(" ");
+
+    return Result;
+}
+
+/****************************************************************************
+ writeMixedLineEndingG6File()
+ Writes the first numGraphs lines of the .g6 input file to the output file,
+ ending the second line with CR LF and the others with LF, so that the lines
+ are not of fixed width and a mapped reader must index them to seek.
+ ****************************************************************************/
+
+int writeMixedLineEndingG6File(char const *infileName, char const *outfileName, int numGraphs)
+{
+    int Result = OK;
+    FILE *infile = NULL, *outfile = NULL;
+    char lineBuff[MAXLINE + 1];
+    size_t lineLen = 0;
+
+    if ((infile = fopen(infileName, READTEXT)) == NULL ||
+        (outfile = fopen(outfileName, "wb")) == NULL)
+        Result = NOTOK;
+
+    for (int lineNum = 1; Result == OK && lineNum <= numGraphs; lineNum++)
+    {
+        if (fgets(lineBuff, MAXLINE + 1, infile) == NULL ||
+            (lineLen = strlen(lineBuff)) == 0 || lineBuff[lineLen - 1] != '\n')
+        {
+            Result = NOTOK;
+            break;
+        }
+
+        lineBuff[lineLen - 1] = '\0';
+        if (fprintf(outfile, "%s%s", lineBuff, lineNum == 2 ? "\r\n" : "\n") < 0)
+            Result = NOTOK;
+    }
+
+    if (infile != NULL)
+        fclose(infile);
+    if (outfile != NULL && fclose(outfile) != 0)
+        Result = NOTOK;
+
+    return Result;
+}
+
 int runSpecificGraphTest(char const *commandString, char const *infileName, int inputInMemFlag)
 {
     int Result = OK;
@@ -1272,13 +1615,14 @@ int runGraphTransformationTest(char const *command, char const *infileName, int
  callRandomGraphs()
  ****************************************************************************/
 
-// 'planarity -r [-q] C K N [O]': Random graphs
+// 'planarity -r [-q] [-j N] [-seed S] C K N [O]': Random graphs
 int callRandomGraphs(int argc, char *argv[])
 {
-    int offset = 0, NumGraphs = 0, SizeOfGraphs = 0;
+    int offset = 0, NumGraphs = 0, SizeOfGraphs = 0, numThreads = 1, seedGiven = FALSE;
+    unsigned long long seed = 0;
     char *commandString = NULL, *outfileName = NULL;
 
-    if (argc < 5 || argc > 7)
+    if (argc < 5)
         return NOTOK;
 
     if (strncmp(argv[2], "-q", 2) == 0)
@@ -1289,7 +1633,11 @@ int callRandomGraphs(int argc, char *argv[])
         offset = 1;
     }
 
-    if (argc > (6 + offset))
+    if (parseOptionalNumThreads(argc, argv, &offset, &numThreads) != OK ||
+        parseOptionalSeed(argc, argv, &offset, &seed, &seedGiven) != OK)
+        return NOTOK;
+
+    if (argc < (5 + offset) || argc > (6 + offset))
         return NOTOK;
 
     commandString = argv[2 + offset];
@@ -1299,7 +1647,7 @@ int callRandomGraphs(int argc, char *argv[])
     if (argc == (6 + offset))
         outfileName = argv[5 + offset];
 
-    return RandomGraphs(commandString, NumGraphs, SizeOfGraphs, outfileName, FALSE, FALSE);
+    return RandomGraphs(commandString, NumGraphs, SizeOfGraphs, seedGiven ? &seed : NULL, numThreads, outfileName, FALSE, FALSE);
 }
 
 /****************************************************************************
@@ -1341,10 +1689,11 @@ int callSpecificGraph(int argc, char *argv[])
  callRandomMaxPlanarGraph()
  ****************************************************************************/
 
-// 'planarity -rm [-q] N O [O2]': Maximal planar random graph
+// 'planarity -rm [-q] [-seed S] N O [O2]': Maximal planar random graph
 int callRandomMaxPlanarGraph(int argc, char *argv[])
 {
-    int offset = 0, numVertices = 0;
+    int offset = 0, numVertices = 0, seedGiven = FALSE;
+    unsigned long long seed = 0;
     char *outfileName = NULL, *outfile2Name = NULL;
 
     if (argc < 4)
@@ -1358,7 +1707,10 @@ int callRandomMaxPlanarGraph(int argc, char *argv[])
         offset = 1;
     }
 
-    if (argc > (5 + offset))
+    if (parseOptionalSeed(argc, argv, &offset, &seed, &seedGiven) != OK)
+        return NOTOK;
+
+    if (argc < (4 + offset) || argc > (5 + offset))
         return NOTOK;
 
     numVertices = atoi(argv[2 + offset]);
@@ -1367,17 +1719,18 @@ int callRandomMaxPlanarGraph(int argc, char *argv[])
     if (argc == 5 + offset)
         outfile2Name = argv[4 + offset];
 
-    return RandomGraph("-p", 0, numVertices, outfileName, outfile2Name);
+    return RandomGraph("-p", 0, numVertices, seedGiven ? &seed : NULL, outfileName, outfile2Name);
 }
 
 /****************************************************************************
  callRandomNonplanarGraph()
  ****************************************************************************/
 
-// 'planarity -rn [-q] N O [O2]': Non-planar random graph (maximal planar plus edge)
+// 'planarity -rn [-q] [-seed S] N O [O2]': Non-planar random graph (maximal planar plus edge)
 int callRandomNonplanarGraph(int argc, char *argv[])
 {
-    int offset = 0, numVertices = 0;
+    int offset = 0, numVertices = 0, seedGiven = FALSE;
+    unsigned long long seed = 0;
     char *outfileName = NULL, *outfile2Name = NULL;
 
     if (argc < 4)
@@ -1391,7 +1744,10 @@ int callRandomNonplanarGraph(int argc, char *argv[])
         offset = 1;
     }
 
-    if (argc > (5 + offset))
+    if (parseOptionalSeed(argc, argv, &offset, &seed, &seedGiven) != OK)
+        return NOTOK;
+
+    if (argc < (4 + offset) || argc > (5 + offset))
         return NOTOK;
 
     numVertices = atoi(argv[2 + offset]);
@@ -1400,7 +1756,141 @@ int callRandomNonplanarGraph(int argc, char *argv[])
     if (argc == 5 + offset)
         outfile2Name = argv[4 + offset];
 
-    return RandomGraph("-p", 1, numVertices, outfileName, outfile2Name);
+    return RandomGraph("-p", 1, numVertices, seedGiven ? &seed : NULL, outfileName, outfile2Name);
+}
+
+/****************************************************************************
+ parseOptionalNumThreads()
+ If the next argument, at argv[2 + *pOffset], is -j, then the number of
+ threads that follows it is parsed into *pNumThreads, and *pOffset is
+ advanced past both arguments. Otherwise, *pNumThreads is not changed.
+ ****************************************************************************/
+
+int parseOptionalNumThreads(int argc, char *argv[], int *pOffset, int *pNumThreads)
+{
+    if (argc <= (2 + *pOffset) || strcmp(argv[2 + *pOffset], "-j") != 0)
+        return OK;
+
+    if (argc <= (3 + *pOffset))
+        return NOTOK;
+
+    if ((*pNumThreads = atoi(argv[3 + *pOffset])) < 1)
+    {
+        gp_ErrorMessage("Number of threads must be a positive integer.");
+        return NOTOK;
+    }
+
+    *pOffset += 2;
+
+    return OK;
+}
+
+/****************************************************************************
+ parseOptionalSeed()
+ If the next argument, at argv[2 + *pOffset], is -seed, then the seed that
+ follows it is parsed into *pSeed, *pSeedGiven is set to TRUE, and *pOffset
+ is advanced past both arguments. Otherwise, *pSeedGiven is set to FALSE.
+ ****************************************************************************/
+
+int parseOptionalSeed(int argc, char *argv[], int *pOffset, unsigned long long *pSeed, int *pSeedGiven)
+{
+    char *seedString = NULL, *endPtr = NULL;
+
+    *pSeedGiven = FALSE;
+
+    if (argc <= (2 + *pOffset) || strcmp(argv[2 + *pOffset], "-seed") != 0)
+        return OK;
+
+    if (argc <= (3 + *pOffset))
+        return NOTOK;
+
+    seedString = argv[3 + *pOffset];
+    if (isdigit((unsigned char)seedString[0]))
+        *pSeed = strtoull(seedString, &endPtr, 10);
+
+    if (endPtr == NULL || *endPtr != '\0')
+    {
+        gp_ErrorMessage("Random seed must be a non-negative integer.");
+        return NOTOK;
+    }
+
+    *pSeedGiven = TRUE;
+    *pOffset += 2;
+
+    return OK;
+}
+
+/****************************************************************************
+ parseOptionalRange()
+ If the next argument, at argv[2 + *pOffset], is -range (or --range), then the
+ range F:C that follows it is parsed into the zero-based number F of the first
+ graph and the number C of graphs, and *pOffset is advanced past both
+ arguments. The count C may be omitted (i.e. F:) to mean the rest of the
+ graphs, in which case *pNumGraphs is 0, as it is if there is no range.
+ ****************************************************************************/
+
+int parseOptionalRange(int argc, char *argv[], int *pOffset, int *pFirstGraph, int *pNumGraphs)
+{
+    char *rangeString = NULL, *endPtr = NULL;
+    long firstGraph = -1, numGraphs = 0;
+
+    if (argc <= (2 + *pOffset) ||
+        (strcmp(argv[2 + *pOffset], "-range") != 0 && strcmp(argv[2 + *pOffset], "--range") != 0))
+        return OK;
+
+    if (argc <= (3 + *pOffset))
+        return NOTOK;
+
+    rangeString = argv[3 + *pOffset];
+    if (isdigit((unsigned char)rangeString[0]))
+        firstGraph = strtol(rangeString, &endPtr, 10);
+
+    if (endPtr != NULL && *endPtr == ':')
+    {
+        rangeString = endPtr + 1;
+        endPtr = rangeString;
+        if (isdigit((unsigned char)rangeString[0]))
+        {
+            if ((numGraphs = strtol(rangeString, &endPtr, 10)) < 1)
+                endPtr = NULL;
+        }
+    }
+    else
+        endPtr = NULL;
+
+    if (endPtr == NULL || *endPtr != '\0' || firstGraph < 0 || firstGraph > INT_MAX || numGraphs > INT_MAX)
+    {
+        gp_ErrorMessage("Range must be F:C or F: for the zero-based number F of the "
+                        "first graph and the positive number C of graphs.");
+        return NOTOK;
+    }
+
+    *pFirstGraph = (int)firstGraph;
+    *pNumGraphs = (int)numGraphs;
+    *pOffset += 2;
+
+    return OK;
+}
+
+/****************************************************************************
+ parseOptionalIndexFile()
+ If the next argument is -index, then *pIndexFileOut is set to 'y' so that
+ the index of a .g6 input file whose lines are not of fixed width is read
+ from and saved to the sidecar file named by the input file name plus ".idx",
+ and *pOffset is advanced past it. Otherwise, the index is only kept in
+ memory.
+ ****************************************************************************/
+
+int parseOptionalIndexFile(int argc, char *argv[], int *pOffset, char *pIndexFileOut)
+{
+    if (argc <= (2 + *pOffset) ||
+        (strcmp(argv[2 + *pOffset], "-index") != 0 && strcmp(argv[2 + *pOffset], "--index") != 0))
+        return OK;
+
+    *pIndexFileOut = 'y';
+    *pOffset += 1;
+
+    return OK;
 }
 
 /****************************************************************************
@@ -1445,14 +1935,23 @@ int callTransformGraph(int argc, char *argv[])
  callTestAllGraphs()
  ****************************************************************************/
 
-// 'planarity -t [-q] C I O': If the command line argument after -t [-q] is a
-// recognized algorithm command C, then the input file I must be in ".g6" format
-// (report an error otherwise), and the algorithm(s) indicated by C are executed
-// on the graph(s) in the input file, with the results of the execution stored
-// in output file O.
+// 'planarity -t [-q] [-j N] [-range F:C] [-index] C I O': If the command line
+// argument after -t [-q] [-j N] [-range F:C] [-index] is a recognized algorithm
+// command C, then the input file I must be in ".g6" format (report an error
+// otherwise), and the algorithm(s) indicated by C are executed on the graph(s)
+// in the input file, with the results of the execution stored in output file O.
+// The optional -j N
+// divides the graphs in the input file among N worker threads. The optional
+// -range F:C restricts the graphs to the C graphs (or, for F:, all graphs)
+// starting with the zero-based graph number F, i.e. on line F+1 of I. The
+// optional -index reads and saves the index of the lines of I in the file I.idx
+// if the lines are not of fixed width; otherwise, nothing is written next to I.
+// If C has two or more algorithm commands, e.g. -pdo234, then all of them are
+// run on each graph in one pass over I, on a single thread, so -j N with N > 1
+// is reported as an error.
 int callTestAllGraphs(int argc, char *argv[])
 {
-    int offset = 0;
+    int offset = 0, numThreads = 1, firstGraph = 0, numGraphs = 0;
     char *commandString = NULL;
     char *infileName = NULL, *outfileName = NULL;
 
@@ -1467,7 +1966,12 @@ int callTestAllGraphs(int argc, char *argv[])
         offset = 1;
     }
 
-    if (argc > (5 + offset))
+    if (parseOptionalNumThreads(argc, argv, &offset, &numThreads) != OK ||
+        parseOptionalRange(argc, argv, &offset, &firstGraph, &numGraphs) != OK ||
+        parseOptionalIndexFile(argc, argv, &offset, &G6IndexFileOut) != OK)
+        return NOTOK;
+
+    if (argc != (5 + offset))
         return NOTOK;
 
     commandString = argv[2 + offset];
@@ -1476,7 +1980,7 @@ int callTestAllGraphs(int argc, char *argv[])
     outfileName = argv[4 + offset];
 
     // NOTE: We don't want to write to string, so pOutputStr is NULL
-    return TestAllGraphs(commandString, infileName, outfileName, NULL);
+    return TestAllGraphs(commandString, infileName, numThreads, firstGraph, numGraphs, outfileName, NULL);
 }
 /****************************************************************************
  testPetersenDigraph()
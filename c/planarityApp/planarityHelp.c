@@ -82,16 +82,32 @@ int helpMessage(char *param)
     else if (strcmp(param, "-menu") == 0)
     {
         gp_Message(
-            "'planarity -r [-q] C K N [O]': Random graphs\n"
+            "'planarity -r [-q] [-j N] [-seed S] C K N [O]': Random graphs\n"
             "'planarity -s [-q] C I O [O2]': Specific graph\n"
-            "'planarity -rm [-q] N O [O2]': Random maximal planar graph\n"
-            "'planarity -rn [-q] N O [O2]': Random nonplanar graph (maximal planar + edge)\n"
-            "'planarity -t [-q] C I O': Test algorithm on graph(s) in .g6 file\n"
+            "'planarity -rm [-q] [-seed S] N O [O2]': Random maximal planar graph\n"
+            "'planarity -rn [-q] [-seed S] N O [O2]': Random nonplanar graph (maximal planar + edge)\n"
+            "'planarity -t [-q] [-j N] [-range F:C] [-index] C I O': Test algorithm on graph(s) in .g6 file\n"
             "'planarity -x [-q] -(gam) I O': Transform graph to .g6 (g), Adjacency List (a), or Adjacency Matrix (m)\n"
             "'planarity I O [-n O2]': Legacy command-line (default -s -p)\n");
 
         gp_Message("-q is for quiet mode (no messages to stdout and stderr)\n");
 
+        gp_Message("-j N is for dividing the graphs of a .g6 file (-t) or the random\n"
+                   "    graphs to generate (-r) among N threads; -t with two or more\n"
+                   "    algorithm commands runs on one thread, so N must then be 1\n");
+
+        gp_Message("-seed S is for reproducing random graphs; for -r, graph number i\n"
+                   "    (from 0) is generated with seed S+i (default S is the current time)\n");
+
+        gp_Message("-range F:C is for testing only C graphs of a .g6 file (-t), starting\n"
+                   "    with graph number F (from 0), i.e. line F+1; with F:, all graphs\n"
+                   "    from F to the end of the file are tested (none if F is at or\n"
+                   "    past the end)\n");
+
+        gp_Message("-index is for reading and saving the index of a .g6 file (-t) whose\n"
+                   "    lines are not all of the same length in the file I.idx, so that\n"
+                   "    later runs on the file need not scan it to count or seek graphs\n");
+
         gp_Message("%s", GetAlgorithmFlags());
 
         gp_Message(
@@ -0,0 +1,1314 @@
+/*
+Copyright (c) 1997-2026, John M. Boyer
+All rights reserved.
+See the LICENSE.TXT file for licensing information.
+*/
+
+#include <limits.h>
+
+#include "planarity.h"
+
+typedef struct
+{
+    char const *name;
+    int (*runTests)(void);
+} libraryTestStruct;
+
+int runEmbedPrefilterTests(void);
+int runTestOnlyAgreementTests(void);
+int runTestOnlyAgreementTest(graphP origGraph, unsigned embedFlags);
+graphP createRandomTestGraph(int N, int M);
+int runCSRTests(void);
+int runCSRTest(graphP theGraph);
+int runCapacityLimitTests(void);
+int runAllocatorTests(void);
+void *countingMalloc(size_t size, void *userData);
+void *countingRealloc(void *ptr, size_t size, void *userData);
+void countingFree(void *ptr, void *userData);
+int runEdgeIndexTests(void);
+int runAddEdgesBulkTests(void);
+int runCompactEdgeStorageTests(void);
+int runEmbedMultiTests(void);
+int runVertexPermutationTests(void);
+int runDeferredIsolationTests(void);
+int runDeferredIsolationTest(graphP origGraph, unsigned embedFlags);
+int runTryAddEdgeTests(void);
+int runEdgeIndexTest(graphP theGraph);
+int checkEdgeIndex(graphP theGraph);
+
+/****************************************************************************
+ The tests of the Graph Library API, in the order run by runLibraryTests().
+ ****************************************************************************/
+
+libraryTestStruct libraryTests[] = {
+    {"Embed Prefilter", runEmbedPrefilterTests},
+    {"Test-Only Agreement", runTestOnlyAgreementTests},
+    {"CSR", runCSRTests},
+    {"Capacity Limit", runCapacityLimitTests},
+    {"Allocator", runAllocatorTests},
+    {"Edge Index", runEdgeIndexTests},
+    {"AddEdgesBulk", runAddEdgesBulkTests},
+    {"Compact Edge Storage", runCompactEdgeStorageTests},
+    {"EmbedMulti", runEmbedMultiTests},
+    {"Vertex Permutation", runVertexPermutationTests},
+    {"Deferred Isolation", runDeferredIsolationTests},
+    {"TryAddEdge", runTryAddEdgeTests}};
+
+// The random graphs and numbers of each test come from this generator,
+// which is seeded before each test so that its graphs do not depend on
+// which tests ran before it
+randomGeneratorStruct libraryTestGenerator;
+
+/****************************************************************************
+ runLibraryTests()
+ Runs the tests of the Graph Library API, stopping at the first that fails.
+ Each test reports the details of a failure, and this reports which test
+ failed.
+ ****************************************************************************/
+
+int runLibraryTests(void)
+{
+    int numTests = (int)(sizeof(libraryTests) / sizeof(libraryTests[0]));
+
+    for (int i = 0; i < numTests; i++)
+    {
+        gp_Message("Starting %s Tests", libraryTests[i].name);
+
+        gp_SeedRandomGenerator(&libraryTestGenerator, 12345);
+        if (libraryTests[i].runTests() != OK)
+        {
+            gp_ErrorMessage("%s test failed.", libraryTests[i].name);
+            return NOTOK;
+        }
+
+        gp_Message("Finished %s Tests.\n", libraryTests[i].name);
+    }
+
+    return OK;
+}
+
+/****************************************************************************
+ createRandomTestGraph()
+ Creates a graph of N vertices with M random edges from the test generator,
+ or with the random number of edges chosen by gp_CreateRandomGraph() if M is
+ 0. The edge capacity is increased if needed to hold the M edges.
+ Returns the new graph, or NULL on error.
+ ****************************************************************************/
+
+graphP createRandomTestGraph(int N, int M)
+{
+    graphP theGraph = NULL;
+
+    if ((theGraph = gp_New()) == NULL ||
+        gp_EnsureVertexCapacity(theGraph, N) != OK ||
+        (M > 0 && gp_EnsureEdgeCapacity(theGraph, M) != OK))
+    {
+        gp_Free(&theGraph);
+        return NULL;
+    }
+
+    gp_SetRandomGenerator(theGraph, &libraryTestGenerator);
+
+    if ((M > 0 ? gp_CreateRandomGraphEx(theGraph, M) : gp_CreateRandomGraph(theGraph)) != OK)
+        gp_Free(&theGraph);
+
+    return theGraph;
+}
+
+/****************************************************************************
+ runEmbedPrefilterTests()
+ Tests that the edge bound prefilter of test-only gp_Embed() decides a simple
+ graph with too many edges, but not a planar (or outerplanar) multigraph whose
+ edges exceed the bound only because of parallel edges and loops, which is
+ left to the other prefilters or to the embedder.
+ ****************************************************************************/
+
+int runEmbedPrefilterTests(void)
+{
+    graphP theGraph = NULL;
+    embedPrefilterStatsStruct stats;
+    int v0 = 0, Result = OK;
+
+    gp_ClearEmbedPrefilterStats();
+
+    // K5 has 10 edges, more than 3N-6 = 9
+    if ((theGraph = gp_New()) == NULL || gp_EnsureVertexCapacity(theGraph, 5) != OK)
+        Result = NOTOK;
+    else
+    {
+        v0 = gp_LowerBoundVertices(theGraph);
+        for (int u = 0; u < 5 && Result == OK; u++)
+            for (int v = u + 1; v < 5 && Result == OK; v++)
+                if (gp_AddEdge(theGraph, v0 + u, 0, v0 + v, 0) != OK)
+                    Result = NOTOK;
+    }
+
+    if (Result == OK &&
+        (gp_Embed(theGraph, EMBEDFLAGS_PLANAR | EMBEDFLAGS_TESTONLY) != NONEMBEDDABLE ||
+         (gp_GetEmbedPrefilterStats(&stats), stats.numEdgeBoundHits != 1)))
+        Result = NOTOK;
+
+    gp_Free(&theGraph);
+
+    // K4 with each edge doubled and a loop has 13 edges, more than 3N-6 = 6,
+    // and a 4-cycle with each edge doubled has 8 edges, more than 2N-3 = 5
+    for (int outerplanar = 0; outerplanar <= 1 && Result == OK; outerplanar++)
+    {
+        if ((theGraph = gp_New()) == NULL || gp_EnsureVertexCapacity(theGraph, 4) != OK ||
+            gp_EnsureEdgeCapacity(theGraph, 13) != OK)
+            Result = NOTOK;
+        else
+        {
+            v0 = gp_LowerBoundVertices(theGraph);
+            for (int u = 0; u < 4 && Result == OK; u++)
+                for (int v = u + 1; v < 4 && Result == OK; v++)
+                    if ((!outerplanar || v == u + 1 || (u == 0 && v == 3)) &&
+                        (gp_AddEdge(theGraph, v0 + u, 0, v0 + v, 0) != OK ||
+                         gp_AddEdge(theGraph, v0 + u, 0, v0 + v, 0) != OK))
+                        Result = NOTOK;
+
+            if (Result == OK && !outerplanar && gp_AddEdge(theGraph, v0, 0, v0, 0) != OK)
+                Result = NOTOK;
+        }
+
+        if (Result == OK &&
+            (gp_Embed(theGraph, (outerplanar ? EMBEDFLAGS_OUTERPLANAR : EMBEDFLAGS_PLANAR) | EMBEDFLAGS_TESTONLY) == NOTOK ||
+             (gp_GetEmbedPrefilterStats(&stats), stats.numEdgeBoundHits != 1)))
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+    }
+
+    return Result;
+}
+
+/****************************************************************************
+ runTestOnlyAgreementTests()
+ gp_TestEmbedResultIntegrity() cannot check the answer of a test-only
+ gp_Embed(), since it leaves neither an embedding nor an obstruction, so this
+ tests that the answers for planarity and outerplanarity agree with those of
+ full embeddings whose integrity is checked. The graphs are all graphs on 8
+ vertices and random graphs with a range of edge counts, and each prefilter
+ must decide some of them, so that its answers are checked too.
+ ****************************************************************************/
+
+int runTestOnlyAgreementTests(void)
+{
+    graphP theGraph = NULL;
+    G6ReadIteratorP theG6ReadIterator = NULL;
+    embedPrefilterStatsStruct stats;
+    int N = 30, M, lineNum = 0, Result = OK;
+
+    gp_ClearEmbedPrefilterStats();
+
+    if ((theGraph = gp_New()) == NULL ||
+        g6_NewReader(&theG6ReadIterator, theGraph) != OK ||
+        g6_InitReaderWithFileName(theG6ReadIterator, "n8.mALL.g6") != OK)
+        Result = NOTOK;
+
+    while (Result == OK)
+    {
+        if (g6_ReadGraph(theG6ReadIterator) != OK)
+        {
+            Result = NOTOK;
+            break;
+        }
+
+        if (g6_EndReached(theG6ReadIterator))
+            break;
+
+        lineNum++;
+
+        if (runTestOnlyAgreementTest(theGraph, EMBEDFLAGS_PLANAR) == NOTOK ||
+            runTestOnlyAgreementTest(theGraph, EMBEDFLAGS_OUTERPLANAR) == NOTOK)
+        {
+            gp_ErrorMessage("Test-only result disagrees for graph on line %d.", lineNum);
+            Result = NOTOK;
+        }
+    }
+
+    g6_FreeReader(&theG6ReadIterator);
+    gp_Free(&theGraph);
+
+    // Random connected graphs, from trees up to those exceeding the edge bound
+    for (M = N - 1; Result == OK && M <= 3 * N; M += 2)
+    {
+        if ((theGraph = createRandomTestGraph(N, M)) == NULL ||
+            runTestOnlyAgreementTest(theGraph, EMBEDFLAGS_PLANAR) == NOTOK ||
+            runTestOnlyAgreementTest(theGraph, EMBEDFLAGS_OUTERPLANAR) == NOTOK)
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+    }
+
+    gp_GetEmbedPrefilterStats(&stats);
+    if (Result == OK &&
+        (stats.numEdgeBoundHits == 0 || stats.numFewEdgesHits == 0 || stats.numFewBranchHits == 0))
+        Result = NOTOK;
+
+    return Result;
+}
+
+/****************************************************************************
+ runTestOnlyAgreementTest()
+ Embeds a copy of origGraph fully and checks the integrity of the result,
+ then tests that a test-only embedding of another copy gives the same result.
+ Returns the result of gp_Embed() if the test succeeds, or NOTOK otherwise.
+ ****************************************************************************/
+
+int runTestOnlyAgreementTest(graphP origGraph, unsigned embedFlags)
+{
+    graphP theGraph = NULL, testGraph = NULL;
+    int expectedResult = NOTOK, Result = OK;
+
+    if ((theGraph = gp_DupGraph(origGraph)) == NULL ||
+        (testGraph = gp_DupGraph(origGraph)) == NULL ||
+        (expectedResult = gp_Embed(theGraph, embedFlags)) == NOTOK ||
+        gp_TestEmbedResultIntegrity(theGraph, origGraph, expectedResult) != expectedResult ||
+        gp_Embed(testGraph, embedFlags | EMBEDFLAGS_TESTONLY) != expectedResult)
+        Result = NOTOK;
+
+    gp_Free(&theGraph);
+    gp_Free(&testGraph);
+
+    return Result == OK ? expectedResult : NOTOK;
+}
+
+/****************************************************************************
+ runCSRTests()
+ Tests the CSR snapshot of a digraph and of the embedding of a random
+ maximal planar graph, whose faces must also be traversed in the snapshot.
+ ****************************************************************************/
+
+int runCSRTests(void)
+{
+    graphP theGraph = NULL, origGraph = NULL;
+    char const *digraphFileName = NULL;
+    gpCSR theCSR;
+    int numFaces = 0, retVal = OK;
+
+    memset(&theCSR, 0, sizeof(gpCSR));
+
+#ifdef USE_1BASEDARRAYS
+    digraphFileName = "Digraph.transposeTest.txt";
+#else
+    digraphFileName = "Digraph.transposeTest.0-based.txt";
+#endif
+
+    // A digraph tests that the CSR writers respect edge directions
+    if ((theGraph = gp_New()) == NULL ||
+        gp_Read(theGraph, digraphFileName) != OK ||
+        runCSRTest(theGraph) != OK)
+    {
+        gp_ErrorMessage("CSR test of \"%s\" failed.", digraphFileName);
+        retVal = NOTOK;
+    }
+    gp_Free(&theGraph);
+
+    // The face traversal of an embedding of a random maximal planar graph
+    // must give the same number of faces as gp_CountEmbeddingFaces()
+    if (retVal == OK)
+    {
+        if ((theGraph = createRandomTestGraph(1000, 3 * 1000 - 6)) == NULL ||
+            (origGraph = gp_DupGraph(theGraph)) == NULL ||
+            gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+            gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK ||
+            runCSRTest(theGraph) != OK ||
+            (numFaces = gp_CountEmbeddingFaces(theGraph)) != 2 * 1000 - 4 ||
+            gp_BuildCSR(theGraph, &theCSR) != OK ||
+            gp_CSRCountEmbeddingFaces(&theCSR) != numFaces)
+            retVal = NOTOK;
+
+        if (retVal != OK)
+            gp_ErrorMessage("CSR face traversal test failed.");
+
+        gp_FreeCSR(&theCSR);
+        gp_Free(&origGraph);
+        gp_Free(&theGraph);
+    }
+
+    return retVal;
+}
+
+/****************************************************************************
+ runCSRTest()
+ Tests that a CSR snapshot of theGraph gives the same vertex degrees and
+ adjacency list output as theGraph, and a GraphML document with one edge
+ element per edge.
+ ****************************************************************************/
+
+int runCSRTest(graphP theGraph)
+{
+    gpCSR theCSR;
+    char *graphStr = NULL, *csrStr = NULL, *edgeTag = NULL;
+    int v, numEdgeTags = 0, retVal = OK;
+
+    if (gp_BuildCSR(theGraph, &theCSR) != OK)
+        return NOTOK;
+
+    for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+        if (gp_CSRGetDegree(&theCSR, v) != gp_GetVertexDegree(theGraph, v))
+            retVal = NOTOK;
+
+    if (retVal == OK &&
+        (gp_WriteToString(theGraph, &graphStr, WRITE_ADJLIST) != OK ||
+         gp_CSRWriteToString(&theCSR, &csrStr, WRITE_ADJLIST) != OK ||
+         strcmp(graphStr, csrStr) != 0))
+        retVal = NOTOK;
+
+    if (csrStr != NULL)
+    {
+        free(csrStr);
+        csrStr = NULL;
+    }
+
+    if (retVal == OK &&
+        gp_CSRWriteToString(&theCSR, &csrStr, WRITE_GRAPHML) != OK)
+        retVal = NOTOK;
+
+    if (retVal == OK)
+    {
+        for (edgeTag = strstr(csrStr, "<edge "); edgeTag != NULL; edgeTag = strstr(edgeTag + 1, "<edge "))
+            numEdgeTags++;
+
+        if (numEdgeTags != gp_GetM(theGraph))
+            retVal = NOTOK;
+    }
+
+    if (graphStr != NULL)
+        free(graphStr);
+    if (csrStr != NULL)
+        free(csrStr);
+
+    gp_FreeCSR(&theCSR);
+
+    return retVal;
+}
+
+/****************************************************************************
+ runCapacityLimitTests()
+ Tests that requests for more vertex or edge capacity than the graph
+ indices can address fail cleanly rather than overflowing, and that a
+ random maximal planar graph can be generated and embedded when N(N-1)
+ exceeds INT_MAX, which used to overflow in gp_CreateRandomGraphEx().
+ ****************************************************************************/
+
+int runCapacityLimitTests(void)
+{
+    graphP theGraph = NULL;
+    int N = 50000, retVal = OK;
+
+    if ((theGraph = gp_New()) == NULL ||
+        gp_EnsureVertexCapacity(theGraph, INT_MAX / 8) == OK ||
+        gp_GetN(theGraph) != 0 ||
+        gp_EnsureEdgeCapacity(theGraph, INT_MAX / 2) == OK ||
+        gp_EnsureEdgeCapacity(theGraph, INT_MAX) == OK)
+    {
+        gp_ErrorMessage("Capacity limit test failed to reject an oversized graph.");
+        retVal = NOTOK;
+    }
+    gp_Free(&theGraph);
+
+#ifndef GP_SMALL_INDEX
+    if (retVal == OK)
+    {
+        if ((theGraph = createRandomTestGraph(N, 3 * N - 6)) == NULL ||
+            gp_GetM(theGraph) != 3 * N - 6 ||
+            gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK)
+            retVal = NOTOK;
+
+        if (retVal != OK)
+            gp_ErrorMessage("Capacity limit test of a maximal planar graph on %d vertices failed.", N);
+
+        gp_Free(&theGraph);
+    }
+#else
+    (void)N;
+#endif
+
+    return retVal;
+}
+
+/****************************************************************************
+ A counting allocator for runAllocatorTests(). Each block is preceded by a
+ header that records its size, so the bytes currently allocated are known.
+ ****************************************************************************/
+
+typedef struct
+{
+    size_t liveBytes;
+    int numAllocs;
+} countingAllocatorStruct;
+
+#define COUNTINGALLOCATOR_HEADER 16
+
+void *countingMalloc(size_t size, void *userData)
+{
+    countingAllocatorStruct *theAllocator = (countingAllocatorStruct *)userData;
+    char *block = (char *)malloc(size + COUNTINGALLOCATOR_HEADER);
+
+    if (block == NULL)
+        return NULL;
+
+    *(size_t *)block = size;
+    theAllocator->liveBytes += size;
+    theAllocator->numAllocs++;
+
+    return block + COUNTINGALLOCATOR_HEADER;
+}
+
+void countingFree(void *ptr, void *userData)
+{
+    countingAllocatorStruct *theAllocator = (countingAllocatorStruct *)userData;
+    char *block = (char *)ptr - COUNTINGALLOCATOR_HEADER;
+
+    theAllocator->liveBytes -= *(size_t *)block;
+    free(block);
+}
+
+void *countingRealloc(void *ptr, size_t size, void *userData)
+{
+    void *newPtr = countingMalloc(size, userData);
+
+    if (newPtr != NULL && ptr != NULL)
+    {
+        size_t oldSize = *(size_t *)((char *)ptr - COUNTINGALLOCATOR_HEADER);
+
+        memcpy(newPtr, ptr, oldSize < size ? oldSize : size);
+        countingFree(ptr, userData);
+    }
+
+    return newPtr;
+}
+
+/****************************************************************************
+ runAllocatorTests()
+ Tests that all memory of a graph is allocated and freed through the
+ allocator set by gp_SetAllocator(), and that gp_GetMemoryUsage() reports
+ exactly the bytes allocated for the graph, both with and without an
+ extension and after the edge capacity grows.
+ ****************************************************************************/
+
+int runAllocatorTests(void)
+{
+    countingAllocatorStruct theAllocator;
+    graphMemoryUsageStruct theUsage;
+    graphP theGraph = NULL;
+    char *graphStr = NULL;
+    int retVal = OK;
+
+    memset(&theAllocator, 0, sizeof(countingAllocatorStruct));
+
+    if (gp_SetAllocator(countingMalloc, NULL, countingFree, &theAllocator) == OK ||
+        gp_SetAllocator(countingMalloc, countingRealloc, countingFree, &theAllocator) != OK)
+    {
+        gp_ErrorMessage("gp_SetAllocator() test failed.");
+        retVal = NOTOK;
+    }
+
+    // The memory usage of a plain graph, then after the edge capacity is
+    // doubled, then with the K3,3 search extension attached
+    if (retVal == OK)
+    {
+        if ((theGraph = gp_New()) == NULL ||
+            gp_EnsureVertexCapacity(theGraph, 100) != OK ||
+            gp_GetMemoryUsage(theGraph, &theUsage) != theAllocator.liveBytes ||
+            theUsage.numExtensions != 0 ||
+            gp_EnsureEdgeCapacity(theGraph, 2 * gp_GetEdgeCapacity(theGraph)) != OK ||
+            gp_GetMemoryUsage(theGraph, NULL) != theAllocator.liveBytes ||
+            gp_ExtendWith_K33Search(theGraph) != OK ||
+            gp_GetMemoryUsage(theGraph, &theUsage) != theAllocator.liveBytes ||
+            theUsage.numExtensions != 1 ||
+            theUsage.extension[0].bytes != theUsage.extensions ||
+            theUsage.base == 0 || theUsage.DFSUtils == 0 || theUsage.planarity == 0 ||
+            gp_EnableEdgeIndex(theGraph) != OK ||
+            gp_GetMemoryUsage(theGraph, NULL) != theAllocator.liveBytes)
+            retVal = NOTOK;
+
+        // Memory returned to the caller comes from the allocator
+        if (retVal == OK &&
+            (gp_CreateRandomGraph(theGraph) != OK ||
+             gp_Embed(theGraph, EMBEDFLAGS_SEARCHFORK33) == NOTOK ||
+             gp_WriteToString(theGraph, &graphStr, WRITE_ADJLIST) != OK ||
+             graphStr == NULL ||
+             gp_GetMemoryUsage(theGraph, NULL) + strlen(graphStr) + 1 > theAllocator.liveBytes))
+            retVal = NOTOK;
+
+        if (graphStr != NULL)
+            gp_MemFree(graphStr);
+        gp_Free(&theGraph);
+
+        if (retVal != OK)
+            gp_ErrorMessage("gp_GetMemoryUsage() test failed.");
+    }
+
+    if (retVal == OK && (theAllocator.liveBytes != 0 || theAllocator.numAllocs == 0))
+    {
+        gp_ErrorMessage("Allocator test leaked %lu bytes.", (unsigned long)theAllocator.liveBytes);
+        retVal = NOTOK;
+    }
+
+    gp_SetAllocator(NULL, NULL, NULL, NULL);
+
+    return retVal;
+}
+
+/****************************************************************************
+ runEdgeIndexTests()
+ Tests that the edge index gives the same vertex degrees and neighbor
+ tests as traversing the adjacency lists, for each 8-vertex graph and
+ for a dense random graph, as edges are deleted, added, hidden, restored
+ and moved by vertex identification.
+ ****************************************************************************/
+
+int runEdgeIndexTests(void)
+{
+    graphP theGraph = NULL;
+    G6ReadIteratorP theG6ReadIterator = NULL;
+    int Result = OK;
+    int lineNum = 0;
+
+    if ((theGraph = gp_New()) == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate graph for edge index tests.");
+        return NOTOK;
+    }
+
+    if (g6_NewReader((&theG6ReadIterator), theGraph) != OK ||
+        g6_InitReaderWithFileName(theG6ReadIterator, "n8.mALL.g6") != OK)
+    {
+        gp_ErrorMessage("Unable to allocate or initialize G6 read iterator for edge index tests.");
+        Result = NOTOK;
+    }
+
+    while (Result == OK)
+    {
+        if (g6_ReadGraph(theG6ReadIterator) != OK)
+        {
+            gp_ErrorMessage("Unable to read graph on line %d for edge index tests.", lineNum + 1);
+            Result = NOTOK;
+            break;
+        }
+
+        if (g6_EndReached(theG6ReadIterator))
+            break;
+
+        lineNum++;
+
+        if (runEdgeIndexTest(theGraph) != OK)
+        {
+            gp_ErrorMessage("Edge index test failed for graph on line %d.", lineNum);
+            Result = NOTOK;
+            break;
+        }
+    }
+
+    g6_FreeReader((&theG6ReadIterator));
+    gp_Free(&theGraph);
+
+    // A dense random graph makes the edge index grow and has long probe runs
+    if (Result == OK)
+    {
+        if ((theGraph = createRandomTestGraph(200, 200 * 199 / 4)) == NULL ||
+            gp_GetM(theGraph) != 200 * 199 / 4 ||
+            gp_IsEdgeIndexEnabled(theGraph) ||
+            runEdgeIndexTest(theGraph) != OK)
+            Result = NOTOK;
+
+        if (Result != OK)
+            gp_ErrorMessage("Edge index test failed for dense random graph.");
+
+        gp_Free(&theGraph);
+    }
+
+    return Result;
+}
+
+int runEdgeIndexTest(graphP theGraph)
+{
+    int u = gp_LowerBoundVertices(theGraph);
+    int e = NIL, v = NIL;
+
+    if (gp_EnableEdgeIndex(theGraph) != OK || !gp_IsEdgeIndexEnabled(theGraph) ||
+        checkEdgeIndex(theGraph) != OK)
+        return NOTOK;
+
+    // Delete an edge of the first vertex, then add it back
+    if (gp_IsEdge(theGraph, (e = gp_GetFirstEdge(theGraph, u))))
+    {
+        v = gp_GetNeighbor(theGraph, e);
+        if (gp_DeleteEdge(theGraph, e) != OK || checkEdgeIndex(theGraph) != OK ||
+            gp_IsNeighbor(theGraph, u, v) || gp_IsNeighbor(theGraph, v, u) ||
+            gp_AddEdge(theGraph, u, 0, v, 1) != OK || checkEdgeIndex(theGraph) != OK)
+            return NOTOK;
+    }
+
+    // Hide a vertex and identify others, then restore them all
+    if (gp_HideVertex(theGraph, u + 1) != OK || checkEdgeIndex(theGraph) != OK ||
+        gp_IdentifyVertices(theGraph, u, u + 2, NIL) != OK || checkEdgeIndex(theGraph) != OK ||
+        gp_IdentifyVertices(theGraph, u, u + 3, NIL) != OK || checkEdgeIndex(theGraph) != OK ||
+        gp_IdentifyVertices(theGraph, u + 4, u + 5, NIL) != OK || checkEdgeIndex(theGraph) != OK ||
+        gp_RestoreVertices(theGraph) != OK || checkEdgeIndex(theGraph) != OK)
+        return NOTOK;
+
+    gp_DisableEdgeIndex(theGraph);
+
+    return gp_IsEdgeIndexEnabled(theGraph) ? NOTOK : OK;
+}
+
+/****************************************************************************
+ checkEdgeIndex()
+ Tests that the degree of each vertex and the result of gp_IsNeighbor()
+ and gp_FindEdge() for each pair of vertices, which are answered by the
+ edge index, agree with a traversal of the adjacency lists.
+ ****************************************************************************/
+
+int checkEdgeIndex(graphP theGraph)
+{
+    int u, v, e, degree, isNeighbor;
+
+    for (u = gp_LowerBoundVertices(theGraph); u < gp_UpperBoundVertices(theGraph); ++u)
+    {
+        degree = 0;
+        e = gp_GetFirstEdge(theGraph, u);
+        while (gp_IsEdge(theGraph, e))
+        {
+            degree++;
+            e = gp_GetNextEdge(theGraph, e);
+        }
+
+        if (gp_GetVertexDegree(theGraph, u) != degree)
+            return NOTOK;
+
+        for (v = gp_LowerBoundVertices(theGraph); v < gp_UpperBoundVertices(theGraph); ++v)
+        {
+            isNeighbor = FALSE;
+            e = gp_GetFirstEdge(theGraph, u);
+            while (gp_IsEdge(theGraph, e) && !isNeighbor)
+            {
+                isNeighbor = gp_GetNeighbor(theGraph, e) == v;
+                e = gp_GetNextEdge(theGraph, e);
+            }
+
+            if (gp_IsNeighbor(theGraph, u, v) != isNeighbor)
+                return NOTOK;
+
+            e = gp_FindEdge(theGraph, u, v);
+            if (isNeighbor ? (gp_IsNotEdge(theGraph, e) || gp_GetNeighbor(theGraph, e) != v ||
+                              gp_GetNeighbor(theGraph, gp_GetTwin(theGraph, e)) != u)
+                           : gp_IsEdge(theGraph, e))
+                return NOTOK;
+        }
+    }
+
+    return OK;
+}
+
+/****************************************************************************
+ runAddEdgesBulkTests()
+ Tests that gp_AddEdgesBulk() gives the same graph as adding the edges one
+ at a time, with loops and duplicate edges skipped, and that it adds no
+ edges if the edge capacity is too small or if any vertex is out of range.
+ ****************************************************************************/
+
+int runAddEdgesBulkTests(void)
+{
+    graphP bulkGraph = NULL, theGraph = NULL;
+    char *bulkStr = NULL, *graphStr = NULL;
+    int u[1000], v[1000];
+    int N = 100, i, Result = OK;
+
+    for (i = 0; i < 1000; i++)
+    {
+        u[i] = gp_GetRandomNumberFromGenerator(&libraryTestGenerator, 0, N - 1) + (NIL == 0 ? 1 : 0);
+        v[i] = gp_GetRandomNumberFromGenerator(&libraryTestGenerator, 0, N - 1) + (NIL == 0 ? 1 : 0);
+    }
+
+    if ((bulkGraph = gp_New()) == NULL || gp_EnsureVertexCapacity(bulkGraph, N) != OK ||
+        (theGraph = gp_New()) == NULL || gp_EnsureVertexCapacity(theGraph, N) != OK)
+        Result = NOTOK;
+
+    // The first batch keeps its loops and duplicates, and deleting an edge
+    // leaves an edge hole for the second batch to fill first. The second
+    // batch needs more than the default edge capacity, which it does not
+    // increase, so it only succeeds once the capacity has been reserved.
+    if (Result == OK &&
+        (gp_AddEdgesBulk(bulkGraph, u, v, 10, 0) != OK ||
+         gp_GetM(bulkGraph) != 10 ||
+         gp_DeleteEdge(bulkGraph, gp_GetFirstEdge(bulkGraph, u[0])) != OK ||
+         gp_GetEdgeCapacity(bulkGraph) >= 9 + 1000 ||
+         gp_AddEdgesBulk(bulkGraph, u, v, 1000, ADDEDGES_SKIPLOOPS | ADDEDGES_SKIPDUPLICATES) != AT_EDGE_CAPACITY_LIMIT ||
+         gp_GetM(bulkGraph) != 9 ||
+         gp_EnsureEdgeCapacity(bulkGraph, 9 + 2 * 1000) != OK ||
+         gp_AddEdgesBulk(bulkGraph, u, v, 1000, ADDEDGES_SKIPLOOPS | ADDEDGES_SKIPDUPLICATES) != OK))
+        Result = NOTOK;
+
+    for (i = 0; Result == OK && i < 10; i++)
+        if (gp_DynamicAddEdge(theGraph, u[i], 0, v[i], 0) != OK)
+            Result = NOTOK;
+
+    if (Result == OK && gp_DeleteEdge(theGraph, gp_GetFirstEdge(theGraph, u[0])) != OK)
+        Result = NOTOK;
+
+    for (i = 0; Result == OK && i < 1000; i++)
+    {
+        if (u[i] != v[i] && !gp_IsNeighbor(theGraph, u[i], v[i]) &&
+            gp_DynamicAddEdge(theGraph, u[i], 0, v[i], 0) != OK)
+            Result = NOTOK;
+    }
+
+    if (Result == OK &&
+        (gp_GetM(bulkGraph) != gp_GetM(theGraph) ||
+         gp_WriteToString(bulkGraph, &bulkStr, WRITE_ADJLIST) != OK ||
+         gp_WriteToString(theGraph, &graphStr, WRITE_ADJLIST) != OK ||
+         strcmp(bulkStr, graphStr) != 0))
+        Result = NOTOK;
+
+    // An out of range vertex in the last edge means no edges are added
+    if (Result == OK)
+    {
+        u[999] = gp_UpperBoundVertexStorage(bulkGraph);
+        i = gp_GetM(bulkGraph);
+        if (gp_AddEdgesBulk(bulkGraph, u, v, 1000, 0) == OK || gp_GetM(bulkGraph) != i)
+            Result = NOTOK;
+    }
+
+    if (bulkStr != NULL)
+        free(bulkStr);
+    if (graphStr != NULL)
+        free(graphStr);
+    gp_Free(&bulkGraph);
+    gp_Free(&theGraph);
+
+    return Result;
+}
+
+/****************************************************************************
+ runCompactEdgeStorageTests()
+ Deletes a third of the edges of a random maximal planar graph, then tests
+ that gp_CompactEdgeStorage() removes the edge holes without changing the
+ adjacency lists, that the old to new map and the edge index are correct,
+ and that the planar drawing extension, which requires a graph with no edge
+ holes, can then draw the graph.
+ ****************************************************************************/
+
+int runCompactEdgeStorageTests(void)
+{
+    graphP theGraph = NULL, origGraph = NULL;
+    char *beforeStr = NULL, *afterStr = NULL;
+    int *oldToNewMap = NULL, *oldNeighbors = NULL;
+    int N = 200, oldUpperBound = 0, e, Result = OK;
+
+    if ((theGraph = createRandomTestGraph(N, 3 * N - 6)) == NULL ||
+        gp_ExtendWith_DrawPlanar(theGraph) != OK ||
+        gp_EnableEdgeIndex(theGraph) != OK)
+        Result = NOTOK;
+
+    for (e = gp_LowerBoundEdges(theGraph); Result == OK && e < gp_UpperBoundEdges(theGraph); e += 6)
+        if (gp_DeleteEdge(theGraph, e) != OK)
+            Result = NOTOK;
+
+    if (Result == OK)
+    {
+        oldUpperBound = gp_UpperBoundEdges(theGraph);
+        if (theGraph->numEdgeHoles == 0 ||
+            (oldToNewMap = (int *)malloc(oldUpperBound * sizeof(int))) == NULL ||
+            (oldNeighbors = (int *)malloc(oldUpperBound * sizeof(int))) == NULL ||
+            gp_WriteToString(theGraph, &beforeStr, WRITE_ADJLIST) != OK)
+            Result = NOTOK;
+    }
+
+    if (Result == OK)
+    {
+        for (e = gp_LowerBoundEdges(theGraph); e < oldUpperBound; e++)
+            oldNeighbors[e] = gp_GetNeighbor(theGraph, e);
+
+        if (gp_CompactEdgeStorage(theGraph, oldToNewMap) != OK ||
+            theGraph->numEdgeHoles != 0 ||
+            gp_UpperBoundEdges(theGraph) != gp_LowerBoundEdges(theGraph) + 2 * gp_GetM(theGraph) ||
+            gp_WriteToString(theGraph, &afterStr, WRITE_ADJLIST) != OK ||
+            strcmp(beforeStr, afterStr) != 0 ||
+            checkEdgeIndex(theGraph) != OK)
+            Result = NOTOK;
+    }
+
+    // Each edge record in use moved to the new location given by the map,
+    // and the edge records vacated at the end of the old edge storage are
+    // no longer in use
+    for (e = gp_LowerBoundEdges(theGraph); Result == OK && e < oldUpperBound; e++)
+    {
+        if (oldNeighbors[e] == NIL ? oldToNewMap[e] != NIL
+                                   : oldToNewMap[e] == NIL || gp_GetNeighbor(theGraph, oldToNewMap[e]) != oldNeighbors[e])
+            Result = NOTOK;
+        else if (e >= gp_UpperBoundEdges(theGraph) && gp_EdgeInUse(theGraph, e))
+            Result = NOTOK;
+    }
+
+    if (Result == OK &&
+        ((origGraph = gp_DupGraph(theGraph)) == NULL ||
+         gp_Embed(theGraph, EMBEDFLAGS_DRAWPLANAR) != OK ||
+         gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK))
+        Result = NOTOK;
+
+    if (beforeStr != NULL)
+        free(beforeStr);
+    if (afterStr != NULL)
+        free(afterStr);
+    if (oldToNewMap != NULL)
+        free(oldToNewMap);
+    if (oldNeighbors != NULL)
+        free(oldNeighbors);
+    gp_Free(&origGraph);
+    gp_Free(&theGraph);
+
+    return Result;
+}
+
+/****************************************************************************
+ runEmbedMultiTests()
+ Tests that gp_EmbedMulti(), when it allocates the graphs for embedding,
+ gives the same result for each algorithm as gp_Embed() on a copy of the
+ graph, for random graphs that are sparse and dense.
+ ****************************************************************************/
+
+int runEmbedMultiTests(void)
+{
+    graphP theGraph = NULL, theCopy = NULL;
+    char const *commands = GRAPHALGORITHMCHOICES;
+    unsigned embedFlagsArray[sizeof(GRAPHALGORITHMCHOICES)];
+    int results[sizeof(GRAPHALGORITHMCHOICES)];
+    int numCommands = (int)strlen(GRAPHALGORITHMCHOICES);
+    int N = 50, embedFlags = 0, Result = OK;
+
+    for (int i = 0; Result == OK && i < numCommands; i++)
+    {
+        if (GetEmbedFlags(commands[i], '\0', &embedFlags) != OK)
+            Result = NOTOK;
+        embedFlagsArray[i] = (unsigned)embedFlags;
+    }
+
+    for (int numEdges = N; Result == OK && numEdges <= 3 * N; numEdges += N)
+    {
+        if ((theGraph = createRandomTestGraph(N, numEdges)) == NULL)
+            Result = NOTOK;
+
+        // Each expected result is obtained on a copy made before the
+        // DFS preprocessing performed on theGraph by gp_EmbedMulti()
+        for (int i = 0; Result == OK && i < numCommands; i++)
+        {
+            if ((theCopy = gp_DupGraph(theGraph)) == NULL ||
+                ExtendGraph(theCopy, commands[i]) != OK)
+                Result = NOTOK;
+            else
+                results[i] = gp_Embed(theCopy, embedFlagsArray[i]);
+
+            gp_Free(&theCopy);
+        }
+
+        if (Result == OK)
+        {
+            int expectedResults[sizeof(GRAPHALGORITHMCHOICES)];
+
+            memcpy(expectedResults, results, sizeof(results));
+            if (gp_EmbedMulti(theGraph, numCommands, embedFlagsArray, NULL, results) != OK ||
+                memcmp(expectedResults, results, sizeof(results)) != 0)
+                Result = NOTOK;
+        }
+
+        gp_Free(&theGraph);
+    }
+
+    return Result;
+}
+
+/****************************************************************************
+ runVertexPermutationTests()
+ Tests that, after gp_Embed() of a random maximal planar graph, which keeps
+ all of the edges, gp_GetOriginalVertexIndex() maps the edges of the graph
+ in DFI order onto the edges of the original graph, and gp_GetDFIOfOriginal()
+ gives the inverse permutation. Also tests that sorting a path, whose DFS
+ visits the vertices in order, leaves it unchanged other than the sort order.
+ ****************************************************************************/
+
+int runVertexPermutationTests(void)
+{
+    graphP theGraph = NULL, origGraph = NULL;
+    char *beforeStr = NULL, *afterStr = NULL;
+    int *dfiOfOriginal = NULL;
+    int N = 100, v, e, Result = OK;
+
+    if ((theGraph = createRandomTestGraph(N, 3 * N - 6)) == NULL ||
+        (origGraph = gp_DupGraph(theGraph)) == NULL ||
+        gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+        (dfiOfOriginal = (int *)malloc(gp_UpperBoundVertices(theGraph) * sizeof(int))) == NULL ||
+        gp_GetDFIOfOriginal(theGraph, dfiOfOriginal) != OK)
+        Result = NOTOK;
+
+    for (v = gp_LowerBoundVertices(theGraph); Result == OK && v < gp_UpperBoundVertices(theGraph); ++v)
+    {
+        if (dfiOfOriginal[gp_GetOriginalVertexIndex(theGraph, v)] != v)
+            Result = NOTOK;
+
+        e = gp_GetFirstEdge(theGraph, v);
+        while (Result == OK && gp_IsEdge(theGraph, e))
+        {
+            if (!gp_IsNeighbor(origGraph, gp_GetOriginalVertexIndex(theGraph, v),
+                               gp_GetOriginalVertexIndex(theGraph, gp_GetNeighbor(theGraph, e))))
+                Result = NOTOK;
+            e = gp_GetNextEdge(theGraph, e);
+        }
+    }
+
+    if (Result == OK && gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK)
+        Result = NOTOK;
+
+    gp_Free(&theGraph);
+
+    // The DFS of a path from its first vertex gives each vertex its own
+    // position as its DFI
+    if (Result == OK &&
+        ((theGraph = gp_New()) == NULL ||
+         gp_EnsureVertexCapacity(theGraph, N) != OK))
+        Result = NOTOK;
+
+    for (v = gp_LowerBoundVertices(theGraph); Result == OK && v < gp_UpperBoundVertices(theGraph) - 1; ++v)
+        if (gp_DynamicAddEdge(theGraph, v, 0, v + 1, 0) != OK)
+            Result = NOTOK;
+
+    if (Result == OK &&
+        (gp_WriteToString(theGraph, &beforeStr, WRITE_ADJLIST) != OK ||
+         gp_SortVertices(theGraph) != OK ||
+         !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI) ||
+         gp_GetOriginalVertexIndex(theGraph, gp_UpperBoundVertices(theGraph) - 1) != gp_UpperBoundVertices(theGraph) - 1 ||
+         gp_SortVertices(theGraph) != OK ||
+         (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_SORTEDBYDFI) ||
+         gp_WriteToString(theGraph, &afterStr, WRITE_ADJLIST) != OK ||
+         strcmp(beforeStr, afterStr) != 0))
+        Result = NOTOK;
+
+    if (beforeStr != NULL)
+        free(beforeStr);
+    if (afterStr != NULL)
+        free(afterStr);
+    if (dfiOfOriginal != NULL)
+        free(dfiOfOriginal);
+    gp_Free(&theGraph);
+    gp_Free(&origGraph);
+
+    return Result;
+}
+
+/****************************************************************************
+ runDeferredIsolationTests()
+ Embeds random maximal planar graphs, which are not outerplanar, others
+ with a few more edges, which are not planar, and random graphs with
+ deferred isolation, and tests that isolating the obstruction afterward gives
+ the same result as gp_Embed() without the modifier. Also tests that an
+ embeddable graph is embedded as usual.
+ ****************************************************************************/
+
+int runDeferredIsolationTests(void)
+{
+    graphP theGraph = NULL;
+    int N = 50, seed, Result = OK;
+
+    for (seed = 0; seed < 10 && Result == OK; seed++)
+    {
+        if ((theGraph = createRandomTestGraph(N, 3 * N - 6)) == NULL ||
+            runDeferredIsolationTest(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+            runDeferredIsolationTest(theGraph, EMBEDFLAGS_OUTERPLANAR) != NONEMBEDDABLE)
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+
+        if (Result == OK &&
+            ((theGraph = createRandomTestGraph(N, 3 * N - 6 + 1 + seed)) == NULL ||
+             runDeferredIsolationTest(theGraph, EMBEDFLAGS_PLANAR) != NONEMBEDDABLE))
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+
+        // Random graphs, which are sparser, give the other minor types
+        if (Result == OK &&
+            ((theGraph = createRandomTestGraph(N, 0)) == NULL ||
+             runDeferredIsolationTest(theGraph, EMBEDFLAGS_PLANAR) == NOTOK ||
+             runDeferredIsolationTest(theGraph, EMBEDFLAGS_OUTERPLANAR) == NOTOK))
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+    }
+
+    return Result;
+}
+
+/****************************************************************************
+ runDeferredIsolationTest()
+ Embeds copies of origGraph with and without deferred isolation, then tests
+ that both give the same result and the same resulting graph.
+ Returns the result of gp_Embed() if the test succeeds, or NOTOK otherwise.
+ ****************************************************************************/
+
+int runDeferredIsolationTest(graphP origGraph, unsigned embedFlags)
+{
+    graphP theGraph = NULL, deferGraph = NULL;
+    char *theStr = NULL, *deferStr = NULL;
+    int expectedResult = NOTOK, Result = OK;
+
+    if ((theGraph = gp_DupGraph(origGraph)) == NULL ||
+        (deferGraph = gp_DupGraph(origGraph)) == NULL ||
+        (expectedResult = gp_Embed(theGraph, embedFlags)) == NOTOK ||
+        gp_Embed(deferGraph, embedFlags | EMBEDFLAGS_DEFERISOLATION) != expectedResult)
+        Result = NOTOK;
+
+    // While the isolation is pending, there is no obstruction to check
+    if (Result == OK && expectedResult == NONEMBEDDABLE &&
+        (!(gp_GetEmbedFlags(deferGraph) & EMBEDFLAGS_DEFERISOLATION) ||
+         gp_GetObstructionMinorType(deferGraph) != MINORTYPE_NONE ||
+         gp_TestEmbedResultIntegrity(deferGraph, origGraph, NONEMBEDDABLE) != NONEMBEDDABLE ||
+         gp_IsolateObstruction(deferGraph) != NONEMBEDDABLE ||
+         gp_GetObstructionMinorType(deferGraph) != gp_GetObstructionMinorType(theGraph)))
+        Result = NOTOK;
+
+    // Afterward, no isolation is pending, whether or not there was one
+    if (Result == OK &&
+        (gp_GetEmbedFlags(deferGraph) != gp_GetEmbedFlags(theGraph) ||
+         gp_IsolateObstruction(deferGraph) != NOTOK ||
+         gp_TestEmbedResultIntegrity(deferGraph, origGraph, expectedResult) != expectedResult ||
+         gp_WriteToString(theGraph, &theStr, WRITE_ADJLIST) != OK ||
+         gp_WriteToString(deferGraph, &deferStr, WRITE_ADJLIST) != OK ||
+         strcmp(theStr, deferStr) != 0))
+        Result = NOTOK;
+
+    if (theStr != NULL)
+        free(theStr);
+    if (deferStr != NULL)
+        free(deferStr);
+    gp_Free(&theGraph);
+    gp_Free(&deferGraph);
+
+    return Result == OK ? expectedResult : NOTOK;
+}
+
+/****************************************************************************
+ runTryAddEdgeTests()
+ Embeds half of the edges of a random maximal planar graph, then tests that
+ gp_TryAddEdgeToEmbedding() adds the other edges one at a time, in the DFI
+ numbering of the embedding, and that gp_TryAddEdgesToEmbedding() adds them
+ as a batch, in the original numbering. In either case, an additional edge
+ must be rejected without changing the embedding. Also tests that edges are
+ not added to a graph in which gp_Embed() found an obstruction or made the
+ embedding for a homeomorph search, nor to an embedding whose edges have
+ changed, and that the DFS trees and DFIs still agree after edges join
+ vertices that had no edges.
+ ****************************************************************************/
+
+int runTryAddEdgeTests(void)
+{
+    graphP theGraph = NULL, halfGraph = NULL, origGraph = NULL;
+    int *uList = NULL, *vList = NULL, *dfiOfOriginal = NULL;
+    int N = 100, numEdges = 0, numHalf, a = NIL, b = NIL, e, i, v, Result = OK;
+
+    if ((origGraph = createRandomTestGraph(N, 3 * N - 6)) == NULL ||
+        (halfGraph = gp_New()) == NULL ||
+        gp_EnsureVertexCapacity(halfGraph, N) != OK ||
+        (uList = (int *)malloc((gp_GetM(origGraph) + 1) * sizeof(int))) == NULL ||
+        (vList = (int *)malloc((gp_GetM(origGraph) + 1) * sizeof(int))) == NULL)
+        Result = NOTOK;
+
+    // Get the edges, and a pair of vertices that is not an edge
+    for (e = gp_LowerBoundEdges(origGraph); Result == OK && e < gp_UpperBoundEdges(origGraph); e += 2)
+    {
+        if (gp_EdgeInUse(origGraph, e))
+        {
+            uList[numEdges] = gp_GetNeighbor(origGraph, gp_GetTwin(origGraph, e));
+            vList[numEdges] = gp_GetNeighbor(origGraph, e);
+            numEdges++;
+        }
+    }
+
+    for (i = gp_LowerBoundVertices(origGraph); Result == OK && gp_IsNotVertex(origGraph, a) && i < gp_UpperBoundVertices(origGraph); ++i)
+    {
+        for (e = i + 1; gp_IsNotVertex(origGraph, a) && e < gp_UpperBoundVertices(origGraph); ++e)
+        {
+            if (!gp_IsNeighbor(origGraph, i, e))
+            {
+                a = i;
+                b = e;
+            }
+        }
+    }
+
+    numHalf = numEdges / 2;
+    for (i = 0; Result == OK && i < numHalf; i++)
+    {
+        if (gp_AddEdge(halfGraph, uList[i], 0, vList[i], 0) != OK)
+            Result = NOTOK;
+    }
+
+    // Add the edges one at a time to the embedding of the first half
+    if (Result == OK &&
+        ((theGraph = gp_DupGraph(halfGraph)) == NULL ||
+         gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+         (dfiOfOriginal = (int *)malloc(gp_UpperBoundVertices(theGraph) * sizeof(int))) == NULL ||
+         gp_GetDFIOfOriginal(theGraph, dfiOfOriginal) != OK))
+        Result = NOTOK;
+
+    // An edge added by embedding the graph again gives it new DFIs
+    for (i = numHalf; Result == OK && i < numEdges; i++)
+    {
+        if (gp_TryAddEdgeToEmbedding(theGraph, dfiOfOriginal[uList[i]], dfiOfOriginal[vList[i]]) != OK ||
+            gp_GetDFIOfOriginal(theGraph, dfiOfOriginal) != OK)
+            Result = NOTOK;
+    }
+
+    if (Result == OK &&
+        (gp_CountEmbeddingFaces(theGraph) != 2 * N - 4 ||
+         gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK ||
+         gp_IsNotVertex(origGraph, a) ||
+         gp_TryAddEdgeToEmbedding(theGraph, dfiOfOriginal[a], dfiOfOriginal[b]) != NONEMBEDDABLE ||
+         gp_TryAddEdgeToEmbedding(theGraph, dfiOfOriginal[a], dfiOfOriginal[a]) != NOTOK ||
+         gp_TryAddEdgeToEmbedding(theGraph, dfiOfOriginal[uList[0]], dfiOfOriginal[vList[0]]) != NOTOK ||
+         gp_GetM(theGraph) != numEdges ||
+         gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK))
+        Result = NOTOK;
+
+    gp_Free(&theGraph);
+
+    // Add the edges as a batch, with and without the additional edge, to the
+    // embedding of the first half after it is put in the original numbering
+    if (Result == OK)
+    {
+        uList[numEdges] = a;
+        vList[numEdges] = b;
+
+        if ((theGraph = gp_DupGraph(halfGraph)) == NULL ||
+            gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+            gp_SortVertices(theGraph) != OK ||
+            gp_TryAddEdgesToEmbedding(theGraph, uList + numHalf, vList + numHalf, numEdges - numHalf + 1) != NONEMBEDDABLE ||
+            gp_GetM(theGraph) != numHalf ||
+            gp_TestEmbedResultIntegrity(theGraph, halfGraph, OK) != OK ||
+            gp_TryAddEdgesToEmbedding(theGraph, uList + numHalf, vList + numHalf, numEdges - numHalf) != OK ||
+            gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK)
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+    }
+
+    // No edge is added to a graph that contains an obstruction rather than
+    // an embedding, even though its embedFlags are EMBEDFLAGS_PLANAR
+    if (Result == OK)
+    {
+        if ((theGraph = gp_DupGraph(origGraph)) == NULL ||
+            gp_AddEdge(theGraph, a, 0, b, 0) != OK ||
+            gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != NONEMBEDDABLE)
+            Result = NOTOK;
+
+        if (Result == OK && theGraph != NULL)
+        {
+            v = gp_LowerBoundVertices(theGraph) + 1;
+            while (v < gp_UpperBoundVertices(theGraph) &&
+                   gp_IsNeighbor(theGraph, gp_LowerBoundVertices(theGraph), v))
+                ++v;
+
+            if (v == gp_UpperBoundVertices(theGraph) ||
+                gp_TryAddEdgeToEmbedding(theGraph, gp_LowerBoundVertices(theGraph), v) != NOTOK)
+                Result = NOTOK;
+        }
+
+        gp_Free(&theGraph);
+    }
+
+    // Nor is an edge added to the planar embedding made by a K_{3,3} search,
+    // nor to an embedding after an edge of it was added or deleted, even if
+    // the embedding was restored by deleting the added edge again
+    if (Result == OK)
+    {
+        if ((theGraph = gp_DupGraph(halfGraph)) == NULL ||
+            gp_ExtendWith_K33Search(theGraph) != OK ||
+            gp_Embed(theGraph, EMBEDFLAGS_SEARCHFORK33) != OK ||
+            (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_EMBEDDED) ||
+            gp_SortVertices(theGraph) != OK ||
+            gp_TryAddEdgeToEmbedding(theGraph, uList[numHalf], vList[numHalf]) != NOTOK)
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+
+        if (Result == OK &&
+            ((theGraph = gp_DupGraph(halfGraph)) == NULL ||
+             gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+             !(gp_GetGraphFlags(theGraph) & GRAPHFLAGS_EMBEDDED) ||
+             gp_SortVertices(theGraph) != OK ||
+             gp_AddEdge(theGraph, uList[numHalf], 0, vList[numHalf], 0) != OK ||
+             (gp_GetGraphFlags(theGraph) & GRAPHFLAGS_EMBEDDED) ||
+             gp_DeleteEdge(theGraph, gp_FindEdge(theGraph, uList[numHalf], vList[numHalf])) != OK ||
+             gp_TryAddEdgeToEmbedding(theGraph, uList[numHalf], vList[numHalf]) != NOTOK))
+            Result = NOTOK;
+
+        gp_Free(&theGraph);
+    }
+
+    // Edges that join vertices without edges to the DFS tree of a path must
+    // leave each DFS parent with a lower DFI than its child, in DFI order and
+    // then in the original order, with the original numbering kept
+    if (Result == OK)
+    {
+        int lower;
+
+        gp_Free(&halfGraph);
+        gp_Free(&origGraph);
+
+        if ((halfGraph = gp_New()) == NULL ||
+            gp_EnsureVertexCapacity(halfGraph, 4) != OK ||
+            (origGraph = gp_New()) == NULL ||
+            gp_EnsureVertexCapacity(origGraph, 4) != OK)
+            Result = NOTOK;
+
+        lower = Result == OK ? gp_LowerBoundVertices(halfGraph) : NIL;
+
+        if (Result == OK &&
+            (gp_AddEdge(halfGraph, lower + 2, 0, lower + 3, 0) != OK ||
+             gp_AddEdge(origGraph, lower + 2, 0, lower + 3, 0) != OK ||
+             gp_AddEdge(origGraph, lower, 0, lower + 3, 0) != OK ||
+             gp_AddEdge(origGraph, lower + 1, 0, lower + 3, 0) != OK ||
+             (theGraph = gp_DupGraph(halfGraph)) == NULL ||
+             gp_Embed(theGraph, EMBEDFLAGS_PLANAR) != OK ||
+             gp_GetDFIOfOriginal(theGraph, dfiOfOriginal) != OK ||
+             gp_TryAddEdgeToEmbedding(theGraph, dfiOfOriginal[lower], dfiOfOriginal[lower + 3]) != OK))
+            Result = NOTOK;
+
+        for (v = lower; Result == OK && v < gp_UpperBoundVertices(theGraph); ++v)
+        {
+            if (gp_IsNotDFSTreeRoot(theGraph, v) && gp_GetParent(theGraph, v) > v)
+                Result = NOTOK;
+        }
+
+        if (Result == OK &&
+            (gp_SortVertices(theGraph) != OK ||
+             gp_TryAddEdgeToEmbedding(theGraph, lower + 1, lower + 3) != OK))
+            Result = NOTOK;
+
+        for (v = lower; Result == OK && v < gp_UpperBoundVertices(theGraph); ++v)
+        {
+            if (gp_IsNotDFSTreeRoot(theGraph, v) &&
+                gp_GetIndex(theGraph, gp_GetParent(theGraph, v)) > gp_GetIndex(theGraph, v))
+                Result = NOTOK;
+        }
+
+        if (Result == OK &&
+            (gp_CountEmbeddingFaces(theGraph) != 1 ||
+             gp_TestEmbedResultIntegrity(theGraph, origGraph, OK) != OK))
+            Result = NOTOK;
+    }
+
+    if (uList != NULL)
+        free(uList);
+    if (vList != NULL)
+        free(vList);
+    if (dfiOfOriginal != NULL)
+        free(dfiOfOriginal);
+    gp_Free(&theGraph);
+    gp_Free(&halfGraph);
+    gp_Free(&origGraph);
+
+    return Result;
+}
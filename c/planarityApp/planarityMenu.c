@@ -143,13 +143,13 @@ int menu(void)
                         Result = SpecificGraph(commandString, NULL, NULL, secondOutfile, NULL, NULL, NULL);
                         break;
                     case 'r':
-                        Result = RandomGraphs(commandString, 0, 0, NULL, FALSE, FALSE);
+                        Result = RandomGraphs(commandString, 0, 0, NULL, 1, NULL, FALSE, FALSE);
                         break;
                     case 'm':
-                        Result = RandomGraph(commandString, 0, 0, NULL, NULL);
+                        Result = RandomGraph(commandString, 0, 0, NULL, NULL, NULL);
                         break;
                     case 'n':
-                        Result = RandomGraph(commandString, 1, 0, NULL, NULL);
+                        Result = RandomGraph(commandString, 1, 0, NULL, NULL, NULL);
                         break;
                     default:
                         break;
@@ -474,7 +474,7 @@ int TestAllGraphsMenu(void)
     }
 
     if (Result == OK)
-        Result = TestAllGraphs(commandString, infileName, outfileName, NULL);
+        Result = TestAllGraphs(commandString, infileName, 1, 0, 0, outfileName, NULL);
 
     if (commandStringFormat != NULL)
     {
@@ -6,6 +6,49 @@ See the LICENSE.TXT file for licensing information.
 
 #include "planarity.h"
 
+#define NUM_MINORS 9
+
+typedef struct
+{
+    char command;
+    int embedFlags;
+    int forceQuiet;
+    int useExGenerator;
+    unsigned long long seed;
+    int firstK, endK;
+    int countUpdateFreq;
+    graphP theGraph, origGraph;
+    G6WriteIteratorP theG6WriteIterator;
+    int K;
+    int MainStatistic;
+    int ObstructionMinorFreqs[NUM_MINORS];
+    embedPrefilterStatsStruct prefilterStats;
+    int Result;
+} randomGraphsWorkerStruct;
+
+typedef randomGraphsWorkerStruct *randomGraphsWorkerP;
+
+int randomGraphsInRange(randomGraphsWorkerP theWorker);
+
+#ifdef PLATFORM_THREADS_AVAILABLE
+
+#include "../graphLib/io/strOrFile.h"
+
+typedef struct
+{
+    randomGraphsWorkerStruct work;
+    unsigned quietMode;
+    int writeG6;
+    char *g6OutputStr;
+} randomGraphsThreadStruct;
+
+typedef randomGraphsThreadStruct *randomGraphsThreadP;
+
+int randomGraphsInParallel(randomGraphsWorkerP theMerge, int NumGraphs, int SizeOfGraphs, char *outfileName, int numThreads);
+platform_ThreadFunction(randomGraphsWorker, arg);
+
+#endif
+
 int GetNumberIfZero(int *pNum, char const *prompt, int min, int max);
 void ResetGraphStorage(graphP *pGraph, int ReuseGraphs, char command);
 graphP MakeGraph(int Size, char command);
@@ -19,25 +62,33 @@ int PromptSaveGraph(graphP theGraph, graphP origGraph, int extraEdges, int saveM
  * The number of graphs to generate, and the number of vertices for each graph,
  * can be sent as the second and third params.  For each that is sent as zero,
  * this method will prompt the user for a value.
+ *
+ * Graph number K (counting from 0) is generated from its own random number
+ * generator seeded with seed+K, where seed is *pSeed or, if pSeed is NULL, the
+ * current time. So, any one graph of a run can be regenerated directly by
+ * generating 1 graph with seed+K as the seed.
+ *
+ * If numThreads is greater than 1, then the graphs are divided among that many
+ * worker threads, if possible. Since each graph has its own seed, the graphs
+ * and the results are the same as for a single thread.
  ****************************************************************************/
 
-#define NUM_MINORS 9
-
-int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraphs, char *outfileName, int forceQuiet, int useExGenerator)
+int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraphs, unsigned long long const *pSeed, int numThreads, char *outfileName, int forceQuiet, int useExGenerator)
 {
     int savedQuietModeSetting = gp_GetQuietMode();
     int Result = OK;
     int writeResult = OK;
 
-    int K = 0, countUpdateFreq = 0, embedFlags = 0, MainStatistic = 0;
-    int ReuseGraphs = TRUE;
+    int K = 0, countUpdateFreq = 0, embedFlags = 0;
 
     char command = '\0', modifier = '\0';
 
-    int ObstructionMinorFreqs[NUM_MINORS];
+    randomGraphsWorkerStruct theWorker;
 
     graphP theGraph = NULL, origGraph = NULL;
 
+    unsigned long long seed = 0;
+
     platform_time start, end;
 
     G6WriteIteratorP theG6WriteIterator = NULL;
@@ -47,7 +98,7 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
 
     char theFileName[FILENAMEMAXLENGTH + 1];
 
-    memset(ObstructionMinorFreqs, 0, NUM_MINORS * sizeof(int));
+    memset(&theWorker, 0, sizeof(randomGraphsWorkerStruct));
     memset(theFileName, '\0', (FILENAMEMAXLENGTH + 1));
 
     if (forceQuiet)
@@ -85,6 +136,12 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
         return NOTOK;
     }
 
+    // The per-graph output files of the menu configuration are named by graph
+    // number modulo 10, so they can only be produced by a single thread
+    if (tolower(OrigOut) == 'y' || tolower(EmbeddableOut) == 'y' ||
+        tolower(ObstructedOut) == 'y' || tolower(AdjListsForEmbeddingsOut) == 'y')
+        numThreads = 1;
+
     theGraph = MakeGraph(SizeOfGraphs, command);
     // The origGraph no longer needs extensions, so we just use a null terminator for the command
     origGraph = MakeGraph(SizeOfGraphs, '\0');
@@ -98,7 +155,8 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
         return NOTOK;
     }
 
-    if (outfileName != NULL || (tolower(OrigOut) == 'y' && tolower(OrigOutFormat) == 'g'))
+    if (numThreads <= 1 &&
+        (outfileName != NULL || (tolower(OrigOut) == 'y' && tolower(OrigOutFormat) == 'g')))
     {
         if (g6_NewWriter((&theG6WriteIterator), theGraph) != OK)
         {
@@ -110,7 +168,7 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
         }
     }
 
-    if (outfileName != NULL && !forceQuiet)
+    if (theG6WriteIterator != NULL && outfileName != NULL && !forceQuiet)
     {
         if (g6_InitWriterWithFileName(theG6WriteIterator, outfileName) != OK)
         {
@@ -122,7 +180,7 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
             return NOTOK;
         }
     }
-    else if (tolower(OrigOut) == 'y' && tolower(OrigOutFormat) == 'g' && !forceQuiet)
+    else if (theG6WriteIterator != NULL && tolower(OrigOut) == 'y' && tolower(OrigOutFormat) == 'g' && !forceQuiet)
     {
         // If outfileName is NULL, then the only case in which we would want to
         // output the generated random graphs to .g6 is if we Reconfigure() and
@@ -140,10 +198,16 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
         }
     }
 
-    // Seed the random number generator with "now". Do it after any prompting
-    // to tie randomness to human process of answering the prompt.
-    // Acceptable downcast of time_t to unsigned int (seeding benefits from the lower bits of now)
-    srand((unsigned int)time(NULL));
+    // Unless a seed was given, seed the random number generation with "now".
+    // Do it after any prompting to tie randomness to human process of answering
+    // the prompt. The seed is reported so that the run can be reproduced.
+    if (pSeed != NULL)
+        seed = *pSeed;
+    else
+    {
+        seed = (unsigned long long)time(NULL);
+        gp_Message("Random seed = %llu", seed);
+    }
 
     // Select a counter update frequency that updates more frequently with larger graphs
     // and which is relatively prime with 10 so that all digits of the count will change
@@ -153,6 +217,18 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
     countUpdateFreq = countUpdateFreq % 2 == 0 ? countUpdateFreq + 1 : countUpdateFreq;
     countUpdateFreq = countUpdateFreq % 5 == 0 ? countUpdateFreq + 2 : countUpdateFreq;
 
+    theWorker.command = command;
+    theWorker.embedFlags = embedFlags;
+    theWorker.forceQuiet = forceQuiet;
+    theWorker.useExGenerator = useExGenerator;
+    theWorker.seed = seed;
+    theWorker.firstK = 0;
+    theWorker.endK = NumGraphs;
+    theWorker.countUpdateFreq = countUpdateFreq;
+    theWorker.theGraph = theGraph;
+    theWorker.origGraph = origGraph;
+    theWorker.theG6WriteIterator = theG6WriteIterator;
+
     // Start the count
     if (!(gp_GetQuietMode() & QUIETMODE_MESSAGES))
     {
@@ -163,21 +239,176 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
     // Start the timer
     platform_GetTime(start);
 
-    // useExGenerator = TRUE;
-
     // Generate and process the number of graphs requested
-    for (K = 0; K < NumGraphs; K++)
+#ifdef PLATFORM_THREADS_AVAILABLE
+    if (numThreads > 1)
+        randomGraphsInParallel(&theWorker, NumGraphs, SizeOfGraphs,
+                               forceQuiet ? NULL : outfileName, numThreads);
+    else
+#endif
+        randomGraphsInRange(&theWorker);
+
+    // The worker may have recreated the graph it was given
+    theGraph = theWorker.theGraph;
+    Result = theWorker.Result;
+    K = theWorker.K;
+
+    // Stop the timer
+    platform_GetTime(end);
+
+    // Finish the count
+    if (!(gp_GetQuietMode() & QUIETMODE_MESSAGES))
     {
-        if (useExGenerator)
-            Result = gp_CreateRandomGraphEx(theGraph, gp_GetRandomNumber(gp_GetN(theGraph), gp_GetEdgeCapacity(theGraph)));
+        fprintf(stdout, "%d\n", NumGraphs);
+        fflush(stdout);
+    }
+
+    gp_Message("Done (%.3lf seconds).", platform_GetDuration(start, end));
+
+    // Print some demographic results
+    if (Result == OK || Result == NONEMBEDDABLE)
+    {
+        // A test-only result leaves neither an embedding nor an obstruction
+        // whose integrity could be checked, so it is not reported as verified
+        if (embedFlags & EMBEDFLAGS_TESTONLY)
+            gp_Message("No errors occurred, but test-only results are not verified.");
         else
-            Result = gp_CreateRandomGraph(theGraph);
+            gp_Message("No Errors Found.");
+
+        // Report statistics for planarity or outerplanarity testing only
+        if (embedFlags & EMBEDFLAGS_TESTONLY)
+        {
+            gp_Message("Num Embeddable=%d.", theWorker.MainStatistic);
+            WriteEmbedPrefilterStats(&theWorker.prefilterStats);
+        }
+
+        // Report statistics for planar or outerplanar embedding
+        else if (embedFlags == EMBEDFLAGS_PLANAR || embedFlags == EMBEDFLAGS_OUTERPLANAR)
+        {
+            gp_Message("Num Embedded=%d.", theWorker.MainStatistic);
+
+            for (K = 0; K < 5; K++)
+            {
+                // Outerplanarity does not produces minors C and D
+                if (embedFlags == EMBEDFLAGS_OUTERPLANAR && (K == 2 || K == 3))
+                    continue;
+
+                gp_Message("Minor %c = %d", K + 'A', theWorker.ObstructionMinorFreqs[K]);
+            }
+
+            if (!(embedFlags & ~EMBEDFLAGS_PLANAR))
+            {
+                gp_Message("\nNote: E1 are added to C, E2 are added to A, and "
+                           "E=E3+E4+K5 homeomorphs.\n");
+
+                for (K = 5; K < NUM_MINORS; K++)
+                {
+                    gp_Message("Minor E%d = %d",
+                               K - 4, theWorker.ObstructionMinorFreqs[K]);
+                }
+            }
+        }
+
+        // Report statistics for graph drawing
+        else if (embedFlags == EMBEDFLAGS_DRAWPLANAR)
+        {
+            gp_Message("Num Graphs Embedded and Drawn=%d.", theWorker.MainStatistic);
+        }
+
+        // Report statistics for subgraph homeomorphism algorithms
+        else if (embedFlags == EMBEDFLAGS_SEARCHFORK23)
+        {
+            gp_Message("Of the generated graphs, %d did not contain a K_{2,3} "
+                       "homeomorph as a subgraph.",
+                       theWorker.MainStatistic);
+        }
+        else if (embedFlags == EMBEDFLAGS_SEARCHFORK33)
+        {
+            gp_Message("Of the generated graphs, %d did not contain a K_{3,3} "
+                       "homeomorph as a subgraph.",
+                       theWorker.MainStatistic);
+        }
+        else if (embedFlags == EMBEDFLAGS_SEARCHFORK4)
+        {
+            gp_Message("Of the generated graphs, %d did not contain a K_4 "
+                       "homeomorph as a subgraph.",
+                       theWorker.MainStatistic);
+        }
+    }
+    else
+    {
+        gp_ErrorMessage("\nError found.");
+        gp_ErrorMessage("Graph number %d can be regenerated as the only graph "
+                        "of a run with seed %llu.",
+                        K, seed + (unsigned long long)K);
+        g6_SetOutputErrorFlag(theG6WriteIterator);
+        Result = NOTOK;
+        if (!forceQuiet)
+        {
+            sprintf(theFileName, "error%c%d.txt", FILE_DELIMITER, K % 10);
+            if ((writeResult = gp_Write(origGraph, theFileName, WRITE_ADJLIST)) != OK)
+                gp_ErrorMessage(writeErrorMessage, FILENAME_MAX, theFileName);
+        }
+    }
+
+    FlushConsole(stdout);
+
+    g6_FreeWriter((&theG6WriteIterator));
+
+    // Free the graph structures created before the loop
+    gp_Free(&theGraph);
+    gp_Free(&origGraph);
+
+    gp_SetQuietMode(savedQuietModeSetting);
+
+    return Result == OK || Result == NONEMBEDDABLE ? OK : NOTOK;
+}
+
+/****************************************************************************
+ randomGraphsInRange()
+ Generates and processes the graphs numbered from theWorker->firstK up to but
+ not including theWorker->endK, accumulating the statistics in theWorker.
+ Each graph K is generated with a generator seeded with theWorker->seed + K.
+
+ Processing stops on the first error, in which case theWorker->K is the number
+ of the graph on which the error occurred and theWorker->origGraph contains
+ that graph. Progress is shown only if theWorker->countUpdateFreq > 0.
+ Returns and stores in theWorker->Result the result for the last graph.
+ ****************************************************************************/
+
+int randomGraphsInRange(randomGraphsWorkerP theWorker)
+{
+    int Result = OK;
+    int writeResult = OK;
+    int K = 0;
+    int ReuseGraphs = TRUE;
+
+    randomGeneratorStruct theGenerator;
+    embedPrefilterStatsStruct prefilterStats;
+
+    char const writeErrorMessage[] = "Failed to write graph \"%.*s\".\nMake the directory if not present.";
+
+    char theFileName[FILENAMEMAXLENGTH + 1];
+
+    memset(theFileName, '\0', (FILENAMEMAXLENGTH + 1));
+
+    gp_ClearEmbedPrefilterStats();
+
+    for (K = theWorker->firstK; K < theWorker->endK; K++)
+    {
+        gp_SeedRandomGenerator(&theGenerator, theWorker->seed + (unsigned long long)K);
+        gp_SetRandomGenerator(theWorker->theGraph, &theGenerator);
+
+        if (theWorker->useExGenerator)
+            Result = gp_CreateRandomGraphEx(theWorker->theGraph, gp_GetRandomNumberFromGenerator(&theGenerator, gp_GetN(theWorker->theGraph), gp_GetEdgeCapacity(theWorker->theGraph)));
+        else
+            Result = gp_CreateRandomGraph(theWorker->theGraph);
 
         if (Result == OK)
         {
-            if (theG6WriteIterator != NULL && !forceQuiet)
+            if (theWorker->theG6WriteIterator != NULL && !theWorker->forceQuiet)
             {
-                if ((writeResult = g6_WriteGraph(theG6WriteIterator)) != OK)
+                if ((writeResult = g6_WriteGraph(theWorker->theG6WriteIterator)) != OK)
                 {
                     gp_ErrorMessage("Unable to write graph number %d using "
                                     "G6WriteIterator.",
@@ -186,10 +417,10 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
                     break;
                 }
             }
-            else if (tolower(OrigOut) == 'y' && tolower(OrigOutFormat) == 'a' && !forceQuiet)
+            else if (tolower(OrigOut) == 'y' && tolower(OrigOutFormat) == 'a' && !theWorker->forceQuiet)
             {
                 sprintf(theFileName, "random%c%d.txt", FILE_DELIMITER, K % 10);
-                if ((writeResult = gp_Write(theGraph, theFileName, WRITE_ADJLIST)) != OK)
+                if ((writeResult = gp_Write(theWorker->theGraph, theFileName, WRITE_ADJLIST)) != OK)
                 {
                     gp_ErrorMessage(writeErrorMessage,
                                     FILENAME_MAX, theFileName);
@@ -205,7 +436,7 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
             //     break;
             // }
 
-            if ((Result = gp_CopyGraph(origGraph, theGraph)) != OK)
+            if ((Result = gp_CopyGraphInUse(theWorker->origGraph, theWorker->theGraph)) != OK)
             {
                 gp_ErrorMessage("Unable to make a copy of graph number %d "
                                 "before embedding.",
@@ -213,32 +444,32 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
                 break;
             }
 
-            if ((Result = gp_DepthFirstSearch(theGraph)) != OK)
+            if ((Result = gp_DepthFirstSearch(theWorker->theGraph)) != OK)
             {
                 gp_ErrorMessage("Unable to depth first search graph number %d before embedding.", K);
                 break;
             }
 
-            if ((Result = gp_SortVertices(theGraph)) != OK)
+            if ((Result = gp_SortVertices(theWorker->theGraph)) != OK)
             {
                 gp_ErrorMessage("Unable to sort graph number %d before embedding.", K);
                 break;
             }
 
-            if ((Result = gp_ComputeLowpoints(theGraph)) != OK)
+            if ((Result = gp_ComputeLowpoints(theWorker->theGraph)) != OK)
             {
                 gp_ErrorMessage("Unable to compute lowpoints for graph number %d before embedding.", K);
                 break;
             }
 
-            Result = gp_Embed(theGraph, embedFlags);
+            Result = gp_Embed(theWorker->theGraph, theWorker->embedFlags);
             if (Result != OK && Result != NONEMBEDDABLE)
             {
                 gp_ErrorMessage("Embed operation failed on graph number %d.", K);
                 break;
             }
 
-            if (gp_TestEmbedResultIntegrity(theGraph, origGraph, Result) != Result)
+            if (gp_TestEmbedResultIntegrity(theWorker->theGraph, theWorker->origGraph, Result) != Result)
             {
                 gp_ErrorMessage("Embed integrity check failed on graph number %d.", K);
                 Result = NOTOK;
@@ -246,12 +477,12 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
             }
             else
             {
-                if (useExGenerator && embedFlags == EMBEDFLAGS_PLANAR)
+                if (theWorker->useExGenerator && (theWorker->embedFlags & ~EMBEDFLAGS_TESTONLY) == EMBEDFLAGS_PLANAR)
                 {
                     // The Ex random graph generator is supposed to generate a planar graph
                     // if the number of edges is <= 3N-6, so it is an error to have a
                     // NONEMBEDDABLE result here.
-                    if (gp_GetM(origGraph) <= 3 * gp_GetN(origGraph) - 6)
+                    if (gp_GetM(theWorker->origGraph) <= 3 * gp_GetN(theWorker->origGraph) - 6)
                     {
                         if (Result == NONEMBEDDABLE)
                         {
@@ -265,13 +496,14 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
 
             if (Result == OK)
             {
-                MainStatistic++;
+                theWorker->MainStatistic++;
 
-                if (tolower(EmbeddableOut) == 'y' && !forceQuiet)
+                // In test-only mode, there is no embedding to write
+                if (tolower(EmbeddableOut) == 'y' && !theWorker->forceQuiet && !(theWorker->embedFlags & EMBEDFLAGS_TESTONLY))
                 {
                     sprintf(theFileName, "embedded%c%d.txt", FILE_DELIMITER, K % 10);
 
-                    if ((writeResult = gp_Write(theGraph, theFileName, WRITE_ADJMATRIX)) != OK)
+                    if ((writeResult = gp_Write(theWorker->theGraph, theFileName, WRITE_ADJMATRIX)) != OK)
                     {
                         gp_ErrorMessage(writeErrorMessage,
                                         FILENAME_MAX, theFileName);
@@ -280,11 +512,11 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
                     }
                 }
 
-                if (tolower(AdjListsForEmbeddingsOut) == 'y' && !forceQuiet)
+                if (tolower(AdjListsForEmbeddingsOut) == 'y' && !theWorker->forceQuiet && !(theWorker->embedFlags & EMBEDFLAGS_TESTONLY))
                 {
                     sprintf(theFileName, "adjlist%c%d.txt", FILE_DELIMITER, K % 10);
 
-                    if ((writeResult = gp_Write(theGraph, theFileName, WRITE_ADJLIST)) != OK)
+                    if ((writeResult = gp_Write(theWorker->theGraph, theFileName, WRITE_ADJLIST)) != OK)
                     {
                         gp_ErrorMessage(writeErrorMessage,
                                         FILENAME_MAX, theFileName);
@@ -295,33 +527,33 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
             }
             else if (Result == NONEMBEDDABLE)
             {
-                if (embedFlags == EMBEDFLAGS_PLANAR || embedFlags == EMBEDFLAGS_OUTERPLANAR)
+                if (theWorker->embedFlags == EMBEDFLAGS_PLANAR || theWorker->embedFlags == EMBEDFLAGS_OUTERPLANAR)
                 {
-                    if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_A)
-                        ObstructionMinorFreqs[0]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_B)
-                        ObstructionMinorFreqs[1]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_C)
-                        ObstructionMinorFreqs[2]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_D)
-                        ObstructionMinorFreqs[3]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_E)
-                        ObstructionMinorFreqs[4]++;
-
-                    if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_E1)
-                        ObstructionMinorFreqs[5]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_E2)
-                        ObstructionMinorFreqs[6]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_E3)
-                        ObstructionMinorFreqs[7]++;
-                    else if (gp_GetObstructionMinorType(theGraph) & MINORTYPE_E4)
-                        ObstructionMinorFreqs[8]++;
-
-                    if (tolower(ObstructedOut) == 'y' && !forceQuiet)
+                    if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_A)
+                        theWorker->ObstructionMinorFreqs[0]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_B)
+                        theWorker->ObstructionMinorFreqs[1]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_C)
+                        theWorker->ObstructionMinorFreqs[2]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_D)
+                        theWorker->ObstructionMinorFreqs[3]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_E)
+                        theWorker->ObstructionMinorFreqs[4]++;
+
+                    if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_E1)
+                        theWorker->ObstructionMinorFreqs[5]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_E2)
+                        theWorker->ObstructionMinorFreqs[6]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_E3)
+                        theWorker->ObstructionMinorFreqs[7]++;
+                    else if (gp_GetObstructionMinorType(theWorker->theGraph) & MINORTYPE_E4)
+                        theWorker->ObstructionMinorFreqs[8]++;
+
+                    if (tolower(ObstructedOut) == 'y' && !theWorker->forceQuiet)
                     {
                         sprintf(theFileName, "obstructed%c%d.txt", FILE_DELIMITER, K % 10);
 
-                        if ((writeResult = gp_Write(theGraph, theFileName, WRITE_ADJMATRIX)) != OK)
+                        if ((writeResult = gp_Write(theWorker->theGraph, theFileName, WRITE_ADJMATRIX)) != OK)
                         {
                             gp_ErrorMessage(writeErrorMessage,
                                             FILENAME_MAX, theFileName);
@@ -334,12 +566,12 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
         }
 
         // Reset (or recreate) graph for next iteration
-        ResetGraphStorage(&theGraph, ReuseGraphs, command);
+        ResetGraphStorage(&theWorker->theGraph, ReuseGraphs, theWorker->command);
 
         // Show progress, but not so often that it bogs down progress
-        if (!(gp_GetQuietMode() & QUIETMODE_MESSAGES))
+        if (!(gp_GetQuietMode() & QUIETMODE_MESSAGES) && theWorker->countUpdateFreq > 0)
         {
-            if ((K + 1) % countUpdateFreq == 0)
+            if ((K + 1) % theWorker->countUpdateFreq == 0)
             {
                 fprintf(stdout, "%d\r", K + 1);
                 fflush(stdout);
@@ -347,101 +579,279 @@ int RandomGraphs(char const *const commandString, int NumGraphs, int SizeOfGraph
         }
     }
 
-    // Stop the timer
-    platform_GetTime(end);
+    gp_GetEmbedPrefilterStats(&prefilterStats);
+    AddEmbedPrefilterStats(&theWorker->prefilterStats, &prefilterStats);
 
-    // Finish the count
-    if (!(gp_GetQuietMode() & QUIETMODE_MESSAGES))
+    theWorker->K = K;
+    theWorker->Result = Result;
+
+    return Result;
+}
+
+#ifdef PLATFORM_THREADS_AVAILABLE
+
+/****************************************************************************
+ randomGraphsInParallel()
+ Divides the graphs numbered 0 to NumGraphs-1 among numThreads worker threads,
+ each of which has its own pair of graphs and runs randomGraphsInRange() on
+ its share. Then, the worker statistics are merged into theMerge, which must
+ be set up as for randomGraphsInRange() on the whole range.
+
+ The work is done in rounds so that the count can be updated and so that the
+ .g6 output of each worker can be held in memory until it is appended, in
+ graph number order, to the outfileName (if non-NULL). Within a round, each
+ worker generates a contiguous run of graphs, so the merge is the same as if
+ one thread had done the round: if a worker stops on an error, then the stats
+ of the workers for later graphs are not included, and theMerge->K and
+ theMerge->origGraph identify the graph on which the error occurred.
+ ****************************************************************************/
+
+// The round size is chosen to keep the .g6 output held in memory per worker
+// to about this many characters
+#define RANDOMGRAPHS_ROUNDOUTPUTSIZE (4 * 1024 * 1024)
+#define RANDOMGRAPHS_MAXGRAPHSPERROUND 1000
+
+int randomGraphsInParallel(randomGraphsWorkerP theMerge, int NumGraphs, int SizeOfGraphs, char *outfileName, int numThreads)
+{
+    int Result = OK;
+    int graphsPerRound = 0, roundStart = 0, numStarted = 0, numWorkers = 0;
+    size_t graphSize = 0;
+    randomGraphsThreadP workers = NULL;
+    platform_thread *threads = NULL;
+    int *threadStarted = NULL;
+    strOrFileP outputContainer = NULL;
+    char const *g6Header = ">>graph6<<";
+
+    if (numThreads > NumGraphs)
+        numThreads = NumGraphs;
+
+    // The g6 encoding of a graph uses about one character per 6 vertex pairs
+    graphSize = ((size_t)SizeOfGraphs * (size_t)(SizeOfGraphs - 1)) / 12 + 8;
+    graphsPerRound = RANDOMGRAPHS_MAXGRAPHSPERROUND;
+    if (outfileName != NULL && graphSize * (size_t)graphsPerRound > RANDOMGRAPHS_ROUNDOUTPUTSIZE)
+        graphsPerRound = (int)(RANDOMGRAPHS_ROUNDOUTPUTSIZE / graphSize) + 1;
+
+    workers = (randomGraphsThreadP)calloc(numThreads, sizeof(randomGraphsThreadStruct));
+    threads = (platform_thread *)calloc(numThreads, sizeof(platform_thread));
+    threadStarted = (int *)calloc(numThreads, sizeof(int));
+    if (workers == NULL || threads == NULL || threadStarted == NULL)
     {
-        fprintf(stdout, "%d\n", NumGraphs);
-        fflush(stdout);
+        gp_ErrorMessage("Unable to allocate memory for worker threads.");
+        Result = NOTOK;
+        goto Label_Cleanup;
     }
 
-    gp_Message("Done (%.3lf seconds).", platform_GetDuration(start, end));
-
-    // Print some demographic results
-    if (Result == OK || Result == NONEMBEDDABLE)
+    if (outfileName != NULL)
     {
-        gp_Message("No Errors Found.");
-        // Report statistics for planar or outerplanar embedding
-        if (embedFlags == EMBEDFLAGS_PLANAR || embedFlags == EMBEDFLAGS_OUTERPLANAR)
+        if ((outputContainer = sf_NewOutputContainer(NULL, outfileName)) == NULL ||
+            sf_fputs(g6Header, outputContainer) < 0)
         {
-            gp_Message("Num Embedded=%d.", MainStatistic);
+            gp_ErrorMessage("Unable to write random graphs to G6 outfile \"%.*s\".",
+                            FILENAME_MAX, outfileName);
+            Result = NOTOK;
+            goto Label_Cleanup;
+        }
+    }
 
-            for (K = 0; K < 5; K++)
+    // Worker 0 uses the caller's graphs, and the other workers get their own
+    for (int i = 0; i < numThreads; i++)
+    {
+        workers[i].work = *theMerge;
+        workers[i].work.countUpdateFreq = 0;
+        workers[i].work.theG6WriteIterator = NULL;
+        workers[i].work.MainStatistic = 0;
+        memset(workers[i].work.ObstructionMinorFreqs, 0, NUM_MINORS * sizeof(int));
+        workers[i].quietMode = gp_GetQuietMode();
+        workers[i].writeG6 = outfileName != NULL ? TRUE : FALSE;
+
+        if (i > 0)
+        {
+            workers[i].work.theGraph = MakeGraph(SizeOfGraphs, theMerge->command);
+            workers[i].work.origGraph = MakeGraph(SizeOfGraphs, '\0');
+            if (workers[i].work.theGraph == NULL || workers[i].work.origGraph == NULL)
             {
-                // Outerplanarity does not produces minors C and D
-                if (embedFlags == EMBEDFLAGS_OUTERPLANAR && (K == 2 || K == 3))
-                    continue;
+                gp_ErrorMessage("Unable to allocate and initialize graph "
+                                "datastructures for worker threads.");
+                Result = NOTOK;
+                goto Label_Cleanup;
+            }
+        }
+    }
 
-                gp_Message("Minor %c = %d", K + 'A', ObstructionMinorFreqs[K]);
+    theMerge->Result = OK;
+    theMerge->K = 0;
+
+    for (roundStart = 0; roundStart < NumGraphs && Result == OK; roundStart += numStarted)
+    {
+        // Give each worker a contiguous run of graphs
+        numStarted = numWorkers = 0;
+        for (int i = 0; i < numThreads && roundStart + numStarted < NumGraphs; i++, numWorkers++)
+        {
+            workers[i].work.firstK = roundStart + numStarted;
+            workers[i].work.endK = workers[i].work.firstK + graphsPerRound;
+            if (workers[i].work.endK > NumGraphs)
+                workers[i].work.endK = NumGraphs;
+
+            numStarted += workers[i].work.endK - workers[i].work.firstK;
+
+            // If a thread cannot be started, then its graphs are processed on this thread
+            threadStarted[i] = FALSE;
+            if (platform_CreateThread(threads[i], randomGraphsWorker, &workers[i]) == OK)
+                threadStarted[i] = TRUE;
+            else
+                randomGraphsWorker(&workers[i]);
+        }
+
+        for (int i = 0; i < numWorkers; i++)
+        {
+            if (threadStarted[i])
+                platform_JoinThread(threads[i]);
+        }
+
+        // Merge the results in graph number order, stopping at the first error
+        for (int i = 0; i < numWorkers; i++)
+        {
+            theMerge->MainStatistic += workers[i].work.MainStatistic;
+            for (int m = 0; m < NUM_MINORS; m++)
+                theMerge->ObstructionMinorFreqs[m] += workers[i].work.ObstructionMinorFreqs[m];
+
+            AddEmbedPrefilterStats(&theMerge->prefilterStats, &workers[i].work.prefilterStats);
+
+            workers[i].work.MainStatistic = 0;
+            memset(workers[i].work.ObstructionMinorFreqs, 0, NUM_MINORS * sizeof(int));
+            memset(&workers[i].work.prefilterStats, 0, sizeof(embedPrefilterStatsStruct));
+
+            theMerge->Result = workers[i].work.Result;
+            theMerge->K = workers[i].work.K;
+
+            if (workers[i].work.Result != OK && workers[i].work.Result != NONEMBEDDABLE)
+            {
+                if (gp_CopyGraph(theMerge->origGraph, workers[i].work.origGraph) != OK)
+                    gp_ErrorMessage("Unable to copy graph number %d on which "
+                                    "the error occurred.",
+                                    theMerge->K);
+                Result = NOTOK;
+                break;
             }
 
-            if (!(embedFlags & ~EMBEDFLAGS_PLANAR))
+            if (outputContainer != NULL)
             {
-                gp_Message("\nNote: E1 are added to C, E2 are added to A, and "
-                           "E=E3+E4+K5 homeomorphs.\n");
+                char *g6Str = workers[i].g6OutputStr;
 
-                for (K = 5; K < NUM_MINORS; K++)
+                if (g6Str == NULL)
+                    Result = NOTOK;
+                else
                 {
-                    gp_Message("Minor E%d = %d",
-                               K - 4, ObstructionMinorFreqs[K]);
+                    if (strncmp(g6Str, g6Header, strlen(g6Header)) == 0)
+                        g6Str += strlen(g6Header);
+
+                    if (sf_fputs(g6Str, outputContainer) < 0)
+                        Result = NOTOK;
+                }
+
+                if (Result != OK)
+                {
+                    gp_ErrorMessage("Unable to write graphs numbered from %d "
+                                    "to G6 outfile.",
+                                    workers[i].work.firstK);
+                    theMerge->Result = NOTOK;
+                    theMerge->K = workers[i].work.firstK;
+                    break;
                 }
             }
         }
 
-        // Report statistics for graph drawing
-        else if (embedFlags == EMBEDFLAGS_DRAWPLANAR)
+        for (int i = 0; i < numWorkers; i++)
         {
-            gp_Message("Num Graphs Embedded and Drawn=%d.", MainStatistic);
+            if (workers[i].g6OutputStr != NULL)
+            {
+                free(workers[i].g6OutputStr);
+                workers[i].g6OutputStr = NULL;
+            }
         }
 
-        // Report statistics for subgraph homeomorphism algorithms
-        else if (embedFlags == EMBEDFLAGS_SEARCHFORK23)
+        if (Result == OK && !(gp_GetQuietMode() & QUIETMODE_MESSAGES))
         {
-            gp_Message("Of the generated graphs, %d did not contain a K_{2,3} "
-                       "homeomorph as a subgraph.",
-                       MainStatistic);
-        }
-        else if (embedFlags == EMBEDFLAGS_SEARCHFORK33)
-        {
-            gp_Message("Of the generated graphs, %d did not contain a K_{3,3} "
-                       "homeomorph as a subgraph.",
-                       MainStatistic);
-        }
-        else if (embedFlags == EMBEDFLAGS_SEARCHFORK4)
-        {
-            gp_Message("Of the generated graphs, %d did not contain a K_4 "
-                       "homeomorph as a subgraph.",
-                       MainStatistic);
+            fprintf(stdout, "%d\r", roundStart + numStarted);
+            fflush(stdout);
         }
     }
-    else
+
+Label_Cleanup:
+    if (Result != OK && theMerge->Result == OK)
+        theMerge->Result = NOTOK;
+
+    if (outputContainer != NULL)
     {
-        gp_ErrorMessage("\nError found.");
-        g6_SetOutputErrorFlag(theG6WriteIterator);
-        Result = NOTOK;
-        if (!forceQuiet)
+        if (Result != OK)
+            sf_SetOutputErrorFlag(outputContainer);
+        sf_Free(&outputContainer);
+    }
+
+    if (workers != NULL)
+    {
+        // Worker 0 may have recreated the caller's graph
+        theMerge->theGraph = workers[0].work.theGraph;
+
+        for (int i = 1; i < numThreads; i++)
         {
-            sprintf(theFileName, "error%c%d.txt", FILE_DELIMITER, K % 10);
-            if ((writeResult = gp_Write(origGraph, theFileName, WRITE_ADJLIST)) != OK)
-                gp_ErrorMessage(writeErrorMessage, FILENAME_MAX, theFileName);
+            gp_Free(&workers[i].work.theGraph);
+            gp_Free(&workers[i].work.origGraph);
         }
+        free(workers);
     }
+    if (threads != NULL)
+        free(threads);
+    if (threadStarted != NULL)
+        free(threadStarted);
 
-    FlushConsole(stdout);
+    return Result;
+}
 
-    g6_FreeWriter((&theG6WriteIterator));
+/****************************************************************************
+ randomGraphsWorker()
+ Thread function that runs randomGraphsInRange() on the worker's graphs. If
+ the graphs are being written, then they are written to a .g6 string that is
+ returned in the worker's g6OutputStr.
+ ****************************************************************************/
+platform_ThreadFunction(randomGraphsWorker, arg)
+{
+    randomGraphsThreadP theWorker = (randomGraphsThreadP)arg;
+    G6WriteIteratorP theG6WriteIterator = NULL;
 
-    // Free the graph structures created before the loop
-    gp_Free(&theGraph);
-    gp_Free(&origGraph);
+    // The quiet mode is per-thread, so the worker adopts the main thread's mode
+    gp_SetQuietMode(theWorker->quietMode);
 
-    gp_SetQuietMode(savedQuietModeSetting);
+    theWorker->g6OutputStr = NULL;
+    theWorker->work.theG6WriteIterator = NULL;
 
-    return Result == OK || Result == NONEMBEDDABLE ? OK : NOTOK;
+    if (theWorker->writeG6)
+    {
+        if (g6_NewWriter(&theG6WriteIterator, theWorker->work.theGraph) != OK ||
+            g6_InitWriterWithString(theG6WriteIterator, &theWorker->g6OutputStr) != OK)
+        {
+            gp_ErrorMessage("Unable to initialize G6WriteIterator for graphs "
+                            "numbered from %d.",
+                            theWorker->work.firstK);
+            g6_FreeWriter(&theG6WriteIterator);
+            theWorker->work.K = theWorker->work.firstK;
+            theWorker->work.Result = NOTOK;
+            platform_ThreadFunctionReturn;
+        }
+        theWorker->work.theG6WriteIterator = theG6WriteIterator;
+    }
+
+    randomGraphsInRange(&theWorker->work);
+
+    // Freeing the writer hands over the output string
+    theWorker->work.theG6WriteIterator = NULL;
+    g6_FreeWriter(&theG6WriteIterator);
+
+    platform_ThreadFunctionReturn;
 }
 
+#endif
+
 /****************************************************************************
  GetNumberIfZero()
  Internal function that gets a number if the given *pNum is zero.
@@ -551,14 +961,18 @@ void ResetGraphStorage(graphP *pGraph, int ReuseGraphs, char command)
 
 /****************************************************************************
  Creates a random maximal planar graph, then adds 'extraEdges' edges to it.
+ The random number generation is seeded with *pSeed or, if pSeed is NULL,
+ with the current time.
  ****************************************************************************/
 
-int RandomGraph(char const *const commandString, int extraEdges, int numVertices, char *outfileName, char *outfile2Name)
+int RandomGraph(char const *const commandString, int extraEdges, int numVertices, unsigned long long const *pSeed, char *outfileName, char *outfile2Name)
 {
     int Result = OK;
 
     platform_time start, end;
     graphP theGraph = NULL, origGraph = NULL;
+    unsigned long long seed = 0;
+    randomGeneratorStruct theGenerator;
     int embedFlags = 0;
     char command = '\0', modifier = '\0';
 
@@ -576,6 +990,13 @@ int RandomGraph(char const *const commandString, int extraEdges, int numVertices
         return Result;
     }
 
+    if (embedFlags & EMBEDFLAGS_TESTONLY)
+    {
+        gp_ErrorMessage("The test-only modifier is not supported because this "
+                        "command writes the embedding or obstruction.");
+        return NOTOK;
+    }
+
     if ((Result = GetNumberIfZero(&numVertices, "Enter number of vertices:", 1, 10000000) != OK))
     {
         gp_ErrorMessage("Encountered unrecoverable error when prompting for "
@@ -586,8 +1007,18 @@ int RandomGraph(char const *const commandString, int extraEdges, int numVertices
     if ((theGraph = MakeGraph(numVertices, command)) == NULL)
         return NOTOK;
 
-    // Acceptable downcast of time_t to unsigned int (seeding benefits from the lower bits of now)
-    srand((unsigned int)time(NULL));
+    // Unless a seed was given, seed the random number generation with "now",
+    // and report the seed so that the graph can be regenerated.
+    if (pSeed != NULL)
+        seed = *pSeed;
+    else
+    {
+        seed = (unsigned long long)time(NULL);
+        gp_Message("Random seed = %llu", seed);
+    }
+
+    gp_SeedRandomGenerator(&theGenerator, seed);
+    gp_SetRandomGenerator(theGraph, &theGenerator);
 
     gp_Message("Creating the random graph...");
     platform_GetTime(start);
@@ -57,6 +57,13 @@ int SpecificGraph(
         return NOTOK;
     }
 
+    if (embedFlags & EMBEDFLAGS_TESTONLY)
+    {
+        gp_ErrorMessage("The test-only modifier is not supported because this "
+                        "command writes the embedding or obstruction.");
+        return NOTOK;
+    }
+
     // Get the file name of the graph to test
     if (inputStr == NULL)
     {
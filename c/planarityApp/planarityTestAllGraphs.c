@@ -12,13 +12,92 @@ typedef struct
     int numGraphsTested;
     int numOK;
     int numNONEMBEDDABLE;
+    embedPrefilterStatsStruct prefilterStats;
     int errorFlag;
 } testAllStats;
 
 typedef testAllStats *testAllStatsP;
 
-int testAllGraphs(char command, char modifier, char const *const infileName, testAllStatsP stats);
-int outputTestAllGraphsResults(char command, char modifier, testAllStatsP stats, char const *const infileName, char *outfileName, char **pOutputStr);
+int testAllGraphs(char command, char modifier, char const *const infileName, int firstGraph, int numGraphs, testAllStatsP stats);
+int testAllGraphsInReader(char command, char modifier, int embedFlags,
+                          G6ReadIteratorP theG6ReadIterator, graphP origGraphRead, graphP graphForEmbedding,
+                          int lineNumOffset, int numGraphs, testAllStatsP stats);
+int testGraph(char command, char modifier, int embedFlags,
+              graphP origGraphRead, graphP graphForEmbedding, int lineNum);
+int outputTestAllGraphsResults(char const *const commands, int numCommands, char modifier, testAllStatsP stats,
+                               char const *const infileName, char *outfileName, char **pOutputStr);
+
+int getMultipleCommands(char const *const commandString, char *commands, int *pNumCommands);
+int testAllGraphsMulti(char const *const commands, int numCommands, char const *const infileName,
+                       int firstGraph, int numGraphs, testAllStatsP stats);
+int testGraphMulti(char const *const commands, int numCommands, unsigned const *embedFlagsArray,
+                   graphP origGraphRead, graphP templateGraph, graphP *graphsForEmbedding, int lineNum, int *results);
+
+#ifdef PLATFORM_THREADS_AVAILABLE
+
+typedef struct
+{
+    char command;
+    char modifier;
+    int embedFlags;
+    unsigned quietMode;
+    char *chunkStr;
+    char const *infileName;
+    int lineNumOffset;
+    int numGraphs;
+    int order;
+    graphP graphForEmbedding;
+    testAllStats stats;
+    int Result;
+} testAllGraphsWorkerStruct;
+
+typedef testAllGraphsWorkerStruct *testAllGraphsWorkerP;
+
+int testAllGraphsInParallel(char command, char modifier, char const *const infileName, int numThreads, int firstGraph, int numGraphs, testAllStatsP stats);
+platform_ThreadFunction(testAllGraphsWorker, arg);
+int getGraphRange(char const *const infileName, int firstGraph, int *pNumGraphs);
+
+#ifdef PLATFORM_ATOMICS_AVAILABLE
+
+// The maximum number of graphs in the ring between the reader thread and the
+// thread that tests them, which must be a power of 2, and the maximum total
+// number of vertices of the graphs in the ring, which limits the ring size for
+// graphs of large order (though the ring always has at least 2 graphs)
+#define TESTALLGRAPHS_RING_SIZE 64
+#define TESTALLGRAPHS_RING_VERTICES 65536
+
+// A slot of the ring holds a graph and the status of reading it: OK if the
+// graph was read, NOTOK if reading failed, and TESTALLGRAPHS_RING_END if the
+// end of the input (or of the graphs to read) was reached
+#define TESTALLGRAPHS_RING_END (-2)
+
+typedef struct
+{
+    G6ReadIteratorP theG6ReadIterator;
+    int numGraphs;
+    unsigned quietMode;
+    int ringSize;
+    graphP ringGraphs[TESTALLGRAPHS_RING_SIZE];
+    int ringStatus[TESTALLGRAPHS_RING_SIZE];
+    platform_atomic_int numProduced;
+    platform_atomic_int numConsumed;
+    platform_atomic_int readerDone;
+    platform_atomic_int stopRequested;
+    platform_mutex ringLock;
+    platform_cond notEmpty;
+    platform_cond notFull;
+} g6ReaderRingStruct;
+
+typedef g6ReaderRingStruct *g6ReaderRingP;
+
+int testAllGraphsInPipeline(char command, char modifier, int embedFlags,
+                            G6ReadIteratorP theG6ReadIterator, graphP origGraphRead, graphP graphForEmbedding,
+                            int lineNumOffset, int numGraphs, testAllStatsP stats);
+platform_ThreadFunction(g6ReaderThread, arg);
+
+#endif
+
+#endif
 
 // #define TESTALLGRAPHS_MEMORY_TIMING_TEST
 
@@ -26,86 +105,138 @@ int outputTestAllGraphsResults(char command, char modifier, testAllStatsP stats,
 int testAllGraphsN8(char command, char modifier, char const *const infileName, testAllStatsP stats);
 #endif
 
+// #define G6READ_TIMING_TEST
+
+#ifdef G6READ_TIMING_TEST
+int g6ReadTiming(char const *const infileName, testAllStatsP stats);
+#endif
+
 /****************************************************************************
  TestAllGraphs()
  commandString - command to run; e.g.`-(pdo234)` (plus optional modifier
-    character) to perform the corresponding algorithm on each graph in .g6 file
+    character) to perform the corresponding algorithm on each graph in .g6 file,
+    or two or more of the algorithm commands, e.g. `-pdo234`, to perform each
+    of them on each graph in one pass over the .g6 file (see testAllGraphsMulti())
  infileName - non-NULL and nonempty string containing name of .g6 input file
+ numThreads - number of worker threads among which the graphs of the input
+    file are divided; 1 (or less) for single-threaded processing, which is
+    the only processing for multiple commands, so more than 1 is an error
+    when multiple commands are given
+ firstGraph - zero-based number of the first graph to test, i.e. the number
+    of graphs (lines) at the start of the input file to skip
+ numGraphs - number of graphs to test starting with firstGraph, or 0 to test
+    all of the graphs from firstGraph to the end of the input file
  outfileName - name of primary output file, or NULL
  pOutputStr - pointer to string which we wish to use to store the result of
     applying the chosen graph algorithm extension to all graphs in the .g6 file
  ****************************************************************************/
-int TestAllGraphs(char const *const commandString, char const *const infileName, char *outfileName, char **pOutputStr)
+int TestAllGraphs(char const *const commandString, char const *const infileName, int numThreads, int firstGraph, int numGraphs, char *outfileName, char **pOutputStr)
 {
     int Result = OK;
 
-    char command = '\0', modifier = '\0';
+    char commands[sizeof(GRAPHALGORITHMCHOICES)];
+    char modifier = '\0';
+    int numCommands = 0;
     platform_time start, end;
-    testAllStats stats;
+    testAllStats stats[sizeof(GRAPHALGORITHMCHOICES)];
 
-    memset(&stats, 0, sizeof(testAllStats));
+    memset(stats, 0, sizeof(stats));
 
-    if (GetCommandAndOptionalModifier(commandString, &command, &modifier) != OK)
+    if (getMultipleCommands(commandString, commands, &numCommands) != OK &&
+        GetCommandAndOptionalModifier(commandString, &commands[0], &modifier) != OK)
     {
         gp_ErrorMessage("Unable to determine command (and optional modifier) from "
                         "command string.\n");
         return NOTOK;
     }
 
+    if (numCommands == 0)
+        numCommands = 1;
+    else if (numThreads > 1)
+    {
+        gp_ErrorMessage("Multiple algorithm commands cannot be divided among threads; "
+                        "omit -j or give one command.\n");
+        return NOTOK;
+    }
+
     if (infileName == NULL)
     {
         gp_ErrorMessage("No input file provided.");
         return NOTOK;
     }
 
-    gp_Message("Starting to test all graphs in \"%.*s\" for command=\"%s\".",
-               FILENAME_MAX, infileName, commandString);
+    if (firstGraph < 0 || numGraphs < 0)
+    {
+        gp_ErrorMessage("Invalid range of graphs to test.");
+        return NOTOK;
+    }
+
+    if (firstGraph == 0 && numGraphs == 0)
+        gp_Message("Starting to test all graphs in \"%.*s\" for command=\"%s\".",
+                   FILENAME_MAX, infileName, commandString);
+    else if (numGraphs == 0)
+        gp_Message("Starting to test graphs from graph %d to the end of \"%.*s\" for command=\"%s\".",
+                   firstGraph, FILENAME_MAX, infileName, commandString);
+    else
+        gp_Message("Starting to test %d graphs from graph %d of \"%.*s\" for command=\"%s\".",
+                   numGraphs, firstGraph, FILENAME_MAX, infileName, commandString);
 
     // Start the timer
     platform_GetTime(start);
 
-#ifndef TESTALLGRAPHS_MEMORY_TIMING_TEST
-    Result = testAllGraphs(command, modifier, infileName, &stats);
+#if defined(G6READ_TIMING_TEST)
+    Result = g6ReadTiming(infileName, &stats[0]);
+#elif !defined(TESTALLGRAPHS_MEMORY_TIMING_TEST)
+    if (numCommands > 1)
+        Result = testAllGraphsMulti(commands, numCommands, infileName, firstGraph, numGraphs, stats);
+#ifdef PLATFORM_THREADS_AVAILABLE
+    // The parallel method needs the whole input up front, so the stdin stream
+    // is always processed by the single-threaded method
+    else if (numThreads > 1 && strcmp(infileName, "stdin") != 0)
+        Result = testAllGraphsInParallel(commands[0], modifier, infileName, numThreads, firstGraph, numGraphs, &stats[0]);
+#endif
+    else
+        Result = testAllGraphs(commands[0], modifier, infileName, firstGraph, numGraphs, &stats[0]);
 #else
-    Result = testAllGraphsN8(command, modifier, infileName, &stats);
+    Result = testAllGraphsN8(commands[0], modifier, infileName, &stats[0]);
 #endif
 
     // Stop the timer
     platform_GetTime(end);
-    stats.duration = platform_GetDuration(start, end);
+    stats[0].duration = platform_GetDuration(start, end);
 
     if (Result != OK)
     {
-        gp_ErrorMessage("Encountered error while running command '%c' on all "
+        gp_ErrorMessage("Encountered error while running command \"%s\" on all "
                         "graphs in \"%.*s\".",
-                        command, FILENAME_MAX, infileName);
+                        commandString, FILENAME_MAX, infileName);
         Result = NOTOK;
     }
     else
     {
-        gp_Message("Done testing all graphs (%.3lf seconds).", stats.duration);
+        gp_Message("Done testing all graphs (%.3lf seconds).", stats[0].duration);
+        WriteEmbedPrefilterStats(&stats[0].prefilterStats);
     }
 
-    if (outputTestAllGraphsResults(command, modifier, &stats, infileName, outfileName, pOutputStr) != OK)
+    if (outputTestAllGraphsResults(commands, numCommands, modifier, stats, infileName, outfileName, pOutputStr) != OK)
     {
-        gp_ErrorMessage("Error outputting results running command '%c' on all "
+        gp_ErrorMessage("Error outputting results running command \"%s\" on all "
                         "graphs in \"%.*s\".\n",
-                        command, FILENAME_MAX, infileName);
+                        commandString, FILENAME_MAX, infileName);
         Result = NOTOK;
     }
 
     return Result;
 }
 
-int testAllGraphs(char command, char modifier, char const *const infileName, testAllStatsP stats)
+int testAllGraphs(char command, char modifier, char const *const infileName, int firstGraph, int numGraphs, testAllStatsP stats)
 {
     int Result = OK;
 
     graphP origGraphRead = NULL;
     graphP graphForEmbedding = NULL;
-    int embedFlags = 0, numOK = 0, numNONEMBEDDABLE = 0;
+    int embedFlags = 0;
     int order = 0;
-    int lineNum = 0;
 
     G6ReadIteratorP theG6ReadIterator = NULL;
 
@@ -123,8 +254,12 @@ int testAllGraphs(char command, char modifier, char const *const infileName, tes
         return NOTOK;
     }
 
+    // Files are mapped into memory to read them quickly, but the stdin stream
+    // can only be read with the string-or-file container
     if (g6_NewReader((&theG6ReadIterator), origGraphRead) != OK ||
-        g6_InitReaderWithFileName(theG6ReadIterator, infileName) != OK)
+        (strcmp(infileName, "stdin") == 0
+             ? g6_InitReaderWithFileName(theG6ReadIterator, infileName)
+             : g6_InitReaderWithMappedFile(theG6ReadIterator, infileName)) != OK)
     {
         gp_ErrorMessage("Unable to allocate or initialize G6 read iterator.");
         gp_Free(&origGraphRead);
@@ -134,7 +269,7 @@ int testAllGraphs(char command, char modifier, char const *const infileName, tes
     }
 
     // The order of the graphs in the G6 source file or string was determined by
-    // g6_InitReaderWithFileName() and we obtain it to initialize the graph for
+    // the reader initialization, and we obtain it to initialize the graph for
     // embedding
     order = gp_GetN(origGraphRead);
 
@@ -159,11 +294,122 @@ int testAllGraphs(char command, char modifier, char const *const infileName, tes
         return NOTOK;
     }
 
-    while (TRUE)
+    // The reader skips to the first graph of the range directly in a mapped
+    // file. If an index of the file had to be built to do so, and the index
+    // sidecar file is used (-index), then the index is saved so that later
+    // runs on other ranges of the same file need not rebuild it.
+    g6_UseGraphIndexFile(theG6ReadIterator, tolower(G6IndexFileOut) == 'y');
+    if (firstGraph > 0)
+    {
+        if (g6_SeekToGraph(theG6ReadIterator, firstGraph) != OK)
+        {
+            gp_ErrorMessage("Unable to seek to graph %d.", firstGraph);
+            g6_FreeReader(&theG6ReadIterator);
+            gp_Free(&origGraphRead);
+            gp_Free(&graphForEmbedding);
+            stats->errorFlag = TRUE;
+            return NOTOK;
+        }
+
+        g6_WriteGraphIndexFile(theG6ReadIterator);
+    }
+
+#if defined(PLATFORM_THREADS_AVAILABLE) && defined(PLATFORM_ATOMICS_AVAILABLE)
+    Result = testAllGraphsInPipeline(command, modifier, embedFlags,
+                                     theG6ReadIterator, origGraphRead, graphForEmbedding,
+                                     firstGraph, numGraphs, stats);
+#else
+    Result = testAllGraphsInReader(command, modifier, embedFlags,
+                                   theG6ReadIterator, origGraphRead, graphForEmbedding,
+                                   firstGraph, numGraphs, stats);
+#endif
+
+    g6_FreeReader((&theG6ReadIterator));
+    gp_Free(&origGraphRead);
+    gp_Free(&graphForEmbedding);
+
+    return Result;
+}
+
+/****************************************************************************
+ testGraph()
+ Copies origGraphRead, which was read from the given line of the .g6 input,
+ into graphForEmbedding and runs the algorithm indicated by the embedFlags on
+ the copy, then checks the integrity of the result against origGraphRead.
+ Returns OK or NONEMBEDDABLE for the result, or NOTOK on error.
+ ****************************************************************************/
+int testGraph(char command, char modifier, int embedFlags,
+              graphP origGraphRead, graphP graphForEmbedding, int lineNum)
+{
+    int Result = OK;
+
+    if (gp_CopyGraphInUse(graphForEmbedding, origGraphRead) != OK)
+    {
+        gp_ErrorMessage("Unable to copy graph.");
+        return NOTOK;
+    }
+
+    Result = gp_Embed(graphForEmbedding, embedFlags);
+    if (Result != OK && Result != NONEMBEDDABLE)
+    {
+        gp_ErrorMessage("Failed to embed graph on line %d for command '%c'.",
+                        lineNum, command);
+        Result = NOTOK;
+    }
+
+    if (gp_TestEmbedResultIntegrity(graphForEmbedding, origGraphRead, Result) != Result)
+    {
+        gp_ErrorMessage("Embed integrity check failed for graph on line %d "
+                        "for command '%c'.\n",
+                        lineNum, command);
+        Result = NOTOK;
+    }
+
+    if (Result != OK && Result != NONEMBEDDABLE)
+    {
+        if (modifier == '\0')
+        {
+            gp_ErrorMessage("Command '%c' error on graph on line %d.",
+                            command, lineNum);
+        }
+        else
+        {
+            gp_ErrorMessage("Command '%c%c' error on graph on line %d.",
+                            command, modifier, lineNum);
+        }
+        Result = NOTOK;
+    }
+
+    return Result;
+}
+
+/****************************************************************************
+ testAllGraphsInReader()
+ Reads each graph from the given read iterator into origGraphRead, then
+ copies it into graphForEmbedding and runs the algorithm indicated by the
+ embedFlags on the copy.
+ lineNumOffset - number of lines of the .g6 input that precede the first
+    graph in the read iterator, which is nonzero when the input has been
+    divided among worker threads, so that messages report the input line
+ numGraphs - maximum number of graphs to read, or 0 to read to the end
+ The stats are only updated with the counts of graphs tested, OK and
+ NONEMBEDDABLE; the caller is responsible for the duration.
+ ****************************************************************************/
+int testAllGraphsInReader(char command, char modifier, int embedFlags,
+                          G6ReadIteratorP theG6ReadIterator, graphP origGraphRead, graphP graphForEmbedding,
+                          int lineNumOffset, int numGraphs, testAllStatsP stats)
+{
+    int Result = OK;
+    int numOK = 0, numNONEMBEDDABLE = 0;
+    int lineNum = 0;
+
+    gp_ClearEmbedPrefilterStats();
+
+    while (numGraphs == 0 || lineNum < numGraphs)
     {
         if (g6_ReadGraph(theG6ReadIterator) != OK)
         {
-            gp_ErrorMessage("Unable to read graph on line %d.", lineNum + 1);
+            gp_ErrorMessage("Unable to read graph on line %d.", lineNumOffset + lineNum + 1);
             Result = NOTOK;
             break;
         }
@@ -173,27 +419,628 @@ int testAllGraphs(char command, char modifier, char const *const infileName, tes
 
         lineNum++;
 
-        if (gp_CopyGraph(graphForEmbedding, origGraphRead) != OK)
+        Result = testGraph(command, modifier, embedFlags, origGraphRead, graphForEmbedding,
+                           lineNumOffset + lineNum);
+
+        if (Result == OK)
+            numOK++;
+        else if (Result == NONEMBEDDABLE)
         {
-            gp_ErrorMessage("Unable to copy graph.");
+            numNONEMBEDDABLE++;
+            // Now that we've processed the NONEMBEDDABLE result, we set the
+            // Result to OK so that we exit the loop with an OK or NOTOK only
+            Result = OK;
+        }
+        else
+            break;
+    }
+
+    // Since we increment lineNum at the beginning of the loop, if an error
+    // occurs during processing a graph on the current lineNum, or if we reach
+    // the end of the input, then the number of graphs successfully tested is
+    // lineNum - 1.
+    stats->numGraphsTested = lineNum;
+    stats->numOK = numOK;
+    stats->numNONEMBEDDABLE = numNONEMBEDDABLE;
+    gp_GetEmbedPrefilterStats(&stats->prefilterStats);
+    stats->errorFlag = (Result == OK) ? FALSE : TRUE;
+
+    return Result;
+}
+
+/****************************************************************************
+ getMultipleCommands()
+ If the commandString (with or without a leading '-') consists of two or more
+ distinct algorithm commands from GRAPHALGORITHMCHOICES, e.g. `-pdo234`, then
+ the commands are stored in order in the commands array, which must have room
+ for all of the algorithm commands, and their number is stored in
+ *pNumCommands.
+ Returns OK if the commandString has multiple commands, or NOTOK otherwise,
+ without reporting an error, since it may instead be a single command with
+ an optional modifier.
+ ****************************************************************************/
+int getMultipleCommands(char const *const commandString, char *commands, int *pNumCommands)
+{
+    char const *theCommands = commandString;
+    int numCommands = 0;
+
+    if (theCommands != NULL && theCommands[0] == '-')
+        theCommands++;
+
+    if (theCommands == NULL || strlen(theCommands) < 2 ||
+        strlen(theCommands) > strlen(GRAPHALGORITHMCHOICES))
+        return NOTOK;
+
+    for (; *theCommands != '\0'; theCommands++)
+    {
+        char command = (char)tolower(*theCommands);
+
+        if (strchr(GRAPHALGORITHMCHOICES, command) == NULL ||
+            memchr(commands, command, numCommands) != NULL)
+            return NOTOK;
+
+        commands[numCommands++] = command;
+    }
+
+    *pNumCommands = numCommands;
+    return OK;
+}
+
+/****************************************************************************
+ testAllGraphsMulti()
+ Runs each of the numCommands algorithm commands on each graph of the .g6
+ input file (or of the range given by firstGraph and numGraphs), so that the
+ input is read and decoded only once for all of the commands. Each graph read
+ is copied into a template graph on which gp_EmbedMulti() performs the
+ depth-first search shared by the algorithms before copying the template into
+ a graph for embedding that is extended for each command.
+ stats - array of numCommands stats, one per command; the caller is
+    responsible for the duration, which is kept in the first stats
+ ****************************************************************************/
+int testAllGraphsMulti(char const *const commands, int numCommands, char const *const infileName,
+                       int firstGraph, int numGraphs, testAllStatsP stats)
+{
+    int Result = OK;
+
+    graphP origGraphRead = NULL;
+    graphP templateGraph = NULL;
+    graphP graphsForEmbedding[sizeof(GRAPHALGORITHMCHOICES)];
+    unsigned embedFlagsArray[sizeof(GRAPHALGORITHMCHOICES)];
+    int results[sizeof(GRAPHALGORITHMCHOICES)];
+    int embedFlags = 0, order = 0, lineNum = 0;
+
+    G6ReadIteratorP theG6ReadIterator = NULL;
+
+    memset(graphsForEmbedding, 0, sizeof(graphsForEmbedding));
+
+    for (int i = 0; i < numCommands; i++)
+    {
+        if (GetEmbedFlags(commands[i], '\0', &embedFlags) != OK)
+        {
+            gp_ErrorMessage("Invalid command.");
+            stats[0].errorFlag = TRUE;
+            return NOTOK;
+        }
+
+        embedFlagsArray[i] = (unsigned)embedFlags;
+    }
+
+    if ((origGraphRead = gp_New()) == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate graph for reading.");
+        stats[0].errorFlag = TRUE;
+        return NOTOK;
+    }
+
+    if (g6_NewReader((&theG6ReadIterator), origGraphRead) != OK ||
+        (strcmp(infileName, "stdin") == 0
+             ? g6_InitReaderWithFileName(theG6ReadIterator, infileName)
+             : g6_InitReaderWithMappedFile(theG6ReadIterator, infileName)) != OK)
+    {
+        gp_ErrorMessage("Unable to allocate or initialize G6 read iterator.");
+        Result = NOTOK;
+        goto Label_Cleanup;
+    }
+
+    g6_UseGraphIndexFile(theG6ReadIterator, tolower(G6IndexFileOut) == 'y');
+    order = gp_GetN(origGraphRead);
+
+    if ((templateGraph = gp_New()) == NULL ||
+        gp_EnsureVertexCapacity(templateGraph, order) != OK)
+    {
+        gp_ErrorMessage("Unable allocate template graph.");
+        Result = NOTOK;
+        goto Label_Cleanup;
+    }
+
+    for (int i = 0; i < numCommands; i++)
+    {
+        if ((graphsForEmbedding[i] = gp_New()) == NULL ||
+            ExtendGraph(graphsForEmbedding[i], commands[i]) != OK ||
+            gp_EnsureVertexCapacity(graphsForEmbedding[i], order) != OK)
+        {
+            gp_ErrorMessage("Unable allocate graph for embedding.");
+            Result = NOTOK;
+            goto Label_Cleanup;
+        }
+    }
+
+    if (firstGraph > 0)
+    {
+        if (g6_SeekToGraph(theG6ReadIterator, firstGraph) != OK)
+        {
+            gp_ErrorMessage("Unable to seek to graph %d.", firstGraph);
+            Result = NOTOK;
+            goto Label_Cleanup;
+        }
+
+        g6_WriteGraphIndexFile(theG6ReadIterator);
+    }
+
+    while (numGraphs == 0 || lineNum < numGraphs)
+    {
+        if (g6_ReadGraph(theG6ReadIterator) != OK)
+        {
+            gp_ErrorMessage("Unable to read graph on line %d.", firstGraph + lineNum + 1);
             Result = NOTOK;
             break;
         }
 
-        Result = gp_Embed(graphForEmbedding, embedFlags);
-        if (Result != OK && Result != NONEMBEDDABLE)
+        if (g6_EndReached(theG6ReadIterator))
+            break;
+
+        lineNum++;
+
+        if (testGraphMulti(commands, numCommands, embedFlagsArray, origGraphRead, templateGraph,
+                           graphsForEmbedding, firstGraph + lineNum, results) != OK)
         {
-            gp_ErrorMessage("Failed to embed graph on line %d for command '%c'.",
-                            lineNum, command);
             Result = NOTOK;
+            break;
+        }
+
+        for (int i = 0; i < numCommands; i++)
+        {
+            if (results[i] == OK)
+                stats[i].numOK++;
+            else
+                stats[i].numNONEMBEDDABLE++;
+        }
+    }
+
+Label_Cleanup:
+    for (int i = 0; i < numCommands; i++)
+    {
+        stats[i].numGraphsTested = lineNum;
+        stats[i].errorFlag = (Result == OK) ? FALSE : TRUE;
+        gp_Free(&graphsForEmbedding[i]);
+    }
+
+    g6_FreeReader((&theG6ReadIterator));
+    gp_Free(&origGraphRead);
+    gp_Free(&templateGraph);
+
+    return Result;
+}
+
+/****************************************************************************
+ testGraphMulti()
+ Copies origGraphRead, which was read from the given line of the .g6 input,
+ into the templateGraph and runs the algorithms indicated by the embedFlags
+ on it with gp_EmbedMulti(), then checks the integrity of the result in each
+ of the graphsForEmbedding against origGraphRead.
+ Returns OK if the results of all of the commands were obtained, in which
+ case each of the results is OK or NONEMBEDDABLE, or NOTOK on error.
+ ****************************************************************************/
+int testGraphMulti(char const *const commands, int numCommands, unsigned const *embedFlagsArray,
+                   graphP origGraphRead, graphP templateGraph, graphP *graphsForEmbedding, int lineNum, int *results)
+{
+    if (gp_CopyGraphInUse(templateGraph, origGraphRead) != OK)
+    {
+        gp_ErrorMessage("Unable to copy graph.");
+        return NOTOK;
+    }
+
+    if (gp_EmbedMulti(templateGraph, numCommands, embedFlagsArray, graphsForEmbedding, results) != OK)
+    {
+        for (int i = 0; i < numCommands; i++)
+        {
+            if (results[i] != OK && results[i] != NONEMBEDDABLE)
+            {
+                gp_ErrorMessage("Failed to embed graph on line %d for command '%c'.",
+                                lineNum, commands[i]);
+                break;
+            }
         }
 
-        if (gp_TestEmbedResultIntegrity(graphForEmbedding, origGraphRead, Result) != Result)
+        return NOTOK;
+    }
+
+    for (int i = 0; i < numCommands; i++)
+    {
+        if (gp_TestEmbedResultIntegrity(graphsForEmbedding[i], origGraphRead, results[i]) != results[i])
         {
             gp_ErrorMessage("Embed integrity check failed for graph on line %d "
                             "for command '%c'.\n",
-                            lineNum, command);
+                            lineNum, commands[i]);
+            return NOTOK;
+        }
+    }
+
+    return OK;
+}
+
+#ifdef PLATFORM_THREADS_AVAILABLE
+
+/****************************************************************************
+ testAllGraphsInParallel()
+ Reads the .g6 input file into memory and divides it into at most numThreads
+ chunks of whole lines, each of which is itself a valid .g6 string. Each
+ chunk is processed by a worker thread with its own read iterator and its
+ own pair of graphs, and then the per-worker stats are summed in input order.
+
+ If a range of graphs is given by firstGraph and numGraphs, then the range is
+ instead divided evenly among the workers, each of which maps the input file
+ and seeks to the start of its part of the range (see g6_SeekToGraph()).
+
+ The sums reproduce the result of testAllGraphs() exactly: if a worker stops
+ on an error, the stats of the workers for later chunks are not included, as
+ the single-threaded method would not have reached those graphs.
+ ****************************************************************************/
+int testAllGraphsInParallel(char command, char modifier, char const *const infileName, int numThreads, int firstGraph, int numGraphs, testAllStatsP stats)
+{
+    int Result = OK;
+
+    char *inputStr = NULL;
+    size_t inputLen = 0, chunkStart = 0, chunkEnd = 0;
+    int embedFlags = 0, numWorkers = 0, lineNumOffset = 0;
+    int useRange = (firstGraph > 0 || numGraphs > 0);
+    testAllGraphsWorkerP workers = NULL;
+    platform_thread *threads = NULL;
+    int *threadStarted = NULL;
+
+    if (GetEmbedFlags(command, modifier, &embedFlags) != OK)
+    {
+        gp_ErrorMessage("Invalid command or modifier.");
+        stats->errorFlag = TRUE;
+        return NOTOK;
+    }
+
+    if (useRange)
+    {
+        if (getGraphRange(infileName, firstGraph, &numGraphs) != OK)
+        {
+            stats->errorFlag = TRUE;
+            return NOTOK;
+        }
+
+        if (numGraphs < numThreads)
+            numThreads = numGraphs > 0 ? numGraphs : 1;
+    }
+    else
+    {
+        if ((inputStr = ReadTextFileIntoString(infileName)) == NULL)
+        {
+            gp_ErrorMessage("Unable to read \"%.*s\" into memory.", FILENAME_MAX, infileName);
+            stats->errorFlag = TRUE;
+            return NOTOK;
+        }
+
+        // An empty input is left to the single-threaded method to report
+        if ((inputLen = strlen(inputStr)) == 0)
+        {
+            free(inputStr);
+            return testAllGraphs(command, modifier, infileName, 0, 0, stats);
+        }
+    }
+
+    workers = (testAllGraphsWorkerP)calloc(numThreads, sizeof(testAllGraphsWorkerStruct));
+    threads = (platform_thread *)calloc(numThreads, sizeof(platform_thread));
+    threadStarted = (int *)calloc(numThreads, sizeof(int));
+    if (workers == NULL || threads == NULL || threadStarted == NULL)
+    {
+        gp_ErrorMessage("Unable to allocate memory for worker threads.");
+        Result = NOTOK;
+        goto Label_Cleanup;
+    }
+
+    // Divide the remaining input evenly among the remaining workers, moving
+    // each chunk end forward to the end of a line. The newline at the end of
+    // each chunk is overwritten with a null terminator so that every chunk is
+    // a string, and the number of lines in the chunk is counted so the next
+    // worker can report line numbers relative to the whole input.
+    // A range is divided evenly among the workers, each of which reports line
+    // numbers relative to the whole input by starting from its first graph
+    while (useRange && numWorkers < numThreads)
+    {
+        workers[numWorkers].command = command;
+        workers[numWorkers].modifier = modifier;
+        workers[numWorkers].embedFlags = embedFlags;
+        workers[numWorkers].quietMode = gp_GetQuietMode();
+        workers[numWorkers].infileName = infileName;
+        workers[numWorkers].lineNumOffset = firstGraph;
+        workers[numWorkers].numGraphs = numGraphs / (numThreads - numWorkers);
+
+        firstGraph += workers[numWorkers].numGraphs;
+        numGraphs -= workers[numWorkers].numGraphs;
+        numWorkers++;
+    }
+
+    while (!useRange && chunkStart < inputLen && numWorkers < numThreads)
+    {
+        if (numWorkers == numThreads - 1)
+            chunkEnd = inputLen;
+        else
+            chunkEnd = chunkStart + (inputLen - chunkStart) / (numThreads - numWorkers);
+
+        while (chunkEnd < inputLen && inputStr[chunkEnd] != '\n')
+            chunkEnd++;
+
+        workers[numWorkers].command = command;
+        workers[numWorkers].modifier = modifier;
+        workers[numWorkers].embedFlags = embedFlags;
+        workers[numWorkers].quietMode = gp_GetQuietMode();
+        workers[numWorkers].chunkStr = inputStr + chunkStart;
+        workers[numWorkers].lineNumOffset = lineNumOffset;
+
+        for (size_t i = chunkStart; i < chunkEnd; i++)
+            if (inputStr[i] == '\n')
+                lineNumOffset++;
+        lineNumOffset++;
+
+        if (chunkEnd < inputLen)
+            inputStr[chunkEnd] = '\0';
+
+        chunkStart = chunkEnd + 1;
+        numWorkers++;
+    }
+
+    // The embedding graphs are extended before any threads are started, as
+    // attaching an extension may assign its module ID for the first time.
+    for (int i = 0; i < numWorkers; i++)
+    {
+        if ((workers[i].graphForEmbedding = gp_New()) == NULL ||
+            ExtendGraph(workers[i].graphForEmbedding, command) != OK)
+        {
+            gp_ErrorMessage("Unable allocate graph for embedding.");
+            Result = NOTOK;
+            goto Label_Cleanup;
+        }
+    }
+
+    // If a thread cannot be started, then its chunk is processed on this thread
+    for (int i = 0; i < numWorkers; i++)
+    {
+        if (platform_CreateThread(threads[i], testAllGraphsWorker, &workers[i]) == OK)
+            threadStarted[i] = TRUE;
+        else
+            testAllGraphsWorker(&workers[i]);
+    }
+
+    for (int i = 0; i < numWorkers; i++)
+    {
+        if (threadStarted[i])
+            platform_JoinThread(threads[i]);
+    }
+
+    // Merge the worker stats in input order, stopping at the first error
+    for (int i = 0; i < numWorkers; i++)
+    {
+        if (workers[i].Result == OK && workers[i].order != workers[0].order)
+        {
+            gp_ErrorMessage("Order of graph on line %d is incorrect.",
+                            workers[i].lineNumOffset + 1);
+            Result = NOTOK;
+            break;
+        }
+
+        stats->numGraphsTested += workers[i].stats.numGraphsTested;
+        stats->numOK += workers[i].stats.numOK;
+        stats->numNONEMBEDDABLE += workers[i].stats.numNONEMBEDDABLE;
+        AddEmbedPrefilterStats(&stats->prefilterStats, &workers[i].stats.prefilterStats);
+
+        if (workers[i].Result != OK)
+        {
+            Result = NOTOK;
+            break;
+        }
+    }
+
+Label_Cleanup:
+    stats->errorFlag = (Result == OK) ? FALSE : TRUE;
+
+    if (workers != NULL)
+    {
+        for (int i = 0; i < numWorkers; i++)
+            gp_Free(&workers[i].graphForEmbedding);
+        free(workers);
+    }
+    if (threads != NULL)
+        free(threads);
+    if (threadStarted != NULL)
+        free(threadStarted);
+    free(inputStr);
+
+    return Result;
+}
+
+/****************************************************************************
+ testAllGraphsWorker()
+ Thread function that runs testAllGraphsInReader() on one chunk of the .g6
+ input, or on one part of a range of the graphs in the .g6 input file if the
+ worker has no chunkStr. The worker's graphForEmbedding must already be
+ allocated and extended; the worker allocates its own graph and read iterator
+ for reading.
+ ****************************************************************************/
+platform_ThreadFunction(testAllGraphsWorker, arg)
+{
+    testAllGraphsWorkerP theWorker = (testAllGraphsWorkerP)arg;
+    graphP origGraphRead = NULL;
+    G6ReadIteratorP theG6ReadIterator = NULL;
+
+    // The quiet mode is per-thread, so the worker adopts the main thread's mode
+    gp_SetQuietMode(theWorker->quietMode);
+
+    theWorker->Result = NOTOK;
+    theWorker->stats.errorFlag = TRUE;
+
+    if ((origGraphRead = gp_New()) == NULL)
+        gp_ErrorMessage("Unable to allocate graph for reading.");
+
+    else if (g6_NewReader((&theG6ReadIterator), origGraphRead) != OK ||
+             (theWorker->chunkStr != NULL
+                  ? g6_InitReaderWithString(theG6ReadIterator, theWorker->chunkStr)
+                  : g6_InitReaderWithMappedFile(theG6ReadIterator, theWorker->infileName)) != OK)
+        gp_ErrorMessage("Unable to allocate or initialize G6 read iterator "
+                        "for graphs starting on line %d.",
+                        theWorker->lineNumOffset + 1);
+
+    else if (theWorker->chunkStr == NULL &&
+             (g6_UseGraphIndexFile(theG6ReadIterator, tolower(G6IndexFileOut) == 'y') != OK ||
+              g6_SeekToGraph(theG6ReadIterator, theWorker->lineNumOffset) != OK))
+        gp_ErrorMessage("Unable to seek to graph %d.", theWorker->lineNumOffset);
+
+    else if (gp_EnsureVertexCapacity(theWorker->graphForEmbedding,
+                                     (theWorker->order = gp_GetN(origGraphRead))) != OK)
+        gp_ErrorMessage("Unable to expand graph storage for expected number of vertices.");
+
+    else
+        theWorker->Result = testAllGraphsInReader(theWorker->command, theWorker->modifier, theWorker->embedFlags,
+                                                  theG6ReadIterator, origGraphRead, theWorker->graphForEmbedding,
+                                                  theWorker->lineNumOffset, theWorker->numGraphs, &theWorker->stats);
+
+    g6_FreeReader((&theG6ReadIterator));
+    gp_Free(&origGraphRead);
+
+    platform_ThreadFunctionReturn;
+}
+
+#ifdef PLATFORM_ATOMICS_AVAILABLE
+
+/****************************************************************************
+ testAllGraphsInPipeline()
+ Produces the same result as testAllGraphsInReader(), but the graphs are
+ read and decoded by a reader thread while the graphs read before them are
+ tested on this thread, so the file I/O and decoding overlap the embedding.
+
+ The graphs are passed through a ring of up to TESTALLGRAPHS_RING_SIZE
+ graphs, the first of which is origGraphRead and the rest of which are
+ allocated here with the order of the input. The ring has a single producer
+ and a single consumer: the reader thread fills slot k % size only after the
+ count of consumed slots shows that the graph in it has been tested, and this
+ thread tests slot k % size only after the count of produced slots shows that
+ it has been read. The slots are reused without being freed until all graphs
+ are tested.
+
+ The counts are read without a lock while neither thread has to wait. A
+ thread that finds the ring empty (or full) blocks on a condition variable
+ until the other thread has filled (or emptied) half of the ring or has
+ stopped, so that neither thread spins on a CPU, and the threads do not wake
+ each other for every graph. A thread wakes the other only when the ring is
+ at least half full (or at most half full) after its update of the counts.
+
+ If the ring cannot be allocated or the reader thread cannot be started, then
+ the graphs are tested by testAllGraphsInReader().
+ ****************************************************************************/
+int testAllGraphsInPipeline(char command, char modifier, int embedFlags,
+                            G6ReadIteratorP theG6ReadIterator, graphP origGraphRead, graphP graphForEmbedding,
+                            int lineNumOffset, int numGraphs, testAllStatsP stats)
+{
+    int Result = OK;
+    int numOK = 0, numNONEMBEDDABLE = 0;
+    int lineNum = 0, slot = 0;
+    int order = gp_GetN(origGraphRead);
+    g6ReaderRingStruct ring;
+    platform_thread readerThread;
+
+    memset(&ring, 0, sizeof(g6ReaderRingStruct));
+    ring.theG6ReadIterator = theG6ReadIterator;
+    ring.numGraphs = numGraphs;
+    ring.quietMode = gp_GetQuietMode();
+    ring.ringGraphs[0] = origGraphRead;
+
+    ring.ringSize = TESTALLGRAPHS_RING_SIZE;
+    while (ring.ringSize > 2 && ring.ringSize * order > TESTALLGRAPHS_RING_VERTICES)
+        ring.ringSize /= 2;
+
+    for (int i = 1; i < ring.ringSize && Result == OK; i++)
+    {
+        if ((ring.ringGraphs[i] = gp_New()) == NULL ||
+            gp_EnsureVertexCapacity(ring.ringGraphs[i], order) != OK)
+            Result = NOTOK;
+    }
+
+    if (Result == OK)
+    {
+        if (platform_MutexInit(ring.ringLock) != OK)
+            Result = NOTOK;
+        else if (platform_CondInit(ring.notEmpty) != OK)
+        {
+            platform_MutexDestroy(ring.ringLock);
+            Result = NOTOK;
+        }
+        else if (platform_CondInit(ring.notFull) != OK)
+        {
+            platform_CondDestroy(ring.notEmpty);
+            platform_MutexDestroy(ring.ringLock);
+            Result = NOTOK;
+        }
+    }
+
+    if (Result == OK && platform_CreateThread(readerThread, g6ReaderThread, &ring) != OK)
+    {
+        platform_CondDestroy(ring.notFull);
+        platform_CondDestroy(ring.notEmpty);
+        platform_MutexDestroy(ring.ringLock);
+        Result = NOTOK;
+    }
+
+    if (Result != OK)
+    {
+        for (int i = 1; i < ring.ringSize; i++)
+            gp_Free(&ring.ringGraphs[i]);
+
+        return testAllGraphsInReader(command, modifier, embedFlags,
+                                     theG6ReadIterator, origGraphRead, graphForEmbedding,
+                                     lineNumOffset, numGraphs, stats);
+    }
+
+    gp_ClearEmbedPrefilterStats();
+
+    while (TRUE)
+    {
+        slot = lineNum & (ring.ringSize - 1);
+
+        if (platform_AtomicLoad(ring.numProduced) <= lineNum)
+        {
+            platform_MutexLock(ring.ringLock);
+            while (platform_AtomicLoad(ring.numProduced) - lineNum < ring.ringSize / 2 &&
+                   !platform_AtomicLoad(ring.readerDone))
+                platform_CondWait(ring.notEmpty, ring.ringLock);
+            platform_MutexUnlock(ring.ringLock);
+        }
+
+        if (ring.ringStatus[slot] == TESTALLGRAPHS_RING_END)
+            break;
+
+        if (ring.ringStatus[slot] != OK)
+        {
+            gp_ErrorMessage("Unable to read graph on line %d.", lineNumOffset + lineNum + 1);
             Result = NOTOK;
+            break;
+        }
+
+        lineNum++;
+
+        Result = testGraph(command, modifier, embedFlags, ring.ringGraphs[slot], graphForEmbedding,
+                           lineNumOffset + lineNum);
+
+        platform_AtomicStore(ring.numConsumed, lineNum);
+
+        if (platform_AtomicLoad(ring.numProduced) - lineNum <= ring.ringSize / 2)
+        {
+            platform_MutexLock(ring.ringLock);
+            platform_CondSignal(ring.notFull);
+            platform_MutexUnlock(ring.ringLock);
         }
 
         if (Result == OK)
@@ -201,44 +1048,148 @@ int testAllGraphs(char command, char modifier, char const *const infileName, tes
         else if (Result == NONEMBEDDABLE)
         {
             numNONEMBEDDABLE++;
-            // Now that we've processed the NONEMBEDDABLE result, we set the
-            // Result to OK so that we exit the loop with an OK or NOTOK only
             Result = OK;
         }
         else
-        {
-            if (modifier == '\0')
-            {
-                gp_ErrorMessage("Command '%c' error on graph on line %d.",
-                                command, lineNum);
-            }
-            else
-            {
-                gp_ErrorMessage("Command '%c%c' error on graph on line %d.",
-                                command, modifier, lineNum);
-            }
-            Result = NOTOK;
             break;
-        }
     }
 
-    // Since we increment lineNum at the beginning of the loop, if an error
-    // occurs during processing a graph on the current lineNum, or if we reach
-    // the end of the input, then the number of graphs successfully tested is
-    // lineNum - 1.
+    // The reader thread may be waiting for a free slot if testing stopped early
+    platform_MutexLock(ring.ringLock);
+    platform_AtomicStore(ring.stopRequested, TRUE);
+    platform_CondSignal(ring.notFull);
+    platform_MutexUnlock(ring.ringLock);
+    platform_JoinThread(readerThread);
+
+    platform_CondDestroy(ring.notFull);
+    platform_CondDestroy(ring.notEmpty);
+    platform_MutexDestroy(ring.ringLock);
+
+    for (int i = 1; i < ring.ringSize; i++)
+        gp_Free(&ring.ringGraphs[i]);
+
+    // The caller keeps using the reader with origGraphRead
+    g6_SetReaderGraph(theG6ReadIterator, origGraphRead);
+
     stats->numGraphsTested = lineNum;
     stats->numOK = numOK;
     stats->numNONEMBEDDABLE = numNONEMBEDDABLE;
+    gp_GetEmbedPrefilterStats(&stats->prefilterStats);
     stats->errorFlag = (Result == OK) ? FALSE : TRUE;
 
+    return Result;
+}
+
+/****************************************************************************
+ g6ReaderThread()
+ Thread function that reads the graphs for testAllGraphsInPipeline() into
+ the slots of the ring, stopping after the slot that records the end of the
+ input or a read error, or when the consumer requests a stop.
+ ****************************************************************************/
+platform_ThreadFunction(g6ReaderThread, arg)
+{
+    g6ReaderRingP theRing = (g6ReaderRingP)arg;
+    int numRead = 0, slot = 0, status = OK;
+
+    // The quiet mode is per-thread, so the reader adopts the main thread's mode
+    gp_SetQuietMode(theRing->quietMode);
+
+    while (status == OK)
+    {
+        slot = numRead & (theRing->ringSize - 1);
+
+        if (numRead - platform_AtomicLoad(theRing->numConsumed) >= theRing->ringSize)
+        {
+            platform_MutexLock(theRing->ringLock);
+            while (numRead - platform_AtomicLoad(theRing->numConsumed) > theRing->ringSize / 2 &&
+                   !platform_AtomicLoad(theRing->stopRequested))
+                platform_CondWait(theRing->notFull, theRing->ringLock);
+            platform_MutexUnlock(theRing->ringLock);
+
+            if (platform_AtomicLoad(theRing->stopRequested))
+                platform_ThreadFunctionReturn;
+        }
+
+        if (theRing->numGraphs > 0 && numRead == theRing->numGraphs)
+            status = TESTALLGRAPHS_RING_END;
+        else if (g6_SetReaderGraph(theRing->theG6ReadIterator, theRing->ringGraphs[slot]) != OK ||
+                 g6_ReadGraph(theRing->theG6ReadIterator) != OK)
+            status = NOTOK;
+        else if (g6_EndReached(theRing->theG6ReadIterator))
+            status = TESTALLGRAPHS_RING_END;
+
+        theRing->ringStatus[slot] = status;
+        platform_AtomicStore(theRing->numProduced, ++numRead);
+
+        if (status != OK)
+            platform_AtomicStore(theRing->readerDone, TRUE);
+
+        if (status != OK || numRead - platform_AtomicLoad(theRing->numConsumed) >= theRing->ringSize / 2)
+        {
+            platform_MutexLock(theRing->ringLock);
+            platform_CondSignal(theRing->notEmpty);
+            platform_MutexUnlock(theRing->ringLock);
+        }
+    }
+
+    platform_ThreadFunctionReturn;
+}
+
+#endif
+
+/****************************************************************************
+ getGraphRange()
+ Counts the graphs in the .g6 input file to limit *pNumGraphs to the graphs
+ from firstGraph to the end of the file (which is also the meaning of
+ *pNumGraphs being 0), so that a range starting at or beyond the end of the
+ file is empty. If an index of the
+ file had to be built to count the graphs, and the index sidecar file is used
+ (-index), then it is saved so that the workers can seek without each
+ building the index.
+ ****************************************************************************/
+int getGraphRange(char const *const infileName, int firstGraph, int *pNumGraphs)
+{
+    int Result = OK;
+    graphP theGraph = NULL;
+    G6ReadIteratorP theG6ReadIterator = NULL;
+    int numGraphsInFile = 0;
+
+    if ((theGraph = gp_New()) == NULL ||
+        g6_NewReader((&theG6ReadIterator), theGraph) != OK ||
+        g6_InitReaderWithMappedFile(theG6ReadIterator, infileName) != OK ||
+        g6_UseGraphIndexFile(theG6ReadIterator, tolower(G6IndexFileOut) == 'y') != OK ||
+        (numGraphsInFile = g6_GetGraphCount(theG6ReadIterator)) == 0)
+    {
+        gp_ErrorMessage("Unable to count the graphs in \"%.*s\".", FILENAME_MAX, infileName);
+        Result = NOTOK;
+    }
+    else
+    {
+        // A range starting at or beyond the end of the file has no graphs
+        if (firstGraph >= numGraphsInFile)
+            *pNumGraphs = 0;
+        else if (*pNumGraphs == 0 || *pNumGraphs > numGraphsInFile - firstGraph)
+            *pNumGraphs = numGraphsInFile - firstGraph;
+
+        g6_WriteGraphIndexFile(theG6ReadIterator);
+    }
+
     g6_FreeReader((&theG6ReadIterator));
-    gp_Free(&origGraphRead);
-    gp_Free(&graphForEmbedding);
+    gp_Free(&theGraph);
 
     return Result;
 }
 
-int outputTestAllGraphsResults(char command, char modifier, testAllStatsP stats, char const *const infileName, char *outfileName, char **pOutputStr)
+#endif
+
+/****************************************************************************
+ outputTestAllGraphsResults()
+ Writes a header line with the input file name and the duration, which is
+ taken from the first stats, followed by a line with the counts for each of
+ the numCommands commands, to the output file or to a new string.
+ ****************************************************************************/
+int outputTestAllGraphsResults(char const *const commands, int numCommands, char modifier, testAllStatsP stats,
+                               char const *const infileName, char *outfileName, char **pOutputStr)
 {
     int Result = OK;
 
@@ -265,29 +1216,32 @@ int outputTestAllGraphsResults(char command, char modifier, testAllStatsP stats,
         strlen("-1.7976931348623158e+308") + // -DBL_MAX from float.h
         3;
 
-    if (GetNumCharsToReprInt(stats->numGraphsTested, &numCharsToReprNumGraphsTested) != OK ||
-        GetNumCharsToReprInt(stats->numOK, &numCharsToReprNumOK) != OK ||
-        GetNumCharsToReprInt(stats->numNONEMBEDDABLE, &numCharsToReprNumNONEMBEDDABLE) != OK)
+    for (int i = 0; i < numCommands; i++)
     {
-        gp_ErrorMessage("Unable to determine the number of characters required "
-                        "to represent testAllGraphs stat values.");
-        return NOTOK;
-    }
+        if (GetNumCharsToReprInt(stats[i].numGraphsTested, &numCharsToReprNumGraphsTested) != OK ||
+            GetNumCharsToReprInt(stats[i].numOK, &numCharsToReprNumOK) != OK ||
+            GetNumCharsToReprInt(stats[i].numNONEMBEDDABLE, &numCharsToReprNumNONEMBEDDABLE) != OK)
+        {
+            gp_ErrorMessage("Unable to determine the number of characters required "
+                            "to represent testAllGraphs stat values.");
+            return NOTOK;
+        }
 
-    resultStrLen =
-        1 + // - char
-        1 + // command char
-        1 + // optional modifier char
-        1 + // space char
-        numCharsToReprNumGraphsTested +
-        1 + // space char
-        numCharsToReprNumOK +
-        1 + // space char
-        numCharsToReprNumNONEMBEDDABLE +
-        1 + // space char
-        7 + // either ERROR or SUCCESS, so the longer of which is 7 chars
-        3   // (carriage return,) newline and null terminator;
-        ;
+        resultStrLen +=
+            1 + // - char
+            1 + // command char
+            1 + // optional modifier char
+            1 + // space char
+            numCharsToReprNumGraphsTested +
+            1 + // space char
+            numCharsToReprNumOK +
+            1 + // space char
+            numCharsToReprNumNONEMBEDDABLE +
+            1 + // space char
+            7 + // either ERROR or SUCCESS, so the longer of which is 7 chars
+            3   // (carriage return,) newline and null terminator;
+            ;
+    }
 
     theOutputStr = (char *)malloc((headerStrLen + resultStrLen + 1) * sizeof(char));
     if (theOutputStr == NULL)
@@ -298,17 +1252,20 @@ int outputTestAllGraphsResults(char command, char modifier, testAllStatsP stats,
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wformat-nonliteral"
-    sprintf(theOutputStr, headerFormat, infileBasename, stats->duration);
+    sprintf(theOutputStr, headerFormat, infileBasename, stats[0].duration);
 #pragma GCC diagnostic pop
 
-    resultsStr = theOutputStr + strlen(theOutputStr);
+    for (int i = 0; i < numCommands; i++)
+    {
+        resultsStr = theOutputStr + strlen(theOutputStr);
 
-    if (modifier == '\0')
-        sprintf(resultsStr, "-%c %d %d %d %s\n",
-                command, stats->numGraphsTested, stats->numOK, stats->numNONEMBEDDABLE, stats->errorFlag ? "ERROR" : "SUCCESS");
-    else
-        sprintf(resultsStr, "-%c%c %d %d %d %s\n",
-                command, modifier, stats->numGraphsTested, stats->numOK, stats->numNONEMBEDDABLE, stats->errorFlag ? "ERROR" : "SUCCESS");
+        if (modifier == '\0')
+            sprintf(resultsStr, "-%c %d %d %d %s\n",
+                    commands[i], stats[i].numGraphsTested, stats[i].numOK, stats[i].numNONEMBEDDABLE, stats[i].errorFlag ? "ERROR" : "SUCCESS");
+        else
+            sprintf(resultsStr, "-%c%c %d %d %d %s\n",
+                    commands[i], modifier, stats[i].numGraphsTested, stats[i].numOK, stats[i].numNONEMBEDDABLE, stats[i].errorFlag ? "ERROR" : "SUCCESS");
+    }
 
     if (outfileName != NULL)
     {
@@ -340,7 +1297,9 @@ int outputTestAllGraphsResults(char command, char modifier, testAllStatsP stats,
 #ifdef TESTALLGRAPHS_MEMORY_TIMING_TEST
 
 /*******************************************************************************
- * An alternative version of testAllGraphs() that can be used for timing tests
+ * An alternative version of testAllGraphs() that can be used for timing tests,
+ * e.g. to compare a command with its test-only variant (-p versus -pt), for
+ * which the nonplanar graphs skip obstruction isolation
  *******************************************************************************/
 
 #define NUM8VERTEXTGRAPHS 12346
@@ -477,7 +1436,7 @@ int testAllGraphsN8(char command, char modifier, char const *const infileName, t
         numOK = numNONEMBEDDABLE = 0;
         for (lineNum = 1; lineNum <= NUM8VERTEXTGRAPHS; lineNum++)
         {
-            if (gp_CopyGraph(graphForEmbedding, origGraphRead[lineNum]) != OK)
+            if (gp_CopyGraphInUse(graphForEmbedding, origGraphRead[lineNum]) != OK)
             {
                 gp_ErrorMessage("Unable to copy graph.\n");
                 Result = NOTOK;
@@ -528,3 +1487,92 @@ int testAllGraphsN8(char command, char modifier, char const *const infileName, t
 }
 
 #endif
+
+#ifdef G6READ_TIMING_TEST
+
+/*******************************************************************************
+ * A microbenchmark of the .g6 reader, which decodes all graphs of the input
+ * file (e.g. n8.mALL.g6) many times without processing them, so that the time
+ * is dominated by reading, validating and decoding the lines. The reader is
+ * timed when initialized with the file contents as a string, with the file
+ * name, and with the memory-mapped file.
+ *******************************************************************************/
+
+#define G6READ_TIMING_ITERATIONS 200
+
+int g6ReadTiming(char const *const infileName, testAllStatsP stats)
+{
+    int Result = OK;
+    char *inputStr = NULL;
+    graphP theGraph = NULL;
+    G6ReadIteratorP theG6ReadIterator = NULL;
+    int numGraphs = 0, numEdges = 0, initResult = OK;
+    platform_time start, end;
+    char const *modeNames[] = {"string", "file", "mapped file"};
+
+    if ((inputStr = ReadTextFileIntoString(infileName)) == NULL)
+    {
+        gp_ErrorMessage("Unable to read \"%.*s\" into memory.", FILENAME_MAX, infileName);
+        stats->errorFlag = TRUE;
+        return NOTOK;
+    }
+
+    for (int mode = 0; mode < 3 && Result == OK; ++mode)
+    {
+        platform_GetTime(start);
+
+        for (int i = 0; i < G6READ_TIMING_ITERATIONS && Result == OK; ++i)
+        {
+            numGraphs = numEdges = 0;
+
+            if ((theGraph = gp_New()) == NULL ||
+                g6_NewReader(&theG6ReadIterator, theGraph) != OK)
+                initResult = NOTOK;
+            else if (mode == 0)
+                initResult = g6_InitReaderWithString(theG6ReadIterator, inputStr);
+            else if (mode == 1)
+                initResult = g6_InitReaderWithFileName(theG6ReadIterator, infileName);
+            else
+                initResult = g6_InitReaderWithMappedFile(theG6ReadIterator, infileName);
+
+            if (initResult != OK)
+            {
+                gp_ErrorMessage("Unable to allocate or initialize G6 read iterator.");
+                Result = NOTOK;
+            }
+
+            while (Result == OK)
+            {
+                if (g6_ReadGraph(theG6ReadIterator) != OK)
+                {
+                    gp_ErrorMessage("Unable to read graph on line %d.", numGraphs + 1);
+                    Result = NOTOK;
+                }
+                else if (g6_EndReached(theG6ReadIterator))
+                    break;
+                else
+                {
+                    numGraphs++;
+                    numEdges += gp_GetM(theGraph);
+                }
+            }
+
+            g6_FreeReader(&theG6ReadIterator);
+            gp_Free(&theGraph);
+        }
+
+        platform_GetTime(end);
+        gp_Message("Read %d graphs with %d edges from %s %d times in %.3lf seconds.",
+                   numGraphs, numEdges, modeNames[mode], G6READ_TIMING_ITERATIONS,
+                   platform_GetDuration(start, end));
+    }
+
+    free(inputStr);
+
+    stats->numGraphsTested = numGraphs;
+    stats->errorFlag = (Result == OK) ? FALSE : TRUE;
+
+    return Result;
+}
+
+#endif
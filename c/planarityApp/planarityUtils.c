@@ -18,7 +18,8 @@ char Mode = 'r',
      OrigOutFormat = 'a',
      EmbeddableOut = 'n',
      ObstructedOut = 'n',
-     AdjListsForEmbeddingsOut = 'n';
+     AdjListsForEmbeddingsOut = 'n',
+     G6IndexFileOut = 'n';
 
 int Reconfigure(void)
 {
@@ -510,7 +511,11 @@ char const *GetAlgorithmFlags(void)
            "    -o = Outerplanar embedding and obstruction isolation\n"
            "    -2 = Search for subgraph homeomorphic to K_{2,3}\n"
            "    -3 = Search for subgraph homeomorphic to K_{3,3}\n"
-           "    -4 = Search for subgraph homeomorphic to K_4\n";
+           "    -4 = Search for subgraph homeomorphic to K_4\n"
+           "    -pt, -ot = Planarity or outerplanarity test only, with neither\n"
+           "          embedding nor obstruction isolation (for -r and -t)\n"
+           "    -pdo234 = Two or more of the algorithms, run on each graph in one\n"
+           "          pass over the .g6 file with one result line each (for -t)\n";
 }
 
 char const *GetAlgorithmSpecifiers(void)
@@ -632,14 +637,15 @@ int GetEmbedFlags(char command, char modifier, int *embedFlagsP)
         return NOTOK;
     }
 
-    // Future TODO: Currently, there are no graph algorithm extensions for which
-    // we wish to specify a modifier; if an additional character after the
-    // command specifier is given, then error out. In the future, once there are
-    // graph algorithm extensions whose behaviour may be conditioned on a user-
-    // specified modifier character, this check should be removed.
-    if (modifier != '\0')
+    // The only modifier currently supported is 't' (test-only), which decides
+    // planarity or outerplanarity without producing an embedding or isolating
+    // an obstruction. Any other additional character after the command
+    // specifier is an error.
+    if (modifier == 't' && (command == 'p' || command == 'o'))
+        (*embedFlagsP) |= EMBEDFLAGS_TESTONLY;
+    else if (modifier != '\0')
     {
-        gp_ErrorMessage("Algorithm modifiers currently not supported.");
+        gp_ErrorMessage("Algorithm modifier '%c' not supported for command '%c'.", modifier, command);
         return NOTOK;
     }
 
@@ -1052,6 +1058,40 @@ void WriteAlgorithmResults(graphP theGraph, int Result, char command, platform_t
                GetAlgorithmName(command), platform_GetDuration(start, end));
 }
 
+/****************************************************************************
+ * AddEmbedPrefilterStats()
+ *
+ * Adds the prefilter statistics of one thread into a sum for all threads.
+ ****************************************************************************/
+
+void AddEmbedPrefilterStats(embedPrefilterStatsP theSum, embedPrefilterStatsP theStats)
+{
+    theSum->numTested += theStats->numTested;
+    theSum->numEdgeBoundHits += theStats->numEdgeBoundHits;
+    theSum->numFewEdgesHits += theStats->numFewEdgesHits;
+    theSum->numFewBranchHits += theStats->numFewBranchHits;
+}
+
+/****************************************************************************
+ * WriteEmbedPrefilterStats()
+ *
+ * Reports how many of the graphs tested in test-only mode were decided by
+ * each prefilter of gp_Embed(), if any graphs were tested in that mode.
+ ****************************************************************************/
+
+void WriteEmbedPrefilterStats(embedPrefilterStatsP theStats)
+{
+    int numDecided = theStats->numEdgeBoundHits + theStats->numFewEdgesHits + theStats->numFewBranchHits;
+
+    if (theStats->numTested == 0)
+        return;
+
+    gp_Message("Prefilters decided %d of %d graphs (%.1lf%%): edge bound %d, "
+               "too few edges %d, too few branch vertices %d.",
+               numDecided, theStats->numTested, 100.0 * numDecided / theStats->numTested,
+               theStats->numEdgeBoundHits, theStats->numFewEdgesHits, theStats->numFewBranchHits);
+}
+
 /****************************************************************************
  * GetNumCharsToReprInt()
  ****************************************************************************/
@@ -0,0 +1,97 @@
+#ifndef PLATFORM_THREAD
+#define PLATFORM_THREAD
+
+/*
+Copyright (c) 1997-2026, John M. Boyer
+All rights reserved.
+See the LICENSE.TXT file for licensing information.
+*/
+
+// PLATFORM_THREADS_AVAILABLE is defined if worker threads can be created on
+// this platform. Otherwise, the application falls back to single-threaded
+// processing, and the macros below are not defined.
+
+// With threads, a platform_mutex locked by platform_MutexLock() and unlocked by
+// platform_MutexUnlock() guards the state that a platform_cond is waited on
+// for. platform_CondWait() unlocks the mutex while the thread blocks and locks
+// it again before returning, so the state is rechecked in a loop, and a thread
+// that changes the state with the mutex locked calls platform_CondSignal() to
+// wake a waiting thread. The Init macros give OK or NOTOK.
+
+// PLATFORM_ATOMICS_AVAILABLE is additionally defined if an int counter can be
+// shared between two threads without a lock: a platform_atomic_int written by
+// platform_AtomicStore() (with release semantics) on one thread is read by
+// platform_AtomicLoad() (with acquire semantics) on the other, so the writes
+// made before the store are visible after the load. A thread that must wait
+// for such a counter to change blocks on a platform_cond rather than spinning.
+
+#ifdef WINDOWS
+
+#include <windows.h>
+
+#define PLATFORM_THREADS_AVAILABLE
+
+#define platform_thread HANDLE
+#define platform_ThreadFunction(funcName, argName) DWORD WINAPI funcName(LPVOID argName)
+#define platform_ThreadFunctionReturn return 0
+#define platform_CreateThread(threadVar, funcName, arg) \
+    ((threadVar = CreateThread(NULL, 0, funcName, (LPVOID)(arg), 0, NULL)) != NULL ? OK : NOTOK)
+#define platform_JoinThread(threadVar) \
+    (WaitForSingleObject(threadVar, INFINITE), CloseHandle(threadVar))
+
+#define platform_mutex SRWLOCK
+#define platform_MutexInit(mutexVar) (InitializeSRWLock(&(mutexVar)), OK)
+#define platform_MutexLock(mutexVar) AcquireSRWLockExclusive(&(mutexVar))
+#define platform_MutexUnlock(mutexVar) ReleaseSRWLockExclusive(&(mutexVar))
+#define platform_MutexDestroy(mutexVar)
+
+#define platform_cond CONDITION_VARIABLE
+#define platform_CondInit(condVar) (InitializeConditionVariable(&(condVar)), OK)
+#define platform_CondWait(condVar, mutexVar) SleepConditionVariableSRW(&(condVar), &(mutexVar), INFINITE, 0)
+#define platform_CondSignal(condVar) WakeConditionVariable(&(condVar))
+#define platform_CondDestroy(condVar)
+
+#define PLATFORM_ATOMICS_AVAILABLE
+
+#define platform_atomic_int volatile LONG
+#define platform_AtomicLoad(var) InterlockedCompareExchange(&(var), 0, 0)
+#define platform_AtomicStore(var, value) InterlockedExchange(&(var), (LONG)(value))
+
+#elif defined(HAVE_PTHREAD_H)
+
+#include <pthread.h>
+
+#define PLATFORM_THREADS_AVAILABLE
+
+#define platform_thread pthread_t
+#define platform_ThreadFunction(funcName, argName) void *funcName(void *argName)
+#define platform_ThreadFunctionReturn return NULL
+#define platform_CreateThread(threadVar, funcName, arg) \
+    (pthread_create(&(threadVar), NULL, funcName, (void *)(arg)) == 0 ? OK : NOTOK)
+#define platform_JoinThread(threadVar) pthread_join(threadVar, NULL)
+
+#define platform_mutex pthread_mutex_t
+#define platform_MutexInit(mutexVar) (pthread_mutex_init(&(mutexVar), NULL) == 0 ? OK : NOTOK)
+#define platform_MutexLock(mutexVar) pthread_mutex_lock(&(mutexVar))
+#define platform_MutexUnlock(mutexVar) pthread_mutex_unlock(&(mutexVar))
+#define platform_MutexDestroy(mutexVar) pthread_mutex_destroy(&(mutexVar))
+
+#define platform_cond pthread_cond_t
+#define platform_CondInit(condVar) (pthread_cond_init(&(condVar), NULL) == 0 ? OK : NOTOK)
+#define platform_CondWait(condVar, mutexVar) pthread_cond_wait(&(condVar), &(mutexVar))
+#define platform_CondSignal(condVar) pthread_cond_signal(&(condVar))
+#define platform_CondDestroy(condVar) pthread_cond_destroy(&(condVar))
+
+#if defined(__GNUC__) || defined(__clang__)
+
+#define PLATFORM_ATOMICS_AVAILABLE
+
+#define platform_atomic_int int
+#define platform_AtomicLoad(var) __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define platform_AtomicStore(var, value) __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+
+#endif
+
+#endif
+
+#endif